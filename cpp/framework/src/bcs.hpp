@@ -5,15 +5,15 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <span>
 
 #include "binary.hpp"
 #include "serde.hpp"
 
 namespace serde {
 
-// Maximum length supported for BCS sequences and maps.
-constexpr size_t BCS_MAX_LENGTH = (1ull << 31) - 1;
-constexpr size_t BCS_MAX_CONTAINER_DEPTH = 500;
+// The maximum length and depth are defined with the shared codec.
 
 class BcsSerializer : public BinarySerializer<BcsSerializer> {
     using Parent = BinarySerializer<BcsSerializer>;
@@ -23,6 +23,10 @@ class BcsSerializer : public BinarySerializer<BcsSerializer> {
   public:
     BcsSerializer() : Parent(BCS_MAX_CONTAINER_DEPTH) {}
 
+    // Append to the end of bytes, see BcsBuffer for a reusable buffer.
+    BcsSerializer(std::vector<uint8_t> &&bytes)
+        : Parent(std::move(bytes), BCS_MAX_CONTAINER_DEPTH) {}
+
     void serialize_len(size_t value);
     void serialize_variant_index(uint32_t value);
 
@@ -36,7 +40,11 @@ class BcsDeserializer : public BinaryDeserializer<BcsDeserializer> {
     uint32_t deserialize_uleb128_as_u32();
 
   public:
-    BcsDeserializer(std::vector<uint8_t> bytes)
+    // Borrow the input, which must outlive the deserializer.
+    BcsDeserializer(std::span<const uint8_t> bytes)
+        : Parent(bytes, BCS_MAX_CONTAINER_DEPTH) {}
+
+    BcsDeserializer(std::vector<uint8_t> &&bytes)
         : Parent(std::move(bytes), BCS_MAX_CONTAINER_DEPTH) {}
 
     size_t deserialize_len();
@@ -48,18 +56,11 @@ class BcsDeserializer : public BinaryDeserializer<BcsDeserializer> {
 };
 
 inline void BcsSerializer::serialize_u32_as_uleb128(uint32_t value) {
-    while (value >= 0x80) {
-        bytes_.push_back((uint8_t)((value & 0x7F) | 0x80));
-        value = value >> 7;
-    }
-    bytes_.push_back((uint8_t)value);
+    codec::append_uleb128(bytes_, value);
 }
 
 inline void BcsSerializer::serialize_len(size_t value) {
-    if (value > BCS_MAX_LENGTH) {
-        throw serde::serialization_error("Length is too large");
-    }
-    serialize_u32_as_uleb128((uint32_t)value);
+    codec::append_len(bytes_, value);
 }
 
 inline void BcsSerializer::serialize_variant_index(uint32_t value) {
@@ -72,53 +73,82 @@ inline void BcsSerializer::sort_last_entries(std::vector<size_t> offsets) {
     }
     offsets.push_back(bytes_.size());
 
-    std::vector<std::vector<uint8_t>> slices;
-    for (auto i = 1; i < offsets.size(); i++) {
-        auto start = bytes_.cbegin() + offsets[i - 1];
-        auto end = bytes_.cbegin() + offsets[i];
-        slices.emplace_back(start, end);
-    }
-
-    std::sort(slices.begin(), slices.end(), [](auto &s1, auto &s2) {
+    auto slice = [&](size_t i) {
+        return std::span<const uint8_t>(bytes_.data() + offsets[i],
+                                        offsets[i + 1] - offsets[i]);
+    };
+    auto less = [](std::span<const uint8_t> s1, std::span<const uint8_t> s2) {
         return std::lexicographical_compare(s1.begin(), s1.end(), s2.begin(),
                                             s2.end());
-    });
+    };
+
+    // Most of maps are already in order, e.g. the keys are strings or bytes.
+    size_t count = offsets.size() - 1;
+    size_t i = 1;
+    while (i < count && less(slice(i - 1), slice(i))) {
+        i++;
+    }
+    if (i == count) {
+        return;
+    }
 
-    bytes_.resize(offsets[0]);
+    // Copy the entries once to the end of the buffer, then write them back
+    // in order. The buffer keeps the capacity if it is reused.
+    size_t start = offsets.front(), end = offsets.back();
+    bytes_.resize(end + (end - start));
+    std::memcpy(bytes_.data() + end, bytes_.data() + start, end - start);
+
+    std::vector<std::span<const uint8_t>> slices;
+    slices.reserve(count);
+    for (size_t j = 0; j < count; j++) {
+        slices.emplace_back(bytes_.data() + end + (offsets[j] - start),
+                            offsets[j + 1] - offsets[j]);
+    }
+
+    std::sort(slices.begin(), slices.end(), less);
+
+    auto out = bytes_.data() + start;
     for (auto slice : slices) {
-        bytes_.insert(bytes_.end(), slice.begin(), slice.end());
+        std::memcpy(out, slice.data(), slice.size());
+        out += slice.size();
     }
-    assert(offsets.back() == bytes_.size());
+    bytes_.resize(end);
+    assert(out == bytes_.data() + end);
 }
 
-inline uint32_t BcsDeserializer::deserialize_uleb128_as_u32() {
-    uint64_t value = 0;
-    for (int shift = 0; shift < 32; shift += 7) {
-        auto byte = read_byte();
-        auto digit = byte & 0x7F;
-        value |= (uint64_t)digit << shift;
-        if (value > std::numeric_limits<uint32_t>::max()) {
-            throw serde::deserialization_error(
-                "Overflow while parsing uleb128-encoded uint32 value");
-        }
-        if (digit == byte) {
-            if (shift > 0 && digit == 0) {
-                throw serde::deserialization_error(
-                    "Invalid uleb128 number (unexpected zero digit)");
-            }
-            return (uint32_t)value;
-        }
+// A reusable output buffer of BcsSerializer. The capacity is kept between
+// serializations, so serializing in a loop stops allocating once the buffer
+// has grown to the largest value.
+class BcsBuffer {
+    std::vector<uint8_t> bytes_;
+
+  public:
+    BcsBuffer() = default;
+    explicit BcsBuffer(size_t capacity) { bytes_.reserve(capacity); }
+
+    // The returned bytes are valid until the next serialization.
+    template <typename T>
+    std::span<const uint8_t> serialize(const T &value) {
+        bytes_.clear();
+        BcsSerializer serializer(std::move(bytes_));
+        Serializable<T>::serialize(value, serializer);
+        bytes_ = std::move(serializer).bytes();
+        return bytes_;
     }
-    throw serde::deserialization_error(
-        "Overflow while parsing uleb128-encoded uint32 value");
+
+    // The buffer of current thread.
+    static BcsBuffer &local() {
+        thread_local BcsBuffer buffer;
+        return buffer;
+    }
+};
+
+inline uint32_t BcsDeserializer::deserialize_uleb128_as_u32() {
+    return codec::decode_uleb128_u32(bytes_, pos_);
 }
 
 inline size_t BcsDeserializer::deserialize_len() {
-    auto value = deserialize_uleb128_as_u32();
-    if (value > BCS_MAX_LENGTH) {
-        throw serde::deserialization_error("Length is too large");
-    }
-    return (size_t)value;
+    return codec::decode_len(bytes_, pos_);
 }
 
 inline uint32_t BcsDeserializer::deserialize_variant_index() {
@@ -127,10 +157,10 @@ inline uint32_t BcsDeserializer::deserialize_variant_index() {
 
 inline void BcsDeserializer::check_that_key_slices_are_increasing(
     std::tuple<size_t, size_t> key1, std::tuple<size_t, size_t> key2) {
-    if (!std::lexicographical_compare(bytes_.cbegin() + std::get<0>(key1),
-                                      bytes_.cbegin() + std::get<1>(key1),
-                                      bytes_.cbegin() + std::get<0>(key2),
-                                      bytes_.cbegin() + std::get<1>(key2))) {
+    if (!std::lexicographical_compare(bytes_.begin() + std::get<0>(key1),
+                                      bytes_.begin() + std::get<1>(key1),
+                                      bytes_.begin() + std::get<0>(key2),
+                                      bytes_.begin() + std::get<1>(key2))) {
         throw serde::deserialization_error(
             "Error while decoding map: keys are not serialized in the "
             "expected order");
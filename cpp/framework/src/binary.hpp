@@ -5,9 +5,12 @@
 
 #include <algorithm>
 #include <cassert>
+#include <span>
+#include <string_view>
 #include <variant>
 
 #include "serde.hpp"
+#include "codec.hpp"
 
 namespace serde {
 
@@ -21,7 +24,14 @@ class BinarySerializer {
     BinarySerializer(size_t max_container_depth)
         : container_depth_budget_(max_container_depth) {}
 
+    // Append to the end of bytes, e.g. a buffer whose capacity is reused.
+    BinarySerializer(std::vector<uint8_t> &&bytes, size_t max_container_depth)
+        : bytes_(std::move(bytes)),
+          container_depth_budget_(max_container_depth) {}
+
     void serialize_str(const std::string &value);
+    // Append raw bytes, e.g. the content of a std::vector<uint8_t>.
+    void serialize_bytes(std::span<const uint8_t> value);
 
     void serialize_bool(bool value);
     void serialize_unit();
@@ -51,19 +61,34 @@ class BinarySerializer {
 
 template <class D>
 class BinaryDeserializer {
-    size_t pos_;
     size_t container_depth_budget_;
+    // Only used when the deserializer owns the input, bytes_ views it.
+    std::vector<uint8_t> owned_bytes_;
 
   protected:
-    std::vector<uint8_t> bytes_;
+    size_t pos_;
+    std::span<const uint8_t> bytes_;
     uint8_t read_byte();
+    std::span<const uint8_t> read_bytes(size_t len);
 
   public:
-    BinaryDeserializer(std::vector<uint8_t> bytes, size_t max_container_depth)
-        : pos_(0), container_depth_budget_(max_container_depth),
-          bytes_(std::move(bytes)) {}
+    // Borrow the input, which must outlive the deserializer.
+    BinaryDeserializer(std::span<const uint8_t> bytes,
+                       size_t max_container_depth)
+        : container_depth_budget_(max_container_depth), pos_(0),
+          bytes_(bytes) {}
+
+    BinaryDeserializer(std::vector<uint8_t> &&bytes,
+                       size_t max_container_depth)
+        : container_depth_budget_(max_container_depth),
+          owned_bytes_(std::move(bytes)), pos_(0), bytes_(owned_bytes_) {}
+
+    BinaryDeserializer(const BinaryDeserializer &) = delete;
+    BinaryDeserializer &operator=(const BinaryDeserializer &) = delete;
 
     std::string deserialize_str();
+    // Read len raw bytes, e.g. the content of a std::vector<uint8_t>.
+    std::span<const uint8_t> deserialize_bytes(size_t len);
 
     bool deserialize_bool();
     std::monostate deserialize_unit();
@@ -93,9 +118,12 @@ class BinaryDeserializer {
 template <class S>
 void BinarySerializer<S>::serialize_str(const std::string &value) {
     static_cast<S *>(this)->serialize_len(value.size());
-    for (auto c : value) {
-        bytes_.push_back(c);
-    }
+    codec::append(bytes_, value.data(), value.size());
+}
+
+template <class S>
+void BinarySerializer<S>::serialize_bytes(std::span<const uint8_t> value) {
+    codec::append(bytes_, value.data(), value.size());
 }
 
 template <class S>
@@ -128,28 +156,17 @@ void BinarySerializer<S>::serialize_u8(uint8_t value) {
 
 template <class S>
 void BinarySerializer<S>::serialize_u16(uint16_t value) {
-    bytes_.push_back((uint8_t)value);
-    bytes_.push_back((uint8_t)(value >> 8));
+    codec::append_le(bytes_, value);
 }
 
 template <class S>
 void BinarySerializer<S>::serialize_u32(uint32_t value) {
-    bytes_.push_back((uint8_t)value);
-    bytes_.push_back((uint8_t)(value >> 8));
-    bytes_.push_back((uint8_t)(value >> 16));
-    bytes_.push_back((uint8_t)(value >> 24));
+    codec::append_le(bytes_, value);
 }
 
 template <class S>
 void BinarySerializer<S>::serialize_u64(uint64_t value) {
-    bytes_.push_back((uint8_t)value);
-    bytes_.push_back((uint8_t)(value >> 8));
-    bytes_.push_back((uint8_t)(value >> 16));
-    bytes_.push_back((uint8_t)(value >> 24));
-    bytes_.push_back((uint8_t)(value >> 32));
-    bytes_.push_back((uint8_t)(value >> 40));
-    bytes_.push_back((uint8_t)(value >> 48));
-    bytes_.push_back((uint8_t)(value >> 56));
+    codec::append_le(bytes_, value);
 }
 
 template <class S>
@@ -209,15 +226,24 @@ void BinarySerializer<S>::decrease_container_depth() {
 
 template <class D>
 uint8_t BinaryDeserializer<D>::read_byte() {
-    if (pos_ >= bytes_.size()) {
-        throw serde::deserialization_error("Input is not large enough");
-    }
-    return bytes_.at(pos_++);
+    codec::check_available(bytes_, pos_, 1);
+    return bytes_[pos_++];
 }
 
-inline bool is_valid_utf8(const std::string &input) {
+template <class D>
+std::span<const uint8_t> BinaryDeserializer<D>::read_bytes(size_t len) {
+    codec::check_available(bytes_, pos_, len);
+    auto result = bytes_.subspan(pos_, len);
+    pos_ += len;
+    return result;
+}
+
+inline bool is_valid_utf8(std::span<const uint8_t> input) {
+    // Skip the ASCII prefix in blocks, most of strings are identifiers.
+    size_t i = codec::ascii_prefix_length(input.data(), input.size());
+
     uint8_t trailing_digits = 0;
-    for (uint8_t byte : input) {
+    for (uint8_t byte : input.subspan(i)) {
         if (trailing_digits == 0) {
             // Start new codepoint.
             if (byte >> 7 == 0) {
@@ -245,20 +271,28 @@ inline bool is_valid_utf8(const std::string &input) {
     return trailing_digits == 0;
 }
 
+inline bool is_valid_utf8(const std::string &input) {
+    return is_valid_utf8(std::span<const uint8_t>(
+        reinterpret_cast<const uint8_t *>(input.data()), input.size()));
+}
+
 template <class D>
 std::string BinaryDeserializer<D>::deserialize_str() {
     auto len = static_cast<D *>(this)->deserialize_len();
-    std::string result;
-    result.reserve(len);
-    for (size_t i = 0; i < len; i++) {
-        result.push_back(read_byte());
-    }
-    if (!is_valid_utf8(result)) {
+    auto bytes = read_bytes(len);
+    std::string result(reinterpret_cast<const char *>(bytes.data()),
+                       bytes.size());
+    if (!is_valid_utf8(bytes)) {
         throw serde::deserialization_error("Invalid UTF8 string: " + result);
     }
     return result;
 }
 
+template <class D>
+std::span<const uint8_t> BinaryDeserializer<D>::deserialize_bytes(size_t len) {
+    return read_bytes(len);
+}
+
 template <class D>
 std::monostate BinaryDeserializer<D>::deserialize_unit() {
     return {};
@@ -298,34 +332,17 @@ uint8_t BinaryDeserializer<D>::deserialize_u8() {
 
 template <class D>
 uint16_t BinaryDeserializer<D>::deserialize_u16() {
-    uint16_t val = 0;
-    val |= (uint16_t)read_byte();
-    val |= (uint16_t)read_byte() << 8;
-    return val;
+    return codec::load_le<uint16_t>(read_bytes(sizeof(uint16_t)).data());
 }
 
 template <class D>
 uint32_t BinaryDeserializer<D>::deserialize_u32() {
-    uint32_t val = 0;
-    val |= (uint32_t)read_byte();
-    val |= (uint32_t)read_byte() << 8;
-    val |= (uint32_t)read_byte() << 16;
-    val |= (uint32_t)read_byte() << 24;
-    return val;
+    return codec::load_le<uint32_t>(read_bytes(sizeof(uint32_t)).data());
 }
 
 template <class D>
 uint64_t BinaryDeserializer<D>::deserialize_u64() {
-    uint64_t val = 0;
-    val |= (uint64_t)read_byte();
-    val |= (uint64_t)read_byte() << 8;
-    val |= (uint64_t)read_byte() << 16;
-    val |= (uint64_t)read_byte() << 24;
-    val |= (uint64_t)read_byte() << 32;
-    val |= (uint64_t)read_byte() << 40;
-    val |= (uint64_t)read_byte() << 48;
-    val |= (uint64_t)read_byte() << 56;
-    return val;
+    return codec::load_le<uint64_t>(read_bytes(sizeof(uint64_t)).data());
 }
 
 template <class D>
@@ -0,0 +1,176 @@
+#pragma once
+//
+//  The BCS codec kernels shared by serde::BinarySerializer/BcsDeserializer of the generated diem_types
+//  and BcsSerde of the hand-written structs: buffer appending, little endian integers, ULEB128,
+//  bounds checking and the ASCII scan of UTF-8 validation.
+//
+
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "serde.hpp"
+
+namespace serde {
+
+// Maximum length supported for BCS sequences and maps.
+constexpr size_t BCS_MAX_LENGTH = (1ull << 31) - 1;
+constexpr size_t BCS_MAX_CONTAINER_DEPTH = 500;
+
+namespace codec {
+
+inline void append(std::vector<uint8_t> &bytes, const void *data, size_t len) {
+    if (len == 0) {
+        return;
+    }
+    auto size = bytes.size();
+    bytes.resize(size + len);
+    std::memcpy(bytes.data() + size, data, len);
+}
+
+template <std::integral T>
+inline void append_le(std::vector<uint8_t> &bytes, T value) {
+    if constexpr (std::endian::native == std::endian::little) {
+        append(bytes, &value, sizeof(T));
+    } else {
+        for (size_t i = 0; i < sizeof(T); i++) {
+            bytes.push_back((uint8_t)((std::make_unsigned_t<T>)value >> (i * 8)));
+        }
+    }
+}
+
+inline size_t uleb128_size(uint32_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+inline void append_uleb128(std::vector<uint8_t> &bytes, uint32_t value) {
+    // most of lengths and variant indexes are one byte
+    if (value < 0x80) {
+        bytes.push_back((uint8_t)value);
+        return;
+    }
+
+    uint8_t buf[5];
+    size_t len = 0;
+    while (value >= 0x80) {
+        buf[len++] = (uint8_t)((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    buf[len++] = (uint8_t)value;
+
+    append(bytes, buf, len);
+}
+
+inline void append_len(std::vector<uint8_t> &bytes, size_t len) {
+    if (len > BCS_MAX_LENGTH) {
+        throw serialization_error("Length is too large");
+    }
+    append_uleb128(bytes, (uint32_t)len);
+}
+
+inline void check_available(std::span<const uint8_t> input, size_t pos, size_t len) {
+    if (len > input.size() - pos) {
+        throw deserialization_error("Input is not large enough");
+    }
+}
+
+template <std::integral T>
+inline T load_le(const uint8_t *p) {
+    T value;
+    if constexpr (std::endian::native == std::endian::little) {
+        std::memcpy(&value, p, sizeof(T));
+    } else {
+        std::make_unsigned_t<T> v = 0;
+        for (size_t i = 0; i < sizeof(T); i++) {
+            v |= (std::make_unsigned_t<T>)p[i] << (i * 8);
+        }
+        value = (T)v;
+    }
+    return value;
+}
+
+// The length of the leading ASCII bytes, checked in 16 or 8 bytes blocks
+inline size_t ascii_prefix_length(const uint8_t *data, size_t len) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= len; i += 16) {
+        auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        if (_mm_movemask_epi8(block) != 0) {
+            break;
+        }
+    }
+#endif
+    for (; i + 8 <= len; i += 8) {
+        uint64_t block;
+        std::memcpy(&block, data + i, sizeof(block));
+        if (block & 0x8080808080808080ull) {
+            break;
+        }
+    }
+    while (i < len && data[i] < 0x80) {
+        i++;
+    }
+    return i;
+}
+
+// Decode a canonical ULEB128 encoded uint32 at pos with bounds checking
+inline uint32_t decode_uleb128_u32(std::span<const uint8_t> input, size_t &pos) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 32; shift += 7) {
+        check_available(input, pos, 1);
+        auto byte = input[pos++];
+        auto digit = byte & 0x7F;
+        value |= (uint64_t)digit << shift;
+        if (value > std::numeric_limits<uint32_t>::max()) {
+            throw deserialization_error(
+                "Overflow while parsing uleb128-encoded uint32 value");
+        }
+        if (digit == byte) {
+            if (shift > 0 && digit == 0) {
+                throw deserialization_error(
+                    "Invalid uleb128 number (unexpected zero digit)");
+            }
+            return (uint32_t)value;
+        }
+    }
+    throw deserialization_error(
+        "Overflow while parsing uleb128-encoded uint32 value");
+}
+
+// Decode ULEB128 without any check, only for the trusted bytes
+inline uint64_t decode_uleb128_unchecked(const uint8_t *input, size_t &pos) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        auto byte = input[pos++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            break;
+        }
+    }
+    return value;
+}
+
+inline size_t decode_len(std::span<const uint8_t> input, size_t &pos, size_t max_length = BCS_MAX_LENGTH) {
+    auto value = decode_uleb128_u32(input, pos);
+    if (value > max_length) {
+        throw deserialization_error("Length is too large");
+    }
+    return (size_t)value;
+}
+
+} // end of namespace codec
+
+} // end of namespace serde
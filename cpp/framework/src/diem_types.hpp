@@ -10,7 +10,7 @@ namespace diem_types {
 
         friend bool operator==(const CoinTradeMetadataV0&, const CoinTradeMetadataV0&);
         std::vector<uint8_t> bcsSerialize() const;
-        static CoinTradeMetadataV0 bcsDeserialize(std::vector<uint8_t>);
+        static CoinTradeMetadataV0 bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct CoinTradeMetadata {
@@ -20,14 +20,14 @@ namespace diem_types {
 
             friend bool operator==(const CoinTradeMetadataV0&, const CoinTradeMetadataV0&);
             std::vector<uint8_t> bcsSerialize() const;
-            static CoinTradeMetadataV0 bcsDeserialize(std::vector<uint8_t>);
+            static CoinTradeMetadataV0 bcsDeserialize(std::span<const uint8_t>);
         };
 
         std::variant<CoinTradeMetadataV0> value;
 
         friend bool operator==(const CoinTradeMetadata&, const CoinTradeMetadata&);
         std::vector<uint8_t> bcsSerialize() const;
-        static CoinTradeMetadata bcsDeserialize(std::vector<uint8_t>);
+        static CoinTradeMetadata bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct GeneralMetadataV0 {
@@ -37,7 +37,7 @@ namespace diem_types {
 
         friend bool operator==(const GeneralMetadataV0&, const GeneralMetadataV0&);
         std::vector<uint8_t> bcsSerialize() const;
-        static GeneralMetadataV0 bcsDeserialize(std::vector<uint8_t>);
+        static GeneralMetadataV0 bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct GeneralMetadata {
@@ -47,14 +47,14 @@ namespace diem_types {
 
             friend bool operator==(const GeneralMetadataVersion0&, const GeneralMetadataVersion0&);
             std::vector<uint8_t> bcsSerialize() const;
-            static GeneralMetadataVersion0 bcsDeserialize(std::vector<uint8_t>);
+            static GeneralMetadataVersion0 bcsDeserialize(std::span<const uint8_t>);
         };
 
         std::variant<GeneralMetadataVersion0> value;
 
         friend bool operator==(const GeneralMetadata&, const GeneralMetadata&);
         std::vector<uint8_t> bcsSerialize() const;
-        static GeneralMetadata bcsDeserialize(std::vector<uint8_t>);
+        static GeneralMetadata bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct PaymentMetadataV0 {
@@ -62,7 +62,7 @@ namespace diem_types {
 
         friend bool operator==(const PaymentMetadataV0&, const PaymentMetadataV0&);
         std::vector<uint8_t> bcsSerialize() const;
-        static PaymentMetadataV0 bcsDeserialize(std::vector<uint8_t>);
+        static PaymentMetadataV0 bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct PaymentMetadata {
@@ -72,14 +72,14 @@ namespace diem_types {
 
             friend bool operator==(const PaymentMetadataVersion0&, const PaymentMetadataVersion0&);
             std::vector<uint8_t> bcsSerialize() const;
-            static PaymentMetadataVersion0 bcsDeserialize(std::vector<uint8_t>);
+            static PaymentMetadataVersion0 bcsDeserialize(std::span<const uint8_t>);
         };
 
         std::variant<PaymentMetadataVersion0> value;
 
         friend bool operator==(const PaymentMetadata&, const PaymentMetadata&);
         std::vector<uint8_t> bcsSerialize() const;
-        static PaymentMetadata bcsDeserialize(std::vector<uint8_t>);
+        static PaymentMetadata bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct RefundReason {
@@ -87,38 +87,38 @@ namespace diem_types {
         struct OtherReason {
             friend bool operator==(const OtherReason&, const OtherReason&);
             std::vector<uint8_t> bcsSerialize() const;
-            static OtherReason bcsDeserialize(std::vector<uint8_t>);
+            static OtherReason bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct InvalidSubaddress {
             friend bool operator==(const InvalidSubaddress&, const InvalidSubaddress&);
             std::vector<uint8_t> bcsSerialize() const;
-            static InvalidSubaddress bcsDeserialize(std::vector<uint8_t>);
+            static InvalidSubaddress bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct UserInitiatedPartialRefund {
             friend bool operator==(const UserInitiatedPartialRefund&, const UserInitiatedPartialRefund&);
             std::vector<uint8_t> bcsSerialize() const;
-            static UserInitiatedPartialRefund bcsDeserialize(std::vector<uint8_t>);
+            static UserInitiatedPartialRefund bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct UserInitiatedFullRefund {
             friend bool operator==(const UserInitiatedFullRefund&, const UserInitiatedFullRefund&);
             std::vector<uint8_t> bcsSerialize() const;
-            static UserInitiatedFullRefund bcsDeserialize(std::vector<uint8_t>);
+            static UserInitiatedFullRefund bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct InvalidReferenceId {
             friend bool operator==(const InvalidReferenceId&, const InvalidReferenceId&);
             std::vector<uint8_t> bcsSerialize() const;
-            static InvalidReferenceId bcsDeserialize(std::vector<uint8_t>);
+            static InvalidReferenceId bcsDeserialize(std::span<const uint8_t>);
         };
 
         std::variant<OtherReason, InvalidSubaddress, UserInitiatedPartialRefund, UserInitiatedFullRefund, InvalidReferenceId> value;
 
         friend bool operator==(const RefundReason&, const RefundReason&);
         std::vector<uint8_t> bcsSerialize() const;
-        static RefundReason bcsDeserialize(std::vector<uint8_t>);
+        static RefundReason bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct RefundMetadataV0 {
@@ -127,7 +127,7 @@ namespace diem_types {
 
         friend bool operator==(const RefundMetadataV0&, const RefundMetadataV0&);
         std::vector<uint8_t> bcsSerialize() const;
-        static RefundMetadataV0 bcsDeserialize(std::vector<uint8_t>);
+        static RefundMetadataV0 bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct RefundMetadata {
@@ -137,14 +137,14 @@ namespace diem_types {
 
             friend bool operator==(const RefundMetadataV0&, const RefundMetadataV0&);
             std::vector<uint8_t> bcsSerialize() const;
-            static RefundMetadataV0 bcsDeserialize(std::vector<uint8_t>);
+            static RefundMetadataV0 bcsDeserialize(std::span<const uint8_t>);
         };
 
         std::variant<RefundMetadataV0> value;
 
         friend bool operator==(const RefundMetadata&, const RefundMetadata&);
         std::vector<uint8_t> bcsSerialize() const;
-        static RefundMetadata bcsDeserialize(std::vector<uint8_t>);
+        static RefundMetadata bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct TravelRuleMetadataV0 {
@@ -152,7 +152,7 @@ namespace diem_types {
 
         friend bool operator==(const TravelRuleMetadataV0&, const TravelRuleMetadataV0&);
         std::vector<uint8_t> bcsSerialize() const;
-        static TravelRuleMetadataV0 bcsDeserialize(std::vector<uint8_t>);
+        static TravelRuleMetadataV0 bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct TravelRuleMetadata {
@@ -162,14 +162,14 @@ namespace diem_types {
 
             friend bool operator==(const TravelRuleMetadataVersion0&, const TravelRuleMetadataVersion0&);
             std::vector<uint8_t> bcsSerialize() const;
-            static TravelRuleMetadataVersion0 bcsDeserialize(std::vector<uint8_t>);
+            static TravelRuleMetadataVersion0 bcsDeserialize(std::span<const uint8_t>);
         };
 
         std::variant<TravelRuleMetadataVersion0> value;
 
         friend bool operator==(const TravelRuleMetadata&, const TravelRuleMetadata&);
         std::vector<uint8_t> bcsSerialize() const;
-        static TravelRuleMetadata bcsDeserialize(std::vector<uint8_t>);
+        static TravelRuleMetadata bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct UnstructuredBytesMetadata {
@@ -177,7 +177,7 @@ namespace diem_types {
 
         friend bool operator==(const UnstructuredBytesMetadata&, const UnstructuredBytesMetadata&);
         std::vector<uint8_t> bcsSerialize() const;
-        static UnstructuredBytesMetadata bcsDeserialize(std::vector<uint8_t>);
+        static UnstructuredBytesMetadata bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct Metadata {
@@ -185,7 +185,7 @@ namespace diem_types {
         struct Undefined {
             friend bool operator==(const Undefined&, const Undefined&);
             std::vector<uint8_t> bcsSerialize() const;
-            static Undefined bcsDeserialize(std::vector<uint8_t>);
+            static Undefined bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct GeneralMetadata {
@@ -193,7 +193,7 @@ namespace diem_types {
 
             friend bool operator==(const GeneralMetadata&, const GeneralMetadata&);
             std::vector<uint8_t> bcsSerialize() const;
-            static GeneralMetadata bcsDeserialize(std::vector<uint8_t>);
+            static GeneralMetadata bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct TravelRuleMetadata {
@@ -201,7 +201,7 @@ namespace diem_types {
 
             friend bool operator==(const TravelRuleMetadata&, const TravelRuleMetadata&);
             std::vector<uint8_t> bcsSerialize() const;
-            static TravelRuleMetadata bcsDeserialize(std::vector<uint8_t>);
+            static TravelRuleMetadata bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct UnstructuredBytesMetadata {
@@ -209,7 +209,7 @@ namespace diem_types {
 
             friend bool operator==(const UnstructuredBytesMetadata&, const UnstructuredBytesMetadata&);
             std::vector<uint8_t> bcsSerialize() const;
-            static UnstructuredBytesMetadata bcsDeserialize(std::vector<uint8_t>);
+            static UnstructuredBytesMetadata bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct RefundMetadata {
@@ -217,7 +217,7 @@ namespace diem_types {
 
             friend bool operator==(const RefundMetadata&, const RefundMetadata&);
             std::vector<uint8_t> bcsSerialize() const;
-            static RefundMetadata bcsDeserialize(std::vector<uint8_t>);
+            static RefundMetadata bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct CoinTradeMetadata {
@@ -225,7 +225,7 @@ namespace diem_types {
 
             friend bool operator==(const CoinTradeMetadata&, const CoinTradeMetadata&);
             std::vector<uint8_t> bcsSerialize() const;
-            static CoinTradeMetadata bcsDeserialize(std::vector<uint8_t>);
+            static CoinTradeMetadata bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct PaymentMetadata {
@@ -233,14 +233,14 @@ namespace diem_types {
 
             friend bool operator==(const PaymentMetadata&, const PaymentMetadata&);
             std::vector<uint8_t> bcsSerialize() const;
-            static PaymentMetadata bcsDeserialize(std::vector<uint8_t>);
+            static PaymentMetadata bcsDeserialize(std::span<const uint8_t>);
         };
 
         std::variant<Undefined, GeneralMetadata, TravelRuleMetadata, UnstructuredBytesMetadata, RefundMetadata, CoinTradeMetadata, PaymentMetadata> value;
 
         friend bool operator==(const Metadata&, const Metadata&);
         std::vector<uint8_t> bcsSerialize() const;
-        static Metadata bcsDeserialize(std::vector<uint8_t>);
+        static Metadata bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct AccountAddress {
@@ -248,7 +248,7 @@ namespace diem_types {
 
         friend bool operator==(const AccountAddress&, const AccountAddress&);
         std::vector<uint8_t> bcsSerialize() const;
-        static AccountAddress bcsDeserialize(std::vector<uint8_t>);
+        static AccountAddress bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct Ed25519PublicKey {
@@ -256,7 +256,7 @@ namespace diem_types {
 
         friend bool operator==(const Ed25519PublicKey&, const Ed25519PublicKey&);
         std::vector<uint8_t> bcsSerialize() const;
-        static Ed25519PublicKey bcsDeserialize(std::vector<uint8_t>);
+        static Ed25519PublicKey bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct Ed25519Signature {
@@ -264,7 +264,7 @@ namespace diem_types {
 
         friend bool operator==(const Ed25519Signature&, const Ed25519Signature&);
         std::vector<uint8_t> bcsSerialize() const;
-        static Ed25519Signature bcsDeserialize(std::vector<uint8_t>);
+        static Ed25519Signature bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct MultiEd25519PublicKey {
@@ -272,7 +272,7 @@ namespace diem_types {
 
         friend bool operator==(const MultiEd25519PublicKey&, const MultiEd25519PublicKey&);
         std::vector<uint8_t> bcsSerialize() const;
-        static MultiEd25519PublicKey bcsDeserialize(std::vector<uint8_t>);
+        static MultiEd25519PublicKey bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct MultiEd25519Signature {
@@ -280,7 +280,7 @@ namespace diem_types {
 
         friend bool operator==(const MultiEd25519Signature&, const MultiEd25519Signature&);
         std::vector<uint8_t> bcsSerialize() const;
-        static MultiEd25519Signature bcsDeserialize(std::vector<uint8_t>);
+        static MultiEd25519Signature bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct AccountAuthenticator {
@@ -291,7 +291,7 @@ namespace diem_types {
 
             friend bool operator==(const Ed25519&, const Ed25519&);
             std::vector<uint8_t> bcsSerialize() const;
-            static Ed25519 bcsDeserialize(std::vector<uint8_t>);
+            static Ed25519 bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct MultiEd25519 {
@@ -300,14 +300,14 @@ namespace diem_types {
 
             friend bool operator==(const MultiEd25519&, const MultiEd25519&);
             std::vector<uint8_t> bcsSerialize() const;
-            static MultiEd25519 bcsDeserialize(std::vector<uint8_t>);
+            static MultiEd25519 bcsDeserialize(std::span<const uint8_t>);
         };
 
         std::variant<Ed25519, MultiEd25519> value;
 
         friend bool operator==(const AccountAuthenticator&, const AccountAuthenticator&);
         std::vector<uint8_t> bcsSerialize() const;
-        static AccountAuthenticator bcsDeserialize(std::vector<uint8_t>);
+        static AccountAuthenticator bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct TransactionAuthenticator {
@@ -318,7 +318,7 @@ namespace diem_types {
 
             friend bool operator==(const Ed25519&, const Ed25519&);
             std::vector<uint8_t> bcsSerialize() const;
-            static Ed25519 bcsDeserialize(std::vector<uint8_t>);
+            static Ed25519 bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct MultiEd25519 {
@@ -327,7 +327,7 @@ namespace diem_types {
 
             friend bool operator==(const MultiEd25519&, const MultiEd25519&);
             std::vector<uint8_t> bcsSerialize() const;
-            static MultiEd25519 bcsDeserialize(std::vector<uint8_t>);
+            static MultiEd25519 bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct MultiAgent {
@@ -337,14 +337,14 @@ namespace diem_types {
 
             friend bool operator==(const MultiAgent&, const MultiAgent&);
             std::vector<uint8_t> bcsSerialize() const;
-            static MultiAgent bcsDeserialize(std::vector<uint8_t>);
+            static MultiAgent bcsDeserialize(std::span<const uint8_t>);
         };
 
         std::variant<Ed25519, MultiEd25519, MultiAgent> value;
 
         friend bool operator==(const TransactionAuthenticator&, const TransactionAuthenticator&);
         std::vector<uint8_t> bcsSerialize() const;
-        static TransactionAuthenticator bcsDeserialize(std::vector<uint8_t>);
+        static TransactionAuthenticator bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct Module {
@@ -352,7 +352,7 @@ namespace diem_types {
 
         friend bool operator==(const Module&, const Module&);
         std::vector<uint8_t> bcsSerialize() const;
-        static Module bcsDeserialize(std::vector<uint8_t>);
+        static Module bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct TransactionArgument {
@@ -362,7 +362,7 @@ namespace diem_types {
 
             friend bool operator==(const U8&, const U8&);
             std::vector<uint8_t> bcsSerialize() const;
-            static U8 bcsDeserialize(std::vector<uint8_t>);
+            static U8 bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct U64 {
@@ -370,7 +370,7 @@ namespace diem_types {
 
             friend bool operator==(const U64&, const U64&);
             std::vector<uint8_t> bcsSerialize() const;
-            static U64 bcsDeserialize(std::vector<uint8_t>);
+            static U64 bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct U128 {
@@ -378,7 +378,7 @@ namespace diem_types {
 
             friend bool operator==(const U128&, const U128&);
             std::vector<uint8_t> bcsSerialize() const;
-            static U128 bcsDeserialize(std::vector<uint8_t>);
+            static U128 bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct Address {
@@ -386,7 +386,7 @@ namespace diem_types {
 
             friend bool operator==(const Address&, const Address&);
             std::vector<uint8_t> bcsSerialize() const;
-            static Address bcsDeserialize(std::vector<uint8_t>);
+            static Address bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct U8Vector {
@@ -394,7 +394,7 @@ namespace diem_types {
 
             friend bool operator==(const U8Vector&, const U8Vector&);
             std::vector<uint8_t> bcsSerialize() const;
-            static U8Vector bcsDeserialize(std::vector<uint8_t>);
+            static U8Vector bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct Bool {
@@ -402,14 +402,14 @@ namespace diem_types {
 
             friend bool operator==(const Bool&, const Bool&);
             std::vector<uint8_t> bcsSerialize() const;
-            static Bool bcsDeserialize(std::vector<uint8_t>);
+            static Bool bcsDeserialize(std::span<const uint8_t>);
         };
 
         std::variant<U8, U64, U128, Address, U8Vector, Bool> value;
 
         friend bool operator==(const TransactionArgument&, const TransactionArgument&);
         std::vector<uint8_t> bcsSerialize() const;
-        static TransactionArgument bcsDeserialize(std::vector<uint8_t>);
+        static TransactionArgument bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct Identifier {
@@ -417,7 +417,7 @@ namespace diem_types {
 
         friend bool operator==(const Identifier&, const Identifier&);
         std::vector<uint8_t> bcsSerialize() const;
-        static Identifier bcsDeserialize(std::vector<uint8_t>);
+        static Identifier bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct TypeTag;
@@ -430,7 +430,7 @@ namespace diem_types {
 
         friend bool operator==(const StructTag&, const StructTag&);
         std::vector<uint8_t> bcsSerialize() const;
-        static StructTag bcsDeserialize(std::vector<uint8_t>);
+        static StructTag bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct TypeTag {
@@ -438,37 +438,37 @@ namespace diem_types {
         struct Bool {
             friend bool operator==(const Bool&, const Bool&);
             std::vector<uint8_t> bcsSerialize() const;
-            static Bool bcsDeserialize(std::vector<uint8_t>);
+            static Bool bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct U8 {
             friend bool operator==(const U8&, const U8&);
             std::vector<uint8_t> bcsSerialize() const;
-            static U8 bcsDeserialize(std::vector<uint8_t>);
+            static U8 bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct U64 {
             friend bool operator==(const U64&, const U64&);
             std::vector<uint8_t> bcsSerialize() const;
-            static U64 bcsDeserialize(std::vector<uint8_t>);
+            static U64 bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct U128 {
             friend bool operator==(const U128&, const U128&);
             std::vector<uint8_t> bcsSerialize() const;
-            static U128 bcsDeserialize(std::vector<uint8_t>);
+            static U128 bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct Address {
             friend bool operator==(const Address&, const Address&);
             std::vector<uint8_t> bcsSerialize() const;
-            static Address bcsDeserialize(std::vector<uint8_t>);
+            static Address bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct Signer {
             friend bool operator==(const Signer&, const Signer&);
             std::vector<uint8_t> bcsSerialize() const;
-            static Signer bcsDeserialize(std::vector<uint8_t>);
+            static Signer bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct Vector {
@@ -476,7 +476,7 @@ namespace diem_types {
 
             friend bool operator==(const Vector&, const Vector&);
             std::vector<uint8_t> bcsSerialize() const;
-            static Vector bcsDeserialize(std::vector<uint8_t>);
+            static Vector bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct Struct {
@@ -484,14 +484,14 @@ namespace diem_types {
 
             friend bool operator==(const Struct&, const Struct&);
             std::vector<uint8_t> bcsSerialize() const;
-            static Struct bcsDeserialize(std::vector<uint8_t>);
+            static Struct bcsDeserialize(std::span<const uint8_t>);
         };
 
         std::variant<Bool, U8, U64, U128, Address, Signer, Vector, Struct> value;
 
         friend bool operator==(const TypeTag&, const TypeTag&);
         std::vector<uint8_t> bcsSerialize() const;
-        static TypeTag bcsDeserialize(std::vector<uint8_t>);
+        static TypeTag bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct Script {
@@ -501,7 +501,7 @@ namespace diem_types {
 
         friend bool operator==(const Script&, const Script&);
         std::vector<uint8_t> bcsSerialize() const;
-        static Script bcsDeserialize(std::vector<uint8_t>);
+        static Script bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct ModuleId {
@@ -510,7 +510,7 @@ namespace diem_types {
 
         friend bool operator==(const ModuleId&, const ModuleId&);
         std::vector<uint8_t> bcsSerialize() const;
-        static ModuleId bcsDeserialize(std::vector<uint8_t>);
+        static ModuleId bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct ScriptFunction {
@@ -521,7 +521,7 @@ namespace diem_types {
 
         friend bool operator==(const ScriptFunction&, const ScriptFunction&);
         std::vector<uint8_t> bcsSerialize() const;
-        static ScriptFunction bcsDeserialize(std::vector<uint8_t>);
+        static ScriptFunction bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct EventKey {
@@ -529,7 +529,7 @@ namespace diem_types {
 
         friend bool operator==(const EventKey&, const EventKey&);
         std::vector<uint8_t> bcsSerialize() const;
-        static EventKey bcsDeserialize(std::vector<uint8_t>);
+        static EventKey bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct ContractEventV0 {
@@ -540,7 +540,7 @@ namespace diem_types {
 
         friend bool operator==(const ContractEventV0&, const ContractEventV0&);
         std::vector<uint8_t> bcsSerialize() const;
-        static ContractEventV0 bcsDeserialize(std::vector<uint8_t>);
+        static ContractEventV0 bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct ContractEvent {
@@ -550,14 +550,14 @@ namespace diem_types {
 
             friend bool operator==(const V0&, const V0&);
             std::vector<uint8_t> bcsSerialize() const;
-            static V0 bcsDeserialize(std::vector<uint8_t>);
+            static V0 bcsDeserialize(std::span<const uint8_t>);
         };
 
         std::variant<V0> value;
 
         friend bool operator==(const ContractEvent&, const ContractEvent&);
         std::vector<uint8_t> bcsSerialize() const;
-        static ContractEvent bcsDeserialize(std::vector<uint8_t>);
+        static ContractEvent bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct AccessPath {
@@ -566,7 +566,7 @@ namespace diem_types {
 
         friend bool operator==(const AccessPath&, const AccessPath&);
         std::vector<uint8_t> bcsSerialize() const;
-        static AccessPath bcsDeserialize(std::vector<uint8_t>);
+        static AccessPath bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct WriteOp {
@@ -574,7 +574,7 @@ namespace diem_types {
         struct Deletion {
             friend bool operator==(const Deletion&, const Deletion&);
             std::vector<uint8_t> bcsSerialize() const;
-            static Deletion bcsDeserialize(std::vector<uint8_t>);
+            static Deletion bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct Value {
@@ -582,14 +582,14 @@ namespace diem_types {
 
             friend bool operator==(const Value&, const Value&);
             std::vector<uint8_t> bcsSerialize() const;
-            static Value bcsDeserialize(std::vector<uint8_t>);
+            static Value bcsDeserialize(std::span<const uint8_t>);
         };
 
         std::variant<Deletion, Value> value;
 
         friend bool operator==(const WriteOp&, const WriteOp&);
         std::vector<uint8_t> bcsSerialize() const;
-        static WriteOp bcsDeserialize(std::vector<uint8_t>);
+        static WriteOp bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct WriteSetMut {
@@ -597,7 +597,7 @@ namespace diem_types {
 
         friend bool operator==(const WriteSetMut&, const WriteSetMut&);
         std::vector<uint8_t> bcsSerialize() const;
-        static WriteSetMut bcsDeserialize(std::vector<uint8_t>);
+        static WriteSetMut bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct WriteSet {
@@ -605,7 +605,7 @@ namespace diem_types {
 
         friend bool operator==(const WriteSet&, const WriteSet&);
         std::vector<uint8_t> bcsSerialize() const;
-        static WriteSet bcsDeserialize(std::vector<uint8_t>);
+        static WriteSet bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct ChangeSet {
@@ -614,7 +614,7 @@ namespace diem_types {
 
         friend bool operator==(const ChangeSet&, const ChangeSet&);
         std::vector<uint8_t> bcsSerialize() const;
-        static ChangeSet bcsDeserialize(std::vector<uint8_t>);
+        static ChangeSet bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct WriteSetPayload {
@@ -624,7 +624,7 @@ namespace diem_types {
 
             friend bool operator==(const Direct&, const Direct&);
             std::vector<uint8_t> bcsSerialize() const;
-            static Direct bcsDeserialize(std::vector<uint8_t>);
+            static Direct bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct Script {
@@ -633,14 +633,14 @@ namespace diem_types {
 
             friend bool operator==(const Script&, const Script&);
             std::vector<uint8_t> bcsSerialize() const;
-            static Script bcsDeserialize(std::vector<uint8_t>);
+            static Script bcsDeserialize(std::span<const uint8_t>);
         };
 
         std::variant<Direct, Script> value;
 
         friend bool operator==(const WriteSetPayload&, const WriteSetPayload&);
         std::vector<uint8_t> bcsSerialize() const;
-        static WriteSetPayload bcsDeserialize(std::vector<uint8_t>);
+        static WriteSetPayload bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct TransactionPayload {
@@ -650,7 +650,7 @@ namespace diem_types {
 
             friend bool operator==(const WriteSet&, const WriteSet&);
             std::vector<uint8_t> bcsSerialize() const;
-            static WriteSet bcsDeserialize(std::vector<uint8_t>);
+            static WriteSet bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct Script {
@@ -658,7 +658,7 @@ namespace diem_types {
 
             friend bool operator==(const Script&, const Script&);
             std::vector<uint8_t> bcsSerialize() const;
-            static Script bcsDeserialize(std::vector<uint8_t>);
+            static Script bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct Module {
@@ -666,7 +666,7 @@ namespace diem_types {
 
             friend bool operator==(const Module&, const Module&);
             std::vector<uint8_t> bcsSerialize() const;
-            static Module bcsDeserialize(std::vector<uint8_t>);
+            static Module bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct ScriptFunction {
@@ -674,14 +674,14 @@ namespace diem_types {
 
             friend bool operator==(const ScriptFunction&, const ScriptFunction&);
             std::vector<uint8_t> bcsSerialize() const;
-            static ScriptFunction bcsDeserialize(std::vector<uint8_t>);
+            static ScriptFunction bcsDeserialize(std::span<const uint8_t>);
         };
 
         std::variant<WriteSet, Script, Module, ScriptFunction> value;
 
         friend bool operator==(const TransactionPayload&, const TransactionPayload&);
         std::vector<uint8_t> bcsSerialize() const;
-        static TransactionPayload bcsDeserialize(std::vector<uint8_t>);
+        static TransactionPayload bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct ChainId {
@@ -689,7 +689,7 @@ namespace diem_types {
 
         friend bool operator==(const ChainId&, const ChainId&);
         std::vector<uint8_t> bcsSerialize() const;
-        static ChainId bcsDeserialize(std::vector<uint8_t>);
+        static ChainId bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct RawTransaction {
@@ -704,7 +704,7 @@ namespace diem_types {
 
         friend bool operator==(const RawTransaction&, const RawTransaction&);
         std::vector<uint8_t> bcsSerialize() const;
-        static RawTransaction bcsDeserialize(std::vector<uint8_t>);
+        static RawTransaction bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct HashValue {
@@ -712,7 +712,7 @@ namespace diem_types {
 
         friend bool operator==(const HashValue&, const HashValue&);
         std::vector<uint8_t> bcsSerialize() const;
-        static HashValue bcsDeserialize(std::vector<uint8_t>);
+        static HashValue bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct BlockMetadata {
@@ -724,7 +724,7 @@ namespace diem_types {
 
         friend bool operator==(const BlockMetadata&, const BlockMetadata&);
         std::vector<uint8_t> bcsSerialize() const;
-        static BlockMetadata bcsDeserialize(std::vector<uint8_t>);
+        static BlockMetadata bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct SignedTransaction {
@@ -733,7 +733,7 @@ namespace diem_types {
 
         friend bool operator==(const SignedTransaction&, const SignedTransaction&);
         std::vector<uint8_t> bcsSerialize() const;
-        static SignedTransaction bcsDeserialize(std::vector<uint8_t>);
+        static SignedTransaction bcsDeserialize(std::span<const uint8_t>);
     };
 
     struct Transaction {
@@ -743,7 +743,7 @@ namespace diem_types {
 
             friend bool operator==(const UserTransaction&, const UserTransaction&);
             std::vector<uint8_t> bcsSerialize() const;
-            static UserTransaction bcsDeserialize(std::vector<uint8_t>);
+            static UserTransaction bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct GenesisTransaction {
@@ -751,7 +751,7 @@ namespace diem_types {
 
             friend bool operator==(const GenesisTransaction&, const GenesisTransaction&);
             std::vector<uint8_t> bcsSerialize() const;
-            static GenesisTransaction bcsDeserialize(std::vector<uint8_t>);
+            static GenesisTransaction bcsDeserialize(std::span<const uint8_t>);
         };
 
         struct BlockMetadata {
@@ -759,14 +759,14 @@ namespace diem_types {
 
             friend bool operator==(const BlockMetadata&, const BlockMetadata&);
             std::vector<uint8_t> bcsSerialize() const;
-            static BlockMetadata bcsDeserialize(std::vector<uint8_t>);
+            static BlockMetadata bcsDeserialize(std::span<const uint8_t>);
         };
 
         std::variant<UserTransaction, GenesisTransaction, BlockMetadata> value;
 
         friend bool operator==(const Transaction&, const Transaction&);
         std::vector<uint8_t> bcsSerialize() const;
-        static Transaction bcsDeserialize(std::vector<uint8_t>);
+        static Transaction bcsDeserialize(std::span<const uint8_t>);
     };
 
 } // end of namespace diem_types
@@ -786,7 +786,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline AccessPath AccessPath::bcsDeserialize(std::vector<uint8_t> input) {
+    inline AccessPath AccessPath::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<AccessPath>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -830,7 +830,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline AccountAddress AccountAddress::bcsDeserialize(std::vector<uint8_t> input) {
+    inline AccountAddress AccountAddress::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<AccountAddress>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -872,7 +872,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline AccountAuthenticator AccountAuthenticator::bcsDeserialize(std::vector<uint8_t> input) {
+    inline AccountAuthenticator AccountAuthenticator::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<AccountAuthenticator>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -915,7 +915,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline AccountAuthenticator::Ed25519 AccountAuthenticator::Ed25519::bcsDeserialize(std::vector<uint8_t> input) {
+    inline AccountAuthenticator::Ed25519 AccountAuthenticator::Ed25519::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<AccountAuthenticator::Ed25519>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -956,7 +956,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline AccountAuthenticator::MultiEd25519 AccountAuthenticator::MultiEd25519::bcsDeserialize(std::vector<uint8_t> input) {
+    inline AccountAuthenticator::MultiEd25519 AccountAuthenticator::MultiEd25519::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<AccountAuthenticator::MultiEd25519>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1000,7 +1000,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline BlockMetadata BlockMetadata::bcsDeserialize(std::vector<uint8_t> input) {
+    inline BlockMetadata BlockMetadata::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<BlockMetadata>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1050,7 +1050,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline ChainId ChainId::bcsDeserialize(std::vector<uint8_t> input) {
+    inline ChainId ChainId::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<ChainId>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1093,7 +1093,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline ChangeSet ChangeSet::bcsDeserialize(std::vector<uint8_t> input) {
+    inline ChangeSet ChangeSet::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<ChangeSet>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1137,7 +1137,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline CoinTradeMetadata CoinTradeMetadata::bcsDeserialize(std::vector<uint8_t> input) {
+    inline CoinTradeMetadata CoinTradeMetadata::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<CoinTradeMetadata>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1179,7 +1179,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline CoinTradeMetadata::CoinTradeMetadataV0 CoinTradeMetadata::CoinTradeMetadataV0::bcsDeserialize(std::vector<uint8_t> input) {
+    inline CoinTradeMetadata::CoinTradeMetadataV0 CoinTradeMetadata::CoinTradeMetadataV0::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<CoinTradeMetadata::CoinTradeMetadataV0>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1217,7 +1217,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline CoinTradeMetadataV0 CoinTradeMetadataV0::bcsDeserialize(std::vector<uint8_t> input) {
+    inline CoinTradeMetadataV0 CoinTradeMetadataV0::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<CoinTradeMetadataV0>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1259,7 +1259,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline ContractEvent ContractEvent::bcsDeserialize(std::vector<uint8_t> input) {
+    inline ContractEvent ContractEvent::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<ContractEvent>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1301,7 +1301,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline ContractEvent::V0 ContractEvent::V0::bcsDeserialize(std::vector<uint8_t> input) {
+    inline ContractEvent::V0 ContractEvent::V0::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<ContractEvent::V0>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1342,7 +1342,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline ContractEventV0 ContractEventV0::bcsDeserialize(std::vector<uint8_t> input) {
+    inline ContractEventV0 ContractEventV0::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<ContractEventV0>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1390,7 +1390,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline Ed25519PublicKey Ed25519PublicKey::bcsDeserialize(std::vector<uint8_t> input) {
+    inline Ed25519PublicKey Ed25519PublicKey::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<Ed25519PublicKey>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1432,7 +1432,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline Ed25519Signature Ed25519Signature::bcsDeserialize(std::vector<uint8_t> input) {
+    inline Ed25519Signature Ed25519Signature::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<Ed25519Signature>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1474,7 +1474,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline EventKey EventKey::bcsDeserialize(std::vector<uint8_t> input) {
+    inline EventKey EventKey::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<EventKey>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1516,7 +1516,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline GeneralMetadata GeneralMetadata::bcsDeserialize(std::vector<uint8_t> input) {
+    inline GeneralMetadata GeneralMetadata::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<GeneralMetadata>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1558,7 +1558,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline GeneralMetadata::GeneralMetadataVersion0 GeneralMetadata::GeneralMetadataVersion0::bcsDeserialize(std::vector<uint8_t> input) {
+    inline GeneralMetadata::GeneralMetadataVersion0 GeneralMetadata::GeneralMetadataVersion0::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<GeneralMetadata::GeneralMetadataVersion0>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1598,7 +1598,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline GeneralMetadataV0 GeneralMetadataV0::bcsDeserialize(std::vector<uint8_t> input) {
+    inline GeneralMetadataV0 GeneralMetadataV0::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<GeneralMetadataV0>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1644,7 +1644,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline HashValue HashValue::bcsDeserialize(std::vector<uint8_t> input) {
+    inline HashValue HashValue::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<HashValue>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1686,7 +1686,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline Identifier Identifier::bcsDeserialize(std::vector<uint8_t> input) {
+    inline Identifier Identifier::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<Identifier>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1728,7 +1728,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline Metadata Metadata::bcsDeserialize(std::vector<uint8_t> input) {
+    inline Metadata Metadata::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<Metadata>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1769,7 +1769,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline Metadata::Undefined Metadata::Undefined::bcsDeserialize(std::vector<uint8_t> input) {
+    inline Metadata::Undefined Metadata::Undefined::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<Metadata::Undefined>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1805,7 +1805,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline Metadata::GeneralMetadata Metadata::GeneralMetadata::bcsDeserialize(std::vector<uint8_t> input) {
+    inline Metadata::GeneralMetadata Metadata::GeneralMetadata::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<Metadata::GeneralMetadata>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1843,7 +1843,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline Metadata::TravelRuleMetadata Metadata::TravelRuleMetadata::bcsDeserialize(std::vector<uint8_t> input) {
+    inline Metadata::TravelRuleMetadata Metadata::TravelRuleMetadata::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<Metadata::TravelRuleMetadata>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1881,7 +1881,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline Metadata::UnstructuredBytesMetadata Metadata::UnstructuredBytesMetadata::bcsDeserialize(std::vector<uint8_t> input) {
+    inline Metadata::UnstructuredBytesMetadata Metadata::UnstructuredBytesMetadata::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<Metadata::UnstructuredBytesMetadata>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1919,7 +1919,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline Metadata::RefundMetadata Metadata::RefundMetadata::bcsDeserialize(std::vector<uint8_t> input) {
+    inline Metadata::RefundMetadata Metadata::RefundMetadata::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<Metadata::RefundMetadata>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1957,7 +1957,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline Metadata::CoinTradeMetadata Metadata::CoinTradeMetadata::bcsDeserialize(std::vector<uint8_t> input) {
+    inline Metadata::CoinTradeMetadata Metadata::CoinTradeMetadata::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<Metadata::CoinTradeMetadata>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -1995,7 +1995,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline Metadata::PaymentMetadata Metadata::PaymentMetadata::bcsDeserialize(std::vector<uint8_t> input) {
+    inline Metadata::PaymentMetadata Metadata::PaymentMetadata::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<Metadata::PaymentMetadata>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2033,7 +2033,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline Module Module::bcsDeserialize(std::vector<uint8_t> input) {
+    inline Module Module::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<Module>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2076,7 +2076,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline ModuleId ModuleId::bcsDeserialize(std::vector<uint8_t> input) {
+    inline ModuleId ModuleId::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<ModuleId>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2120,7 +2120,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline MultiEd25519PublicKey MultiEd25519PublicKey::bcsDeserialize(std::vector<uint8_t> input) {
+    inline MultiEd25519PublicKey MultiEd25519PublicKey::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<MultiEd25519PublicKey>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2162,7 +2162,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline MultiEd25519Signature MultiEd25519Signature::bcsDeserialize(std::vector<uint8_t> input) {
+    inline MultiEd25519Signature MultiEd25519Signature::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<MultiEd25519Signature>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2204,7 +2204,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline PaymentMetadata PaymentMetadata::bcsDeserialize(std::vector<uint8_t> input) {
+    inline PaymentMetadata PaymentMetadata::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<PaymentMetadata>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2246,7 +2246,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline PaymentMetadata::PaymentMetadataVersion0 PaymentMetadata::PaymentMetadataVersion0::bcsDeserialize(std::vector<uint8_t> input) {
+    inline PaymentMetadata::PaymentMetadataVersion0 PaymentMetadata::PaymentMetadataVersion0::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<PaymentMetadata::PaymentMetadataVersion0>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2284,7 +2284,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline PaymentMetadataV0 PaymentMetadataV0::bcsDeserialize(std::vector<uint8_t> input) {
+    inline PaymentMetadataV0 PaymentMetadataV0::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<PaymentMetadataV0>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2333,7 +2333,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline RawTransaction RawTransaction::bcsDeserialize(std::vector<uint8_t> input) {
+    inline RawTransaction RawTransaction::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<RawTransaction>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2389,7 +2389,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline RefundMetadata RefundMetadata::bcsDeserialize(std::vector<uint8_t> input) {
+    inline RefundMetadata RefundMetadata::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<RefundMetadata>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2431,7 +2431,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline RefundMetadata::RefundMetadataV0 RefundMetadata::RefundMetadataV0::bcsDeserialize(std::vector<uint8_t> input) {
+    inline RefundMetadata::RefundMetadataV0 RefundMetadata::RefundMetadataV0::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<RefundMetadata::RefundMetadataV0>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2470,7 +2470,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline RefundMetadataV0 RefundMetadataV0::bcsDeserialize(std::vector<uint8_t> input) {
+    inline RefundMetadataV0 RefundMetadataV0::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<RefundMetadataV0>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2514,7 +2514,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline RefundReason RefundReason::bcsDeserialize(std::vector<uint8_t> input) {
+    inline RefundReason RefundReason::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<RefundReason>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2555,7 +2555,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline RefundReason::OtherReason RefundReason::OtherReason::bcsDeserialize(std::vector<uint8_t> input) {
+    inline RefundReason::OtherReason RefundReason::OtherReason::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<RefundReason::OtherReason>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2590,7 +2590,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline RefundReason::InvalidSubaddress RefundReason::InvalidSubaddress::bcsDeserialize(std::vector<uint8_t> input) {
+    inline RefundReason::InvalidSubaddress RefundReason::InvalidSubaddress::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<RefundReason::InvalidSubaddress>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2625,7 +2625,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline RefundReason::UserInitiatedPartialRefund RefundReason::UserInitiatedPartialRefund::bcsDeserialize(std::vector<uint8_t> input) {
+    inline RefundReason::UserInitiatedPartialRefund RefundReason::UserInitiatedPartialRefund::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<RefundReason::UserInitiatedPartialRefund>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2660,7 +2660,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline RefundReason::UserInitiatedFullRefund RefundReason::UserInitiatedFullRefund::bcsDeserialize(std::vector<uint8_t> input) {
+    inline RefundReason::UserInitiatedFullRefund RefundReason::UserInitiatedFullRefund::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<RefundReason::UserInitiatedFullRefund>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2695,7 +2695,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline RefundReason::InvalidReferenceId RefundReason::InvalidReferenceId::bcsDeserialize(std::vector<uint8_t> input) {
+    inline RefundReason::InvalidReferenceId RefundReason::InvalidReferenceId::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<RefundReason::InvalidReferenceId>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2733,7 +2733,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline Script Script::bcsDeserialize(std::vector<uint8_t> input) {
+    inline Script Script::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<Script>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2782,7 +2782,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline ScriptFunction ScriptFunction::bcsDeserialize(std::vector<uint8_t> input) {
+    inline ScriptFunction ScriptFunction::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<ScriptFunction>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2831,7 +2831,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline SignedTransaction SignedTransaction::bcsDeserialize(std::vector<uint8_t> input) {
+    inline SignedTransaction SignedTransaction::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<SignedTransaction>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2878,7 +2878,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline StructTag StructTag::bcsDeserialize(std::vector<uint8_t> input) {
+    inline StructTag StructTag::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<StructTag>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2926,7 +2926,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline Transaction Transaction::bcsDeserialize(std::vector<uint8_t> input) {
+    inline Transaction Transaction::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<Transaction>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -2968,7 +2968,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline Transaction::UserTransaction Transaction::UserTransaction::bcsDeserialize(std::vector<uint8_t> input) {
+    inline Transaction::UserTransaction Transaction::UserTransaction::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<Transaction::UserTransaction>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3006,7 +3006,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline Transaction::GenesisTransaction Transaction::GenesisTransaction::bcsDeserialize(std::vector<uint8_t> input) {
+    inline Transaction::GenesisTransaction Transaction::GenesisTransaction::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<Transaction::GenesisTransaction>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3044,7 +3044,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline Transaction::BlockMetadata Transaction::BlockMetadata::bcsDeserialize(std::vector<uint8_t> input) {
+    inline Transaction::BlockMetadata Transaction::BlockMetadata::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<Transaction::BlockMetadata>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3082,7 +3082,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TransactionArgument TransactionArgument::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TransactionArgument TransactionArgument::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TransactionArgument>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3124,7 +3124,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TransactionArgument::U8 TransactionArgument::U8::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TransactionArgument::U8 TransactionArgument::U8::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TransactionArgument::U8>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3162,7 +3162,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TransactionArgument::U64 TransactionArgument::U64::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TransactionArgument::U64 TransactionArgument::U64::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TransactionArgument::U64>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3200,7 +3200,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TransactionArgument::U128 TransactionArgument::U128::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TransactionArgument::U128 TransactionArgument::U128::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TransactionArgument::U128>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3238,7 +3238,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TransactionArgument::Address TransactionArgument::Address::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TransactionArgument::Address TransactionArgument::Address::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TransactionArgument::Address>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3276,7 +3276,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TransactionArgument::U8Vector TransactionArgument::U8Vector::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TransactionArgument::U8Vector TransactionArgument::U8Vector::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TransactionArgument::U8Vector>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3314,7 +3314,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TransactionArgument::Bool TransactionArgument::Bool::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TransactionArgument::Bool TransactionArgument::Bool::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TransactionArgument::Bool>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3352,7 +3352,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TransactionAuthenticator TransactionAuthenticator::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TransactionAuthenticator TransactionAuthenticator::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TransactionAuthenticator>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3395,7 +3395,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TransactionAuthenticator::Ed25519 TransactionAuthenticator::Ed25519::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TransactionAuthenticator::Ed25519 TransactionAuthenticator::Ed25519::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TransactionAuthenticator::Ed25519>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3436,7 +3436,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TransactionAuthenticator::MultiEd25519 TransactionAuthenticator::MultiEd25519::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TransactionAuthenticator::MultiEd25519 TransactionAuthenticator::MultiEd25519::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TransactionAuthenticator::MultiEd25519>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3478,7 +3478,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TransactionAuthenticator::MultiAgent TransactionAuthenticator::MultiAgent::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TransactionAuthenticator::MultiAgent TransactionAuthenticator::MultiAgent::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TransactionAuthenticator::MultiAgent>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3520,7 +3520,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TransactionPayload TransactionPayload::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TransactionPayload TransactionPayload::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TransactionPayload>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3562,7 +3562,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TransactionPayload::WriteSet TransactionPayload::WriteSet::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TransactionPayload::WriteSet TransactionPayload::WriteSet::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TransactionPayload::WriteSet>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3600,7 +3600,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TransactionPayload::Script TransactionPayload::Script::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TransactionPayload::Script TransactionPayload::Script::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TransactionPayload::Script>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3638,7 +3638,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TransactionPayload::Module TransactionPayload::Module::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TransactionPayload::Module TransactionPayload::Module::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TransactionPayload::Module>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3676,7 +3676,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TransactionPayload::ScriptFunction TransactionPayload::ScriptFunction::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TransactionPayload::ScriptFunction TransactionPayload::ScriptFunction::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TransactionPayload::ScriptFunction>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3714,7 +3714,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TravelRuleMetadata TravelRuleMetadata::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TravelRuleMetadata TravelRuleMetadata::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TravelRuleMetadata>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3756,7 +3756,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TravelRuleMetadata::TravelRuleMetadataVersion0 TravelRuleMetadata::TravelRuleMetadataVersion0::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TravelRuleMetadata::TravelRuleMetadataVersion0 TravelRuleMetadata::TravelRuleMetadataVersion0::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TravelRuleMetadata::TravelRuleMetadataVersion0>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3794,7 +3794,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TravelRuleMetadataV0 TravelRuleMetadataV0::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TravelRuleMetadataV0 TravelRuleMetadataV0::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TravelRuleMetadataV0>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3836,7 +3836,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TypeTag TypeTag::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TypeTag TypeTag::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TypeTag>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3877,7 +3877,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TypeTag::Bool TypeTag::Bool::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TypeTag::Bool TypeTag::Bool::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TypeTag::Bool>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3912,7 +3912,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TypeTag::U8 TypeTag::U8::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TypeTag::U8 TypeTag::U8::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TypeTag::U8>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3947,7 +3947,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TypeTag::U64 TypeTag::U64::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TypeTag::U64 TypeTag::U64::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TypeTag::U64>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -3982,7 +3982,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TypeTag::U128 TypeTag::U128::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TypeTag::U128 TypeTag::U128::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TypeTag::U128>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -4017,7 +4017,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TypeTag::Address TypeTag::Address::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TypeTag::Address TypeTag::Address::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TypeTag::Address>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -4052,7 +4052,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TypeTag::Signer TypeTag::Signer::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TypeTag::Signer TypeTag::Signer::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TypeTag::Signer>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -4088,7 +4088,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TypeTag::Vector TypeTag::Vector::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TypeTag::Vector TypeTag::Vector::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TypeTag::Vector>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -4126,7 +4126,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline TypeTag::Struct TypeTag::Struct::bcsDeserialize(std::vector<uint8_t> input) {
+    inline TypeTag::Struct TypeTag::Struct::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<TypeTag::Struct>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -4164,7 +4164,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline UnstructuredBytesMetadata UnstructuredBytesMetadata::bcsDeserialize(std::vector<uint8_t> input) {
+    inline UnstructuredBytesMetadata UnstructuredBytesMetadata::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<UnstructuredBytesMetadata>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -4206,7 +4206,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline WriteOp WriteOp::bcsDeserialize(std::vector<uint8_t> input) {
+    inline WriteOp WriteOp::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<WriteOp>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -4247,7 +4247,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline WriteOp::Deletion WriteOp::Deletion::bcsDeserialize(std::vector<uint8_t> input) {
+    inline WriteOp::Deletion WriteOp::Deletion::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<WriteOp::Deletion>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -4283,7 +4283,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline WriteOp::Value WriteOp::Value::bcsDeserialize(std::vector<uint8_t> input) {
+    inline WriteOp::Value WriteOp::Value::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<WriteOp::Value>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -4321,7 +4321,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline WriteSet WriteSet::bcsDeserialize(std::vector<uint8_t> input) {
+    inline WriteSet WriteSet::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<WriteSet>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -4363,7 +4363,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline WriteSetMut WriteSetMut::bcsDeserialize(std::vector<uint8_t> input) {
+    inline WriteSetMut WriteSetMut::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<WriteSetMut>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -4405,7 +4405,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline WriteSetPayload WriteSetPayload::bcsDeserialize(std::vector<uint8_t> input) {
+    inline WriteSetPayload WriteSetPayload::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<WriteSetPayload>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -4447,7 +4447,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline WriteSetPayload::Direct WriteSetPayload::Direct::bcsDeserialize(std::vector<uint8_t> input) {
+    inline WriteSetPayload::Direct WriteSetPayload::Direct::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<WriteSetPayload::Direct>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
@@ -4486,7 +4486,7 @@ namespace diem_types {
         return std::move(serializer).bytes();
     }
 
-    inline WriteSetPayload::Script WriteSetPayload::Script::bcsDeserialize(std::vector<uint8_t> input) {
+    inline WriteSetPayload::Script WriteSetPayload::Script::bcsDeserialize(std::span<const uint8_t> input) {
         auto deserializer = serde::BcsDeserializer(input);
         auto value = serde::Deserializable<WriteSetPayload::Script>::deserialize(deserializer);
         if (deserializer.get_buffer_offset() < input.size()) {
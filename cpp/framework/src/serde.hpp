@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <functional>
@@ -304,6 +305,12 @@ struct Serializable<std::vector<T, Allocator>> {
     static void serialize(const std::vector<T, Allocator> &value,
                           Serializer &serializer) {
         serializer.serialize_len(value.size());
+        // Append byte vectors in one copy if the serializer supports it.
+        if constexpr (std::is_same_v<T, uint8_t> &&
+                      requires { serializer.serialize_bytes(value); }) {
+            serializer.serialize_bytes(value);
+            return;
+        }
         for (const T &item : value) {
             Serializable<T>::serialize(item, serializer);
         }
@@ -316,6 +323,11 @@ struct Serializable<std::array<T, N>> {
     template <typename Serializer>
     static void serialize(const std::array<T, N> &value,
                           Serializer &serializer) {
+        if constexpr (std::is_same_v<T, uint8_t> &&
+                      requires { serializer.serialize_bytes(value); }) {
+            serializer.serialize_bytes(value);
+            return;
+        }
         for (const T &item : value) {
             Serializable<T>::serialize(item, serializer);
         }
@@ -554,6 +566,13 @@ struct Deserializable<std::vector<T, Allocator>> {
     static std::vector<T> deserialize(Deserializer &deserializer) {
         std::vector<T> result;
         size_t len = deserializer.deserialize_len();
+        // Copy byte vectors in one read if the deserializer supports it.
+        if constexpr (std::is_same_v<T, uint8_t> &&
+                      requires { deserializer.deserialize_bytes(len); }) {
+            auto bytes = deserializer.deserialize_bytes(len);
+            result.assign(bytes.begin(), bytes.end());
+            return result;
+        }
         for (size_t i = 0; i < len; i++) {
             result.push_back(Deserializable<T>::deserialize(deserializer));
         }
@@ -597,6 +616,12 @@ struct Deserializable<std::array<T, N>> {
     template <typename Deserializer>
     static std::array<T, N> deserialize(Deserializer &deserializer) {
         std::array<T, N> result;
+        if constexpr (std::is_same_v<T, uint8_t> &&
+                      requires { deserializer.deserialize_bytes(N); }) {
+            auto bytes = deserializer.deserialize_bytes(N);
+            std::copy(bytes.begin(), bytes.end(), result.begin());
+            return result;
+        }
         for (T &item : result) {
             item = Deserializable<T>::deserialize(deserializer);
         }
@@ -641,7 +666,7 @@ struct Deserializable<std::variant<Types...>> {
 
         // Read the variant index and execute the corresponding case.
         auto index = deserializer.deserialize_variant_index();
-        if (index > cases.size()) {
+        if (index >= cases.size()) {
             throw deserialization_error("Unknown variant index for enum");
         }
         return cases.at(index)(deserializer);
@@ -38,7 +38,7 @@ int main(int argc, char *argv[])
 
         args.parse_command_line(argc, argv);
 
-        auto rpc_cli = json_rpc::Client::create(args.url);
+        auto rpc_cli = json_rpc::ClientPool::get(args.url);
 
         auto client = Client2::create(args.url, args.chain_id, args.mnemonic, args.mint_key);
         client->allow_custom_script(true);
@@ -115,8 +115,14 @@ void check_istream_eof(istream &is, string_view err)
 
 void check_account_index(client2_ptr client, size_t account_index)
 {
-    if (account_index >= client->get_all_accounts().size())
+    try
+    {
+        client->get_account_address(account_index);
+    }
+    catch (const out_of_range &)
+    {
         throw invalid_argument("The account index is more than the size of all accounts.");
+    }
 }
 
 template <typename T>
@@ -138,13 +144,11 @@ T get_from_stream(istringstream &params, client2_ptr client, string_view err_inf
     }
     else
     {
-        auto accounts = client->get_all_accounts();
-
         iss >> account_index;
-        if (account_index >= accounts.size())
+        if (account_index < 0)
             __throw_invalid_argument("account index is out of account size.");
-        else
-            addr = accounts[account_index].address.value;
+
+        addr = client->get_account_address(account_index).value;
     }
 
     return addr;
@@ -229,12 +233,14 @@ map<string, handle> create_store_commands(client2_ptr client, string url)
          {
              client->allow_publishing_module(true);
 
-             // 1.  deploy nft store
-             client->publish_module(ACCOUNT_ROOT_ID, "move/build/package/stdlib/compiled/Compare.mv");
-             client->publish_module(ACCOUNT_ROOT_ID, "move/build/modules/0_Map.mv");
-             client->publish_module(ACCOUNT_ROOT_ID, "move/build/modules/1_NonFungibleToken.mv");
-             client->publish_module(ACCOUNT_ROOT_ID, "move/build/modules/4_NftStore2.mv");
-             client->publish_module(ACCOUNT_ROOT_ID, "move/build/modules/5_Portrait.mv");
+             // 1.  deploy nft store, the modules are executed in the order of sequence numbers
+             PendingTxn::wait_all({
+                 client->publish_module_pending(ACCOUNT_ROOT_ID, "move/build/package/stdlib/compiled/Compare.mv"),
+                 client->publish_module_pending(ACCOUNT_ROOT_ID, "move/build/modules/0_Map.mv"),
+                 client->publish_module_pending(ACCOUNT_ROOT_ID, "move/build/modules/1_NonFungibleToken.mv"),
+                 client->publish_module_pending(ACCOUNT_ROOT_ID, "move/build/modules/4_NftStore2.mv"),
+                 client->publish_module_pending(ACCOUNT_ROOT_ID, "move/build/modules/5_Portrait.mv"),
+             });
 
              auto accounts = client->get_all_accounts();
              auto &a0 = accounts[0];
@@ -244,16 +250,21 @@ map<string, handle> create_store_commands(client2_ptr client, string url)
 
              try
              {
-                 client->create_designated_dealer_ex("VLS", a0.index, {NFT_STORE_ADMIN_ADDRESS}, a0.auth_key, "NFT Store Admin", true);
-                 cout << a0.index << " : " << a0.address.value << "\tRole : DD" << endl;
+                 PendingTxn::wait_all({
+                     client->create_designated_dealer_ex_pending("VLS", a0.index, {NFT_STORE_ADMIN_ADDRESS}, a0.auth_key, "NFT Store Admin", true),
+                     client->create_parent_vasp_account_pending(a1.address, a1.auth_key, "NFT VASP", true),
+                 });
 
-                 client->create_parent_vasp_account(a1.address, a1.auth_key, "NFT VASP", true);
+                 cout << a0.index << " : " << a0.address.value << "\tRole : DD" << endl;
                  cout << a1.index << " : " << a1.address.value << "\tRole : VASP" << endl;
 
-                 client->create_child_vasp_account(1, a2.address, a2.auth_key, "VLS", 0, true);
-                 cout << a2.index << " : " << a2.address.value << "\tRole : Child VASP" << endl;
+                 // the child VASP accounts are created by the parent VASP account after it exists
+                 PendingTxn::wait_all({
+                     client->create_child_vasp_account_pending(1, a2.address, a2.auth_key, "VLS", 0, true),
+                     client->create_child_vasp_account_pending(1, a3.address, a3.auth_key, "VLS", 0, true),
+                 });
 
-                 client->create_child_vasp_account(1, a3.address, a3.auth_key, "VLS", 0, true);
+                 cout << a2.index << " : " << a2.address.value << "\tRole : Child VASP" << endl;
                  cout << a3.index << " : " << a3.address.value << "\tRole : Child VASP" << endl;
              }
              catch (const std::exception &e)
@@ -145,30 +145,41 @@ namespace violas::nft
     }
 
     template <typename T>
-    optional<NftInfo> NonFungibleToken<T>::get_nft_info()
+    dt::StructTag NonFungibleToken<T>::nft_info_tag()
     {
-        auto state = _client->get_account_state(violas::ROOT_ADDRESS);
-
-        dt::StructTag tag{
+        return dt::StructTag{
             {VIOLAS_LIB_ADDRESS},
             "NonFungibleToken",
             "Configuration",
             {T::type_tag()}};
+    }
+
+    template <typename T>
+    optional<NftInfo> NonFungibleToken<T>::get_nft_info()
+    {
+        auto state = _client->get_account_state(violas::ROOT_ADDRESS);
+        if (!state)
+            return {};
 
-        return state->get_resource<NftInfo>(tag);
+        return state->get_resource<NftInfo>(nft_info_tag());
     }
 
     template <typename T>
     optional<Address> NonFungibleToken<T>::get_owner(const TokenId &token_id)
     {
-        auto opt_nft_info = get_nft_info();
-        if (opt_nft_info != nullopt)
+        auto state = _client->get_account_state(violas::ROOT_ADDRESS);
+        if (!state)
+            return {};
+
+        // look up the owner in the decoded NftInfo shared by the cached state, without copying all owners
+        auto nft_info = state->get_resource_ptr<NftInfo>(nft_info_tag());
+        if (nft_info)
         {
             vector<uint8_t> id;
             copy(begin(token_id), end(token_id), back_inserter<>(id));
 
-            auto iter = opt_nft_info->owners.find(id);
-            if (iter != end(opt_nft_info->owners))
+            auto iter = nft_info->owners.find(id);
+            if (iter != end(nft_info->owners))
             {
                 return iter->second;
             }
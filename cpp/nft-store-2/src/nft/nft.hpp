@@ -108,12 +108,8 @@ namespace violas::nft
     template <typename T>
     TokenId compute_token_id(const T &t)
     {
-        BcsSerde serde;
         auto temp = t;
-
-        serde &&temp;
-
-        auto bytes = serde.bytes();
+        auto bytes = BcsSerde::serialize(temp);
 
         auto token_id = sha3_256(bytes.data(), bytes.size());
 
@@ -127,6 +123,8 @@ namespace violas::nft
     {
     protected:
         violas::client2_ptr _client;
+        // the tag of resource NftInfo in the root account
+        static diem_types::StructTag nft_info_tag();
 
     public:
         NonFungibleToken(client2_ptr client);
@@ -197,10 +197,7 @@ std::ostream &operator<<(std::ostream &os, const std::vector<nft::Order> &orders
     int i = 0;
     for (auto order : orders)
     {
-        BcsSerde serde;
-
-        order.serde(serde);
-        auto bytes = serde.bytes();
+        auto bytes = BcsSerde::serialize(order);
         auto order_id = sha3_256(bytes.data(), bytes.size());
 
         os << left << setw(8) << i++
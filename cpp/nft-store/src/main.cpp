@@ -33,7 +33,7 @@ int main(int argc, char *argv[])
 
         // test(args);
 
-        auto rpc_cli = json_rpc::Client::create(args.url);
+        auto rpc_cli = json_rpc::ClientPool::get(args.url);
 
         auto client = Client2::create(args.url, args.chain_id, args.mnemonic, args.mint_key);
         client->allow_custom_script(true);
@@ -78,14 +78,10 @@ namespace violas1
             if (as.blob.empty())
                 __throw_runtime_error("Failed to get account state due to blob is null.");
 
-            // cout << "blob = " <<  as.blob << endl;
-
-            auto bytes = hex_to_bytes(as.blob);
-
             // Deserialize to vector
             vector<uint8_t> data;
             {
-                BcsSerde serde(bytes);
+                BcsSerde serde(move(as.blob));
                 serde &&data;
             }
 
@@ -96,12 +92,3 @@ namespace violas1
         }
     };
 }
-
-template <>
-template <typename Serializer>
-void serde::Serializable<violas::ResourcePath>::serialize(const violas::ResourcePath &obj, Serializer &serializer)
-{
-    serializer.increase_container_depth();
-    serde::Serializable<decltype(obj.path)>::serialize(obj.path, serializer);
-    serializer.decrease_container_depth();
-}
\ No newline at end of file
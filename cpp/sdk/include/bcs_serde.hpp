@@ -5,6 +5,19 @@
 #include <optional>
 #include <variant>
 #include <map>
+#include <span>
+#include <string_view>
+#include <cstring>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+#include <bit>
+#include <type_traits>
+#include <limits>
+#include <utility>
+#include <codec.hpp>
+#include <bcs.hpp>
+#include <hex_codec.hpp>
 
 class BcsSerde;
 
@@ -18,99 +31,278 @@ concept has_serde = requires(T t)
     // }
     std::same_as<decltype(t.serde(std::declval<BcsSerde &>())), BcsSerde &>;
 };
+//
+//  The generated types of diem_types, they are serialized by serde::Serializable<T> with the same codec
+//
+template <typename T>
+concept bcs_generated = !has_serde<T> && requires(const T &t)
+{
+    { t.bcsSerialize() } -> std::same_as<std::vector<uint8_t>>;
+};
+//
+//  The element whose BCS bytes are its memory, so that a container of them is copied in bulk
+//  bool is excluded because its byte must be 0 or 1
+//
+template <typename T>
+concept bcs_bulk_copyable = std::integral<T> && !std::same_as<T, bool> &&
+                            std::is_trivially_copyable_v<T> && std::endian::native == std::endian::little;
+
+//
+//  The mode of deserialization, the unchecked mode is faster but only for the trusted bytes
+//
+enum class BcsMode
+{
+    checked,
+    unchecked
+};
+//
+//  The budgets of checked deserialization, the defaults are the same as serde::BcsDeserializer
+//
+struct BcsLimits
+{
+    size_t max_length = serde::BCS_MAX_LENGTH;
+    size_t max_depth = serde::BCS_MAX_CONTAINER_DEPTH;
+};
 
 //
 //  Binary Serialization and Deserialization
 //
 class BcsSerde
 {
+    // the output of serialization, or the copy of input owned by deserialization
     std::vector<uint8_t> _bytes;
-    std::vector<uint8_t>::iterator _iterator = std::begin(_bytes);
+    // the input of deserialization, it is not owned if constructed with span
+    std::span<const uint8_t> _input;
+    size_t _offset = 0;
     bool _is_serialization = true;
-
-    void encode_integer(size_t value)
+    // the pre-pass of serialization only counts the size of bytes
+    bool _is_sizing = false;
+    size_t _size = 0;
+    // the bounds, lengths and depth are checked in checked mode
+    bool _is_checked = true;
+    BcsLimits _limits;
+    size_t _depth = 0;
+
+    [[noreturn]] static void throw_error(const char *error)
     {
-        do
+        throw serde::deserialization_error(std::string("BcsSerde: ") + error);
+    }
+    //
+    //  Count the depth of nested containers and structs while deserializing in checked mode
+    //
+    class DepthGuard
+    {
+        BcsSerde &_bs;
+
+    public:
+        DepthGuard(BcsSerde &bs) : _bs(bs)
+        {
+            if (!_bs._is_serialization && _bs._is_checked && ++_bs._depth > _bs._limits.max_depth)
+                throw_error("exceeded the maximum depth of containers");
+        }
+
+        ~DepthGuard()
         {
-            // get the low 7 bits
-            uint8_t v = value & 0b01111111;
+            if (!_bs._is_serialization && _bs._is_checked)
+                _bs._depth--;
+        }
+    };
 
-            // shift rgiht 7 bits
-            value >>= 7;
+    void write(const void *data, size_t n)
+    {
+        if (_is_sizing)
+            _size += n;
+        else
+            serde::codec::append(_bytes, data, n);
+    }
+    //
+    //  Take the bytes of count elements with size of elem_size, the count is checked before allocating
+    //
+    const uint8_t *read_elements(size_t count, size_t elem_size)
+    {
+        if (_is_checked && count > remaining() / elem_size)
+            throw_error("the bytes are not enough to deserialize");
+
+        return read(count * elem_size);
+    }
 
-            if (value)
-                v |= 0b10000000; // set the highest bit to 1
+    //
+    //  Take n bytes from input, the bounds are checked in checked mode
+    //
+    const uint8_t *read(size_t n)
+    {
+        if (_is_checked)
+            serde::codec::check_available(_input, _offset, n);
+
+        auto p = _input.data() + _offset;
+        _offset += n;
+
+        return p;
+    }
+
+    uint8_t read_flag()
+    {
+        uint8_t flag = *read(1);
+
+        if (_is_checked && flag > 1)
+            throw_error("invalid bool or option flag");
+
+        return flag;
+    }
+    //
+    //  The initial capacity of container with the length read from input, which is not trusted in checked mode
+    //
+    size_t initial_capacity(size_t size) const
+    {
+        return _is_checked ? std::min(size, remaining()) : size;
+    }
 
-            _bytes.push_back(v);
-        } while (value);
+    void encode_integer(size_t value)
+    {
+        if (_is_sizing)
+            _size += serde::codec::uleb128_size((uint32_t)value);
+        else
+            serde::codec::append_len(_bytes, value);
     }
 
     //
     //  Decode ULEB128 Integer, refer to https://en.wikipedia.org/wiki/LEB128
+    //  A length or variant index of BCS is an uint32, it is canonical and no more than max length in checked mode
     //
     size_t decode_integer()
     {
-        size_t value = 0;
-        uint8_t v = 0;
+        if (_is_checked)
+            return serde::codec::decode_len(_input, _offset, _limits.max_length);
+        else
+            return serde::codec::decode_uleb128_unchecked(_input.data(), _offset);
+    }
 
-        for (size_t i = 0; i < 4; i++)
-        {
-            v = *_iterator++;
+    //
+    //  The entries of map or set are serialized in the increasing order of their bytes, which is canonical in BCS,
+    //  offsets are the beginnings of entries written to the end of output
+    //
+    void sort_last_entries(std::vector<size_t> &offsets)
+    {
+        if (_is_sizing || offsets.size() <= 1)
+            return;
 
-            // get the low 7 bits
-            size_t t = v & 0b01111111; //0x80
+        offsets.push_back(_bytes.size());
 
-            // Shift 7 bits to left
-            t <<= 7 * i;
+        auto slice = [&](size_t i)
+        { return std::span<const uint8_t>(_bytes.data() + offsets[i], offsets[i + 1] - offsets[i]); };
+        auto less = [](std::span<const uint8_t> a, std::span<const uint8_t> b)
+        { return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end()); };
 
-            // and low bits
-            value |= t;
+        size_t count = offsets.size() - 1;
+        std::vector<size_t> order(count);
+        for (size_t i = 0; i < count; i++)
+            order[i] = i;
 
-            // break loop if the highest bit is zero
-            if (!(v & 0b10000000))
-                break;
+        // the integer keys are usually in order already
+        if (std::is_sorted(order.begin(), order.end(), [&](size_t a, size_t b)
+                           { return less(slice(a), slice(b)); }))
+            return;
+
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                  { return less(slice(a), slice(b)); });
+
+        std::vector<uint8_t> entries(_bytes.begin() + offsets.front(), _bytes.end());
+        size_t pos = offsets.front();
+
+        for (auto i : order)
+        {
+            std::memcpy(_bytes.data() + pos, entries.data() + offsets[i] - offsets.front(), offsets[i + 1] - offsets[i]);
+            pos += offsets[i + 1] - offsets[i];
         }
+    }
+    //
+    //  The keys of map or set must be strictly increasing in bytes in checked mode, as serde::BcsDeserializer does,
+    //  previous is the key before the one deserialized from key_offset
+    //
+    void check_key_order(std::span<const uint8_t> &previous, size_t key_offset, bool is_first)
+    {
+        auto key = _input.subspan(key_offset, _offset - key_offset);
+
+        if (!is_first && !std::lexicographical_compare(previous.begin(), previous.end(), key.begin(), key.end()))
+            throw_error("the keys of map or set are not in canonical order");
 
-        return value;
+        previous = key;
+    }
+
+    template <typename... Args, size_t... I>
+    void emplace_variant(std::variant<Args...> &var, size_t index, std::index_sequence<I...>)
+    {
+        // construct the alternative of index
+        ((I == index ? (var.template emplace<I>(), true) : false) || ...);
     }
 
 public:
     BcsSerde() { _is_serialization = true; }
 
-    BcsSerde(const std::vector<uint8_t> &bytes) : _is_serialization(false)
+    BcsSerde(const std::vector<uint8_t> &bytes, BcsMode mode = BcsMode::checked, BcsLimits limits = {})
+        : _bytes(bytes), _input(_bytes), _is_serialization(false), _is_checked(mode == BcsMode::checked), _limits(limits)
+    {
+    }
+
+    BcsSerde(std::vector<uint8_t> &&bytes, BcsMode mode = BcsMode::checked, BcsLimits limits = {})
+        : _bytes(std::move(bytes)), _input(_bytes), _is_serialization(false), _is_checked(mode == BcsMode::checked), _limits(limits)
+    {
+    }
+    //
+    //  Deserialize the bytes without copying them, the bytes must outlive BcsSerde and
+    //  the borrowed string_view and span
+    //
+    BcsSerde(std::span<const uint8_t> bytes, BcsMode mode = BcsMode::checked, BcsLimits limits = {})
+        : _input(bytes), _is_serialization(false), _is_checked(mode == BcsMode::checked), _limits(limits)
     {
-        _bytes = bytes;
-        _iterator = std::begin(_bytes);
     }
 
+    BcsSerde(const BcsSerde &bs) = delete;
+
     const BcsSerde &operator=(const BcsSerde &bs) = delete;
 
     std::vector<uint8_t> bytes() { return _bytes; }
 
-    void reset() { _iterator = std::begin(_bytes); }
-    
+    void reset() { _offset = 0; }
+
+    // the bytes not deserialized yet
+    size_t remaining() const { return _input.size() - _offset; }
+
     void set_des()
     {
         _is_serialization = false;
+        _input = _bytes;
         reset();
     }
 
-    std::string dump()
+    //
+    //  Serialize t into a buffer which is allocated once with the size computed by a pre-pass
+    //
+    template <typename T>
+    static std::vector<uint8_t> serialize(T &t)
     {
-        int i = 0;
-        std::ostringstream oss;
+        BcsSerde sizing;
+        sizing._is_sizing = true;
+        sizing &&t;
 
-        for (auto v : _bytes)
-        {
-            if (i % 16)
-                oss << std::endl;
+        BcsSerde serde;
+        serde._bytes.reserve(sizing._size);
+        serde &&t;
 
-            oss << std::setfill('0') << std::setw(2) << std::hex << (short)v << " ";
-        }
+        return std::move(serde._bytes);
+    }
 
-        std::setfill('\0');
+    std::string dump()
+    {
+        auto digits = hex_encode(_bytes);
+        std::string text;
 
-        return oss.str();
+        // every byte is followed by a space
+        text.reserve(_bytes.size() * 3);
+        for (size_t i = 0; i < digits.size(); i += 2)
+            text.append(digits, i, 2).push_back(' ');
+
+        return text;
     }
 
     //
@@ -119,6 +311,8 @@ public:
     template <has_serde T>
     BcsSerde &operator&&(T &t)
     {
+        DepthGuard guard(*this);
+
         return t.serde(*this);
     }
 
@@ -130,31 +324,58 @@ public:
     {
         if (_is_serialization)
         {
-            auto beg = (uint8_t *)&t;
-            auto end = beg + sizeof(T);
-
-            std::copy(beg, end, back_inserter(_bytes));
+            if (_is_sizing)
+                _size += sizeof(T);
+            else
+                serde::codec::append_le(_bytes, t);
         }
         else //deserialize
         {
-            auto beg = (uint8_t *)&t;
-            auto end = beg + sizeof(T);
-            while (beg < end)
+            t = serde::codec::load_le<T>(read(sizeof(T)));
+        }
+
+        return *this;
+    }
+
+    //
+    //  The generated types, such as diem_types::AccountAddress and diem_types::StructTag
+    //
+    template <bcs_generated T>
+    BcsSerde &operator&&(T &t)
+    {
+        if (_is_serialization)
+        {
+            // serialize into the buffer of BcsSerde without copying
+            serde::BcsSerializer serializer(std::move(_bytes));
+            serde::Serializable<T>::serialize(t, serializer);
+            _bytes = std::move(serializer).bytes();
+
+            if (_is_sizing)
             {
-                *beg++ = *_iterator++;
+                _size += _bytes.size();
+                _bytes.clear();
             }
         }
+        else //deserialize
+        {
+            serde::BcsDeserializer deserializer(_input.subspan(_offset));
+
+            t = serde::Deserializable<T>::deserialize(deserializer);
+            _offset += deserializer.get_buffer_offset();
+        }
 
         return *this;
     }
 
     BcsSerde &operator&&(bool &t)
     {
-        uint8_t v = t;
-
-        (*this) && v;
-
-        t = v;
+        if (_is_serialization)
+        {
+            uint8_t v = t;
+            (*this) && v;
+        }
+        else //deserialize
+            t = read_flag();
 
         return *this;
     }
@@ -168,15 +389,54 @@ public:
         {
             encode_integer(t.length());
 
-            std::copy(std::begin(t), std::end(t), back_inserter(_bytes));
+            write(t.data(), t.length());
+        }
+        else //deserialize
+        {
+            size_t size = decode_integer();
+            auto p = read(size);
+
+            t.assign((const char *)p, size);
+        }
+
+        return *this;
+    }
+    //
+    //  for string borrowed from input
+    //
+    BcsSerde &operator&&(std::string_view &t)
+    {
+        if (_is_serialization)
+        {
+            encode_integer(t.length());
+
+            write(t.data(), t.length());
         }
         else //deserialize
         {
             size_t size = decode_integer();
-            t.clear();
 
-            for (auto i = 0; i < size; i++)
-                t.push_back(*_iterator++);
+            t = std::string_view((const char *)read(size), size);
+        }
+
+        return *this;
+    }
+    //
+    //  for bytes borrowed from input
+    //
+    BcsSerde &operator&&(std::span<const uint8_t> &t)
+    {
+        if (_is_serialization)
+        {
+            encode_integer(t.size());
+
+            write(t.data(), t.size());
+        }
+        else //deserialize
+        {
+            size_t size = decode_integer();
+
+            t = std::span<const uint8_t>(read(size), size);
         }
 
         return *this;
@@ -188,6 +448,8 @@ public:
               template <class TElem, typename Alloc = std::allocator<TElem>> class Container>
     BcsSerde &operator&&(Container<T> &container)
     {
+        DepthGuard guard(*this);
+
         if (_is_serialization)
         {
             encode_integer(container.size());
@@ -197,6 +459,20 @@ public:
                 *this &&v;
             }
         }
+        else if (_is_checked)
+        {
+            size_t size = decode_integer();
+
+            // grow with the elements deserialized, a hostile length fails at the end of bytes
+            container.clear();
+            if constexpr (requires { container.reserve(size); })
+                container.reserve(initial_capacity(size));
+
+            for (size_t i = 0; i < size; i++)
+            {
+                *this && container.emplace_back();
+            }
+        }
         else //deserialize
         {
             size_t size = decode_integer();
@@ -211,6 +487,30 @@ public:
         return *this;
     }
     //
+    //  for vector of integers, such as bytes, copied in bulk
+    //
+    template <bcs_bulk_copyable T>
+    BcsSerde &operator&&(std::vector<T> &vec)
+    {
+        if (_is_serialization)
+        {
+            encode_integer(vec.size());
+
+            write(vec.data(), vec.size() * sizeof(T));
+        }
+        else //deserialize
+        {
+            size_t size = decode_integer();
+            auto p = read_elements(size, sizeof(T));
+
+            vec.resize(size);
+            if (size)
+                std::memcpy(vec.data(), p, size * sizeof(T));
+        }
+
+        return *this;
+    }
+    //
     // For std::set
     //
     template <typename T,
@@ -218,26 +518,39 @@ public:
               typename Set>
     BcsSerde &operator&&(Set<T> &set)
     {
+        DepthGuard guard(*this);
+
         if (_is_serialization)
         {
             encode_integer(set.size());
 
+            std::vector<size_t> offsets;
+            offsets.reserve(set.size());
+
             for (auto v : set)
             {
+                offsets.push_back(_bytes.size());
                 *this &&v;
             }
+
+            sort_last_entries(offsets);
         }
         else //deserialize
         {
             set.clear();
 
             size_t size = decode_integer();
+            std::span<const uint8_t> previous;
 
             for (size_t i = 0; i < size; i++)
             {
                 T k;
+                size_t key_offset = _offset;
                 *this &&k;
 
+                if (_is_checked)
+                    check_key_order(previous, key_offset, i == 0);
+
                 set.insert(k);
             }
         }
@@ -262,28 +575,44 @@ public:
     template <typename Key, typename Value>
     BcsSerde &operator&&(std::map<Key, Value> &container)
     {
+        DepthGuard guard(*this);
+
         if (_is_serialization)
         {
             encode_integer(container.size());
 
-            for (auto v : container)
+            std::vector<size_t> offsets;
+            offsets.reserve(container.size());
+
+            for (auto &v : container)
             {
                 Key k = v.first;
 
+                offsets.push_back(_bytes.size());
                 (*this) && k;
                 (*this) && v.second;
             }
+
+            sort_last_entries(offsets);
         }
         else //deserialize
         {
             container.clear();
 
             size_t size = decode_integer();
+            std::span<const uint8_t> previous;
+
             for (size_t i = 0; i < size; i++)
             {
                 std::pair<Key, Value> p;
+                size_t key_offset = _offset;
+
+                (*this) && p.first;
+
+                if (_is_checked)
+                    check_key_order(previous, key_offset, i == 0);
 
-                (*this) && p;
+                (*this) && p.second;
 
                 container.insert(p);
             }
@@ -316,6 +645,19 @@ public:
 
         return *this;
     }
+    //
+    //  serialize std::array of integers, such as address, copied in bulk
+    //
+    template <bcs_bulk_copyable T, size_t N>
+    BcsSerde &operator&&(std::array<T, N> &arr)
+    {
+        if (_is_serialization)
+            write(arr.data(), sizeof(arr));
+        else //deserialize
+            std::memcpy(arr.data(), read(sizeof(arr)), sizeof(arr));
+
+        return *this;
+    }
 
     //
     //  serialize std::array
@@ -334,15 +676,16 @@ public:
     template <typename T>
     BcsSerde &operator&&(std::optional<T> &opt)
     {
+        DepthGuard guard(*this);
+
         if (_is_serialization)
         {
             if (opt != std::nullopt)
             {
-                auto v = opt.value();
                 uint8_t flag = 1;
 
                 *this &&flag;
-                *this &&v;
+                *this && *opt;
             }
             else
             {
@@ -352,19 +695,12 @@ public:
         }
         else //deserialize
         {
-            uint8_t flag;
-
-            *this &&flag;
+            uint8_t flag = read_flag();
 
             if (!flag)
                 opt = std::nullopt;
             else
-            {
-                T t;
-
-                *this &&t;
-                opt = t;
-            }
+                *this && opt.emplace();
         }
 
         return *this;
@@ -373,14 +709,20 @@ public:
     template <typename... Args>
     BcsSerde &operator&&(std::variant<Args...> &var)
     {
+        DepthGuard guard(*this);
+
         if (_is_serialization)
         {
             encode_integer(var.index());
         }
         else //deserialize
         {
-            //size_t index = decode_integer();
-            decode_integer();
+            size_t index = decode_integer();
+
+            if (index >= sizeof...(Args))
+                throw_error("invalid variant index");
+
+            emplace_variant(var, index, std::index_sequence_for<Args...>{});
         }
 
         std::visit([this](auto &arg)
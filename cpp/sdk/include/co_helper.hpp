@@ -1,56 +1,531 @@
 #pragma once
-
-#if defined(__GNUC__) && !defined(__llvm__)
+/**
+ * @file co_helper.hpp
+ * @brief C++ 20 coroutine helpers: lazy Task, thread pool executor, cancellation and
+ *        awaitables adapted from callback based asynchronous functions
+ *
+ */
 #include <coroutine>
+#include <exception>
+#include <optional>
+#include <variant>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <queue>
+#include <vector>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+
+class operation_cancelled : public std::runtime_error
+{
+public:
+    operation_cancelled() : std::runtime_error("operation cancelled") {}
+};
+
 //
-//  Task class for C++ 20 coroutine  
+//  Cancellation, the source shares a flag with all tokens it created
 //
-template <typename T>
-struct Task
+class CancellationToken
 {
-    struct promise_type;
-    using co_handle = std::coroutine_handle<promise_type>;
-    co_handle _handle;
+    std::shared_ptr<std::atomic<bool>> _cancelled;
 
-    struct promise_type
+    friend class CancellationSource;
+
+    CancellationToken(std::shared_ptr<std::atomic<bool>> cancelled) : _cancelled(cancelled) {}
+
+public:
+    // a default token can never be cancelled
+    CancellationToken() {}
+
+    bool is_cancelled() const { return _cancelled && _cancelled->load(std::memory_order_acquire); }
+
+    void throw_if_cancelled() const
     {
-        T value;
+        if (is_cancelled())
+            throw operation_cancelled();
+    }
+};
+
+class CancellationSource
+{
+    std::shared_ptr<std::atomic<bool>> _cancelled = std::make_shared<std::atomic<bool>>(false);
+
+public:
+    CancellationToken token() const { return CancellationToken(_cancelled); }
+
+    void cancel() { _cancelled->store(true, std::memory_order_release); }
+
+    bool is_cancelled() const { return _cancelled->load(std::memory_order_acquire); }
+};
+
+//
+//  Thread pool executor which resumes coroutines on its worker threads
+//
+class Executor
+{
+    using clock = std::chrono::steady_clock;
+
+    struct Timer
+    {
+        clock::time_point time;
+        std::function<void()> fn;
+
+        bool operator>(const Timer &r) const { return time > r.time; }
+    };
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::deque<std::function<void()>> _jobs;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> _timers;
+    std::vector<std::thread> _threads;
+    bool _stopped = false;
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        while (true)
+        {
+            // move the expired timers to job queue
+            while (!_timers.empty() && _timers.top().time <= clock::now())
+            {
+                _jobs.push_back(std::move(const_cast<Timer &>(_timers.top()).fn));
+                _timers.pop();
+            }
+
+            if (!_jobs.empty())
+            {
+                auto job = std::move(_jobs.front());
+                _jobs.pop_front();
+
+                lock.unlock();
+                job();
+                lock.lock();
+            }
+            else if (_stopped)
+                break;
+            else if (!_timers.empty())
+            {
+                // copy the time, the queue may be reallocated by post_after while waiting
+                auto time = _timers.top().time;
+                _cv.wait_until(lock, time);
+            }
+            else
+                _cv.wait(lock);
+        }
+    }
+
+public:
+    explicit Executor(size_t thread_count = std::max(2u, std::thread::hardware_concurrency()))
+    {
+        for (size_t i = 0; i < thread_count; i++)
+            _threads.emplace_back([this]
+                                  { run(); });
+    }
+
+    ~Executor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopped = true;
+
+            // the pending timers are dropped
+            while (!_timers.empty())
+                _timers.pop();
+        }
+
+        _cv.notify_all();
+
+        for (auto &t : _threads)
+            t.join();
+    }
+
+    Executor(const Executor &) = delete;
+    Executor &operator=(const Executor &) = delete;
+
+    size_t thread_count() const { return _threads.size(); }
+
+    static Executor &default_executor()
+    {
+        static Executor executor;
+        return executor;
+    }
+
+    void post(std::function<void()> fn)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _jobs.push_back(std::move(fn));
+        }
+
+        _cv.notify_one();
+    }
+
+    void post_after(std::chrono::milliseconds delay, std::function<void()> fn)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _timers.push({clock::now() + delay, std::move(fn)});
+        }
+
+        _cv.notify_one();
+    }
+    //
+    //  co_await executor.schedule() to continue on a worker thread
+    //
+    auto schedule(CancellationToken token = {})
+    {
+        struct awaitable
+        {
+            Executor &_executor;
+            CancellationToken _token;
+
+            bool await_ready() { return false; }
+            void await_suspend(std::coroutine_handle<> h)
+            {
+                _executor.post([h]
+                               { h.resume(); });
+            }
+            void await_resume() { _token.throw_if_cancelled(); }
+        };
+
+        return awaitable{*this, token};
+    }
+    //
+    //  co_await executor.schedule_after(delay) to continue on a worker thread after delay
+    //
+    auto schedule_after(std::chrono::milliseconds delay, CancellationToken token = {})
+    {
+        struct awaitable
+        {
+            Executor &_executor;
+            std::chrono::milliseconds _delay;
+            CancellationToken _token;
+
+            bool await_ready() { return false; }
+            void await_suspend(std::coroutine_handle<> h)
+            {
+                _executor.post_after(_delay, [h]
+                                     { h.resume(); });
+            }
+            void await_resume() { _token.throw_if_cancelled(); }
+        };
+
+        return awaitable{*this, delay, token};
+    }
+};
+
+template <typename T = void>
+class Task;
+
+namespace co_detail
+{
+    struct PromiseBase
+    {
+        std::coroutine_handle<> _continuation = std::noop_coroutine();
+        std::exception_ptr _exception;
+
+        // lazy start, the task runs when it is awaited
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept { return false; }
+
+            // symmetric transfer to the awaiting coroutine
+            template <typename P>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept
+            {
+                return h.promise()._continuation;
+            }
+
+            void await_resume() noexcept {}
+        };
+
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void unhandled_exception() { _exception = std::current_exception(); }
+    };
+
+    template <typename T>
+    struct Promise : PromiseBase
+    {
+        std::optional<T> _value;
+
+        Task<T> get_return_object();
 
-        Task get_return_object() { return Task{co_handle::from_promise(*this)}; }
+        template <typename U>
+        void return_value(U &&v) { _value.emplace(std::forward<U>(v)); }
 
-        std::suspend_never initial_suspend() { return {}; }
+        T result()
+        {
+            if (_exception)
+                std::rethrow_exception(_exception);
+
+            return std::move(*_value);
+        }
+    };
 
-        std::suspend_never final_suspend() { return {}; }
+    template <>
+    struct Promise<void> : PromiseBase
+    {
+        Task<void> get_return_object();
 
-        void unhandled_exception() { std::rethrow_exception(std::current_exception()); }
+        void return_void() {}
 
-        std::suspend_never return_value(T v)
+        void result()
         {
-            value = v;
-            return {};
+            if (_exception)
+                std::rethrow_exception(_exception);
         }
     };
+    //
+    //  A coroutine which starts immediately and destroys itself at the end
+    //
+    struct Detached
+    {
+        struct promise_type
+        {
+            Detached get_return_object() { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+}
 
-    T get() { return _handle.promise().value; }
+//
+//  Task class for C++ 20 coroutine
+//
+template <typename T>
+class Task
+{
+public:
+    using promise_type = co_detail::Promise<T>;
+    using handle_type = std::coroutine_handle<promise_type>;
+
+private:
+    handle_type _handle;
+
+public:
+    Task() {}
+
+    explicit Task(handle_type h) : _handle(h) {}
+
+    Task(Task &&t) noexcept : _handle(std::exchange(t._handle, {})) {}
+
+    Task &operator=(Task &&t) noexcept
+    {
+        if (this != &t)
+        {
+            if (_handle)
+                _handle.destroy();
+
+            _handle = std::exchange(t._handle, {});
+        }
+
+        return *this;
+    }
+
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
 
     ~Task()
     {
         if (_handle)
             _handle.destroy();
     }
+
+    bool await_ready() const noexcept { return !_handle || _handle.done(); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        _handle.promise()._continuation = awaiting;
+        return _handle;
+    }
+
+    T await_resume() { return _handle.promise().result(); }
+    //
+    //  Awaitable which waits for completion without getting the result
+    //
+    auto when_ready()
+    {
+        struct awaitable
+        {
+            handle_type _handle;
+
+            bool await_ready() const noexcept { return !_handle || _handle.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                _handle.promise()._continuation = awaiting;
+                return _handle;
+            }
+            void await_resume() noexcept {}
+        };
+
+        return awaitable{_handle};
+    }
+
+    T result() { return _handle.promise().result(); }
+
+    // block the current thread until the task is completed
+    T get();
 };
 
-template <>
-struct Task<void>
+namespace co_detail
+{
+    template <typename T>
+    Task<T> Promise<T>::get_return_object() { return Task<T>{std::coroutine_handle<Promise<T>>::from_promise(*this)}; }
+
+    inline Task<void> Promise<void>::get_return_object() { return Task<void>{std::coroutine_handle<Promise<void>>::from_promise(*this)}; }
+}
+
+namespace co_detail
 {
-    struct promise_type
+    struct SyncWaitEvent
     {
-        Task<void> get_return_object() { return {}; }
-        std::suspend_never initial_suspend() { return {}; }
-        std::suspend_never final_suspend() noexcept { return {}; }
-        void return_void() {}
-        void unhandled_exception() { std::rethrow_exception(std::current_exception()); }
+        std::mutex _mutex;
+        std::condition_variable _cv;
+        bool _done = false;
+
+        void set()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _done = true;
+            _cv.notify_one();
+        }
+
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv.wait(lock, [this]
+                     { return _done; });
+        }
     };
-};
 
-#endif
\ No newline at end of file
+    // a free function rather than a lambda, the closure of a lambda dies before the coroutine resumes
+    template <typename T>
+    Detached sync_wait_start(Task<T> &task, SyncWaitEvent &event)
+    {
+        co_await task.when_ready();
+        event.set();
+    }
+}
+//
+//  Run a task and block the current thread until it is completed, must not be called on an executor thread
+//
+template <typename T>
+T sync_wait(Task<T> task)
+{
+    co_detail::SyncWaitEvent event;
+
+    co_detail::sync_wait_start(task, event);
+    event.wait();
+
+    return task.result();
+}
+
+template <typename T>
+T Task<T>::get()
+{
+    return sync_wait(std::move(*this));
+}
+//
+//  Start a task on the executor and return a future of its result
+//
+template <typename T>
+std::future<T> spawn(Task<T> task, Executor &executor = Executor::default_executor())
+{
+    auto promise = std::make_shared<std::promise<T>>();
+    auto future = promise->get_future();
+
+    [](Task<T> task, Executor &executor, std::shared_ptr<std::promise<T>> promise) -> co_detail::Detached
+    {
+        co_await executor.schedule();
+
+        try
+        {
+            if constexpr (std::is_void_v<T>)
+            {
+                co_await task;
+                promise->set_value();
+            }
+            else
+                promise->set_value(co_await task);
+        }
+        catch (...)
+        {
+            promise->set_exception(std::current_exception());
+        }
+    }(std::move(task), executor, promise);
+
+    return future;
+}
+//
+//  Adapt a callback based asynchronous function to an awaitable,
+//  the function is called with a callback of void(T &&, std::exception_ptr), or void(std::exception_ptr) if T is void
+//
+template <typename T>
+class CallbackAwaitable
+{
+public:
+    using value_type = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+    using callback_type = std::conditional_t<std::is_void_v<T>,
+                                             std::function<void(std::exception_ptr)>,
+                                             std::function<void(value_type &&, std::exception_ptr)>>;
+
+private:
+    std::function<void(callback_type)> _start;
+    CancellationToken _token;
+    std::optional<value_type> _value;
+    std::exception_ptr _exception;
+
+public:
+    CallbackAwaitable(std::function<void(callback_type)> start, CancellationToken token = {})
+        : _start(std::move(start)), _token(token) {}
+
+    bool await_ready() { return false; }
+
+    void await_suspend(std::coroutine_handle<> h)
+    {
+        _token.throw_if_cancelled();
+
+        // the callback may resume the coroutine and destroy this awaitable before start returns,
+        // so the function being called must not be a member, and no member is touched after it
+        auto start = std::move(_start);
+
+        if constexpr (std::is_void_v<T>)
+            start([this, h](std::exception_ptr e)
+                  {
+                      _exception = e;
+                      h.resume(); });
+        else
+            start([this, h](value_type &&v, std::exception_ptr e)
+                  {
+                      if (e)
+                          _exception = e;
+                      else
+                          _value.emplace(std::move(v));
+                      h.resume(); });
+    }
+
+    T await_resume()
+    {
+        if (_exception)
+            std::rethrow_exception(_exception);
+
+        _token.throw_if_cancelled();
+
+        if constexpr (!std::is_void_v<T>)
+            return std::move(*_value);
+    }
+};
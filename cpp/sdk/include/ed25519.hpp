@@ -12,7 +12,9 @@
  */
 #include <openssl/evp.h>
 #include <array>
+#include <span>
 #include <string>
+#include <vector>
 
 namespace crypto
 {
@@ -29,19 +31,31 @@ namespace crypto
         private:
             /* data */
             EVP_PKEY *m_pkey = nullptr;
+            RawKey m_raw_key; // cached raw bytes of key
+
+            friend class PrivateKey;
+
+            // share the key of private key, which can verify as well
+            PublicKey(EVP_PKEY *pkey, const RawKey &raw_key);
 
         public:
             PublicKey(RawKey raw_key);
 
+            PublicKey(const PublicKey &pub_key);
+
+            PublicKey(PublicKey &&pub_key);
+
+            PublicKey &operator=(const PublicKey &pub_key);
+
             static PublicKey from_hex_string(const std::string &hex_str);
 
             ~PublicKey();
 
-            RawKey get_raw_key() const;
+            RawKey get_raw_key() const { return m_raw_key; }
 
             std::string dump_hex() const;
 
-            bool verify(const Signature &sig, uint8_t *data, size_t len);
+            bool verify(const Signature &sig, const uint8_t *data, size_t len) const;
         };
 
         class PrivateKey
@@ -49,6 +63,7 @@ namespace crypto
         private:
             /* data */
             EVP_PKEY *m_pkey = NULL;
+            PublicKey m_public_key; // created once with the key
 
             PrivateKey(EVP_PKEY *pkey);
 
@@ -59,7 +74,7 @@ namespace crypto
 
             PrivateKey(PrivateKey &&priv_key);
 
-            PrivateKey operator=(const PrivateKey &priv_key);
+            PrivateKey &operator=(const PrivateKey &priv_key);
 
             static PrivateKey generate();
 
@@ -71,12 +86,32 @@ namespace crypto
 
             std::string dump_hex() const;
 
-            PublicKey get_public_key() const;
+            const PublicKey &get_public_key() const { return m_public_key; }
             //
             // sign for message
             //
-            Signature sign(uint8_t *data, size_t len);
+            Signature sign(const uint8_t *data, size_t len) const;
+        };
+
+        //
+        //  An entry of batch verification, the message must be alive until verify_batch returns
+        //
+        struct VerifyEntry
+        {
+            RawKey public_key;
+            std::span<const uint8_t> message;
+            Signature signature;
         };
+        /**
+         * @brief Verify a batch of signatures.
+         *        The key of each distinct public key is created once and the entries are verified by the calling thread
+         *        and the threads of the default executor.
+         *
+         * @param entries the public keys, messages and signatures
+         * @param thread_count the number of threads including the calling one, 0 for all threads of the default executor
+         * @return std::vector<size_t> the indices of the entries failed to verify in ascending order, empty if all passed
+         */
+        std::vector<size_t> verify_batch(std::span<const VerifyEntry> entries, size_t thread_count = 0);
 
         void run_test_case();
 
@@ -0,0 +1,246 @@
+#pragma once
+/**
+ * @file hex_codec.hpp
+ * @brief Table driven hex codec with SSE2 and AVX2 kernels, the kernels are selected at compile time
+ *        (-mavx2 for AVX2, SSE2 is always available on x86-64) and the scalar code handles the tail
+ *
+ */
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <stdexcept>
+#include <string>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace hex_detail
+{
+    inline constexpr char DIGITS[] = "0123456789abcdef";
+
+    // the value of hex char, or -1 if it is not a hex char
+    inline constexpr auto VALUES = []
+    {
+        struct
+        {
+            int8_t v[256];
+        } t{};
+
+        for (int i = 0; i < 256; i++)
+            t.v[i] = -1;
+        for (int i = 0; i < 10; i++)
+            t.v['0' + i] = int8_t(i);
+        for (int i = 0; i < 6; i++)
+            t.v['a' + i] = t.v['A' + i] = int8_t(10 + i);
+
+        return t;
+    }();
+
+    [[noreturn]] inline void throw_invalid_char(size_t pos)
+    {
+        throw std::runtime_error("hex_decode error, invalid hex char at position " + std::to_string(pos));
+    }
+
+    inline void encode_scalar(const uint8_t *in, size_t n, char *out)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            out[2 * i] = DIGITS[in[i] >> 4];
+            out[2 * i + 1] = DIGITS[in[i] & 0x0f];
+        }
+    }
+    //
+    //  Decode n bytes, pos is the position of in for the error message
+    //
+    inline void decode_scalar(const char *in, size_t n, uint8_t *out, size_t pos)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            int hi = VALUES.v[uint8_t(in[2 * i])];
+            int lo = VALUES.v[uint8_t(in[2 * i + 1])];
+
+            if ((hi | lo) < 0)
+                throw_invalid_char(pos + 2 * i + (hi < 0 ? 0 : 1));
+
+            out[i] = uint8_t(hi << 4 | lo);
+        }
+    }
+
+#if defined(__SSE2__)
+    // convert nibbles to lowercase hex chars
+    inline __m128i nibbles_to_chars(__m128i n)
+    {
+        __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(n, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10));
+
+        return _mm_add_epi8(_mm_add_epi8(n, _mm_set1_epi8('0')), alpha);
+    }
+
+    // convert hex chars to nibbles, valid is set to 0xff for hex chars
+    inline __m128i chars_to_nibbles(__m128i c, __m128i &valid)
+    {
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+        __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+        __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+
+        valid = _mm_or_si128(digit, alpha);
+
+        return _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+                            _mm_and_si128(alpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+    }
+
+    // 16 chars in nibbles to 8 bytes in the low half of 16-bit lanes
+    inline __m128i merge_nibbles(__m128i n)
+    {
+        __m128i hi = _mm_and_si128(n, _mm_set1_epi16(0x00ff));
+        __m128i lo = _mm_srli_epi16(n, 8);
+
+        return _mm_or_si128(_mm_slli_epi16(hi, 4), lo);
+    }
+#endif
+
+#if defined(__AVX2__)
+    inline __m256i nibbles_to_chars(__m256i n)
+    {
+        __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(n, _mm256_set1_epi8(9)), _mm256_set1_epi8('a' - '0' - 10));
+
+        return _mm256_add_epi8(_mm256_add_epi8(n, _mm256_set1_epi8('0')), alpha);
+    }
+
+    inline __m256i chars_to_nibbles(__m256i c, __m256i &valid)
+    {
+        __m256i digit = _mm256_andnot_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('9')), _mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)));
+        __m256i lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+        __m256i alpha = _mm256_andnot_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('f')), _mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)));
+
+        valid = _mm256_or_si256(digit, alpha);
+
+        return _mm256_or_si256(_mm256_and_si256(digit, _mm256_sub_epi8(c, _mm256_set1_epi8('0'))),
+                               _mm256_and_si256(alpha, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10))));
+    }
+
+    inline __m256i merge_nibbles(__m256i n)
+    {
+        __m256i hi = _mm256_and_si256(n, _mm256_set1_epi16(0x00ff));
+        __m256i lo = _mm256_srli_epi16(n, 8);
+
+        return _mm256_or_si256(_mm256_slli_epi16(hi, 4), lo);
+    }
+#endif
+}
+
+/**
+ * @brief Encode bytes to lowercase hex chars
+ *
+ * @param in    bytes
+ * @param out   the buffer for hex chars, its size must be at least 2 * in.size()
+ * @return size_t the number of chars written
+ */
+inline size_t hex_encode(std::span<const uint8_t> in, std::span<char> out)
+{
+    using namespace hex_detail;
+
+    if (out.size() < in.size() * 2)
+        throw std::runtime_error("hex_encode error, the output buffer is too small");
+
+    const uint8_t *src = in.data();
+    char *dst = out.data();
+    size_t n = in.size();
+
+#if defined(__AVX2__)
+    for (; n >= 32; n -= 32, src += 32, dst += 64)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)src);
+        __m256i hi = nibbles_to_chars(_mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0f)));
+        __m256i lo = nibbles_to_chars(_mm256_and_si256(v, _mm256_set1_epi8(0x0f)));
+
+        // unpack works in 128-bit lanes, the lanes are swapped back in order
+        __m256i a = _mm256_unpacklo_epi8(hi, lo);
+        __m256i b = _mm256_unpackhi_epi8(hi, lo);
+
+        _mm256_storeu_si256((__m256i *)dst, _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256((__m256i *)(dst + 32), _mm256_permute2x128_si256(a, b, 0x31));
+    }
+#endif
+#if defined(__SSE2__)
+    for (; n >= 16; n -= 16, src += 16, dst += 32)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)src);
+        __m128i hi = nibbles_to_chars(_mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0f)));
+        __m128i lo = nibbles_to_chars(_mm_and_si128(v, _mm_set1_epi8(0x0f)));
+
+        _mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+#endif
+    encode_scalar(src, n, dst);
+
+    return in.size() * 2;
+}
+/**
+ * @brief Decode hex chars to bytes with strict validation, the chars must be in [0-9a-fA-F] without "0x" prefix
+ *
+ * @param in    hex chars, its size must be even
+ * @param out   the buffer for bytes, its size must be at least in.size() / 2
+ * @return size_t the number of bytes written
+ * @throw std::runtime_error if the length is odd, the buffer is too small or a char is invalid
+ */
+inline size_t hex_decode(std::string_view in, std::span<uint8_t> out)
+{
+    using namespace hex_detail;
+
+    if (in.size() % 2)
+        throw std::runtime_error("hex_decode error, the length of hex string is odd");
+
+    if (out.size() < in.size() / 2)
+        throw std::runtime_error("hex_decode error, the output buffer is too small");
+
+    const char *src = in.data();
+    uint8_t *dst = out.data();
+    size_t n = in.size() / 2;
+
+#if defined(__AVX2__)
+    for (; n >= 32; n -= 32, src += 64, dst += 32)
+    {
+        __m256i valid_a, valid_b;
+        __m256i a = chars_to_nibbles(_mm256_loadu_si256((const __m256i *)src), valid_a);
+        __m256i b = chars_to_nibbles(_mm256_loadu_si256((const __m256i *)(src + 32)), valid_b);
+
+        if (_mm256_movemask_epi8(_mm256_and_si256(valid_a, valid_b)) != -1)
+            break; // the scalar code finds the invalid char
+
+        // pack works in 128-bit lanes, the 64-bit quarters are reordered
+        __m256i packed = _mm256_packus_epi16(merge_nibbles(a), merge_nibbles(b));
+
+        _mm256_storeu_si256((__m256i *)dst, _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+#endif
+#if defined(__SSE2__)
+    for (; n >= 16; n -= 16, src += 32, dst += 16)
+    {
+        __m128i valid_a, valid_b;
+        __m128i a = chars_to_nibbles(_mm_loadu_si128((const __m128i *)src), valid_a);
+        __m128i b = chars_to_nibbles(_mm_loadu_si128((const __m128i *)(src + 16)), valid_b);
+
+        if (_mm_movemask_epi8(_mm_and_si128(valid_a, valid_b)) != 0xffff)
+            break;
+
+        _mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(merge_nibbles(a), merge_nibbles(b)));
+    }
+#endif
+    decode_scalar(src, n, dst, src - in.data());
+
+    return in.size() / 2;
+}
+//
+//  Encode bytes to a lowercase hex string
+//
+inline std::string hex_encode(std::span<const uint8_t> in)
+{
+    std::string out(in.size() * 2, '\0');
+
+    hex_encode(in, std::span<char>(out.data(), out.size()));
+
+    return out;
+}
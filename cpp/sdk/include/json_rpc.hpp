@@ -6,12 +6,12 @@
 #include <optional>
 #include <variant>
 #include <functional>
+#include <future>
+#include <chrono>
+#include <stdexcept>
 #include <diem_types.hpp>
 #include <bcs_serde.hpp>
-
-#if defined(__GNUC__) && !defined(__llvm__)
-#include <coroutine>
-#endif
+#include <co_helper.hpp>
 
 namespace json_rpc
 {
@@ -42,20 +42,19 @@ namespace json_rpc
 
     struct AccountStateProof
     {
-        // hex-encoded bcs bytes
-        std::string ledger_info_to_transaction_info_proof; //[json_name = "ledger_info_to_transaction_info_proof"];
-        // hex-encoded bcs bytes
-        std::string transaction_info; //[json_name = "transaction_info"];
-        // hex-encoded bcs bytes
-        std::string transaction_info_to_account_proof; //[json_name = "transaction_info_to_account_proof"];
+        // bcs bytes decoded from hex
+        std::vector<uint8_t> ledger_info_to_transaction_info_proof; //[json_name = "ledger_info_to_transaction_info_proof"];
+        // bcs bytes decoded from hex
+        std::vector<uint8_t> transaction_info; //[json_name = "transaction_info"];
+        // bcs bytes decoded from hex
+        std::vector<uint8_t> transaction_info_to_account_proof; //[json_name = "transaction_info_to_account_proof"];
     };
 
     struct AccountStateWithProof
     {
         uint64_t version;
-        // hex-encoded bcs bytes
-        std::string blob;
-        // hex-encoded bcs bytes
+        // bcs bytes decoded from hex, empty if the account does not exist
+        std::vector<uint8_t> blob;
         AccountStateProof proof;
     };
 
@@ -90,12 +89,12 @@ namespace json_rpc
         std::string secondary_signatures;        // Hex-encoded signatures of this transaction signed by the primary signers
         std::string secondary_public_keys;       // Hex-encoded public keys of the secondary signers
 
-        uint64_t sequence_number; // Sequence number of this transaction corresponding to sender's account
-        uint8_t chain_id;         // Chain ID of the Diem network this transaction is intended for
-        uint64_t max_gas_amount;  // Maximum amount of gas that can be spent for this transaction
-        uint64_t gas_unit_price;
-        std::string gas_currency;           // Gas price currency code
-        uint64_t expiration_timestamp_secs; // The expiration time (Unix Epoch in seconds) for this transaction
+        uint64_t sequence_number = 0; // Sequence number of this transaction corresponding to sender's account
+        uint8_t chain_id = 0;         // Chain ID of the Diem network this transaction is intended for
+        uint64_t max_gas_amount = 0;  // Maximum amount of gas that can be spent for this transaction
+        uint64_t gas_unit_price = 0;
+        std::string gas_currency;               // Gas price currency code
+        uint64_t expiration_timestamp_secs = 0; // The expiration time (Unix Epoch in seconds) for this transaction
 
         std::string script_hash;  // Hex-encoded sha3 256 hash of the script binary code bytes used in this transaction
         std::string script_bytes; // Hex-encoded string of BCS bytes of the script, decode it to get back transaction script arguments
@@ -147,17 +146,110 @@ namespace json_rpc
 
     struct TransactionView
     {
-        uint64_t version;            // The on-chain version or unique identifier of this transaction
+        uint64_t version = 0;        // The on-chain version or unique identifier of this transaction
         TransactionData txn_data;    // Transaction payload
         std::string hash;            // hex encoded string of hash of this transaction, hex encoded
         std::string bytes;           // hex encoded string of raw bytes of the transaction, hex encoded
         std::list<EventView> events; // List of associated events. Empty for no events
         VMStatus vm_status;          // The returned status of the transaction after being processed by the VM
-        uint64_t gas_used;           // Amount of gas used by this transaction, to know how much you paid for the transaction,
+        uint64_t gas_used = 0;       // Amount of gas used by this transaction, to know how much you paid for the transaction,
                                      // you need multiply it with your RawTransaction#gas_unit_price
     };
 
     ////////////////////////////////////////////////////////////////////////////////////////////////
+    //  Requests and responses for JSON-RPC 2.0 batch
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    namespace method
+    {
+        struct GetAccount
+        {
+            diem_types::AccountAddress address;
+            std::optional<uint64_t> version;
+        };
+
+        struct GetAccountTransaction
+        {
+            diem_types::AccountAddress address;
+            uint64_t sequence_number;
+            bool include_events;
+        };
+
+        struct GetAccountStateWithProof
+        {
+            std::string account_address; // hex-encoded account address
+            std::optional<uint64_t> version;        // the version of state, the ledger version if null
+            std::optional<uint64_t> ledger_version; // the ledger version which the proof is against, the latest if null
+        };
+
+        struct GetEvents
+        {
+            std::string event_key; // hex-encoded event key
+            uint64_t start;
+            uint64_t limit;
+        };
+
+        struct Submit
+        {
+            diem_types::SignedTransaction signed_txn;
+            std::vector<uint8_t> bytes; // the BCS bytes of signed_txn, serialized when the request is sent if empty
+        };
+    }
+
+    // The index of a response alternative always equals to the index of its request alternative
+    using Request = std::variant<method::GetAccount,
+                                 method::GetAccountTransaction,
+                                 method::GetAccountStateWithProof,
+                                 method::GetEvents,
+                                 method::Submit>;
+
+    using Response = std::variant<std::optional<AccountView>,
+                                  std::optional<TransactionView>,
+                                  AccountStateWithProof,
+                                  std::vector<EventView>,
+                                  std::monostate>;
+
+    //
+    //  An error object replied by the server, the request was received and rejected,
+    //  unlike the transport errors after which the request may or may not have been processed
+    //
+    struct RpcError : public std::runtime_error
+    {
+        using std::runtime_error::runtime_error;
+    };
+
+    struct ClientOptions
+    {
+        // The requests over this limit are queued and sent when a response comes back
+        size_t max_requests_in_flight = 64;
+        // The requests in flight are spread over this number of http clients, each one keeps its own connections
+        size_t max_connections = 8;
+        // Timeout for each HTTP request
+        std::chrono::seconds timeout{30};
+        // Reuse connections between requests, otherwise every request is sent with "Connection: close"
+        bool keep_alive = true;
+        // A pooled client which has no request for this long and is held by no one else is released with its
+        // connections, the pool sweeps the idle clients periodically
+        std::chrono::seconds idle_timeout{60};
+    };
+
+    struct MultiClientOptions
+    {
+        // Options for the client of each endpoint
+        ClientOptions client;
+
+        enum class Balance
+        {
+            least_outstanding, // the endpoint with the fewest requests in flight
+            ewma_latency,      // the endpoint with the lowest EWMA latency weighted by its requests in flight
+        };
+        Balance balance = Balance::ewma_latency;
+        // A read without response after this delay is also sent to the next best endpoint, 0 disables hedging
+        std::chrono::milliseconds hedge_delay{200};
+        // An endpoint is ejected after this many consecutive transport failures
+        size_t max_failures = 3;
+        // and re-admitted after this duration
+        std::chrono::seconds eject_duration{30};
+    };
 
     ////////////////////////////////////////////////////////////////////////////////////
 
@@ -166,6 +258,20 @@ namespace json_rpc
         static std::shared_ptr<Client>
         create(std::string_view url);
 
+        static std::shared_ptr<Client>
+        create(std::string_view url, const ClientOptions &options);
+        /**
+         * @brief Create a client over several validators or full nodes, the reads are balanced and hedged,
+         *        a failing endpoint is ejected and the ledger version of reads never goes backwards.
+         *        A submit goes to one endpoint and is not failed over, it may have been accepted before a transport error
+         *
+         * @param urls      the urls of endpoints
+         * @param options
+         * @return std::shared_ptr<Client>
+         */
+        static std::shared_ptr<Client>
+        create(const std::vector<std::string> &urls, const MultiClientOptions &options = {});
+
         virtual ~Client() {}
         /**
          * @brief Submit a singed transaction to validator or full node
@@ -174,96 +280,231 @@ namespace json_rpc
          */
         virtual void submit(const diem_types::SignedTransaction &signed_txn) = 0;
 
-#if defined(__GNUC__) && !defined(__llvm__)
-        //
-        //  Async submit
-        //
-        virtual void async_submit(const diem_types::SignedTransaction &signed_txn,
-                                  std::function<void()> callback) = 0;
+        virtual std::optional<TransactionView>
+        get_account_transaction(const diem_types::AccountAddress &address,
+                                uint64_t sequence_number,
+                                bool include_events) = 0;
+
+        virtual std::optional<AccountView>
+        get_account(const diem_types::AccountAddress &, std::optional<uint64_t> version = std::nullopt) = 0;
+
+        virtual std::vector<Currency>
+        get_currencies() = 0;
+
+        virtual AccountStateWithProof
+        get_account_state_blob(std::string account_address) = 0;
+
+        virtual std::vector<EventView>
+        get_events(std::string event_key, uint64_t start, uint64_t limit, uint64_t rpc_id = 1) = 0;
+        /**
+         * @brief Send all requests in one HTTP POST as a JSON-RPC 2.0 batch
+         *
+         * @param requests  a list of heterogeneous requests
+         * @return std::vector<Response>
+         *          the responses are matched by id and returned in the same order as requests
+         */
+        virtual std::vector<Response>
+        batch(const std::vector<Request> &requests) = 0;
+
+        ////////////////////////////////////////////////////////////////
+        // Asynchronous interfaces
+        ////////////////////////////////////////////////////////////////
+        using Callback = std::function<void(Response &&, std::exception_ptr)>;
+        using BatchCallback = std::function<void(std::vector<Response> &&, std::exception_ptr)>;
+        /**
+         * @brief Send a request without blocking, the callback is called on a thread of http client
+         *        with the response or an exception
+         *
+         * @param request
+         * @param callback
+         */
+        virtual void
+        async_call(const Request &request, Callback callback) = 0;
+
+        virtual void
+        async_batch(const std::vector<Request> &requests, BatchCallback callback) = 0;
+
         //
-        // co_wait await_submit
+        //  Send a request and return a future of the response alternative T
         //
-        auto await_submit(diem_types::SignedTransaction &&signed_txn)
+        template <typename T>
+        std::future<T> async_call(const Request &request)
         {
-            struct awaitable
-            {
-                std::shared_ptr<Client> _client;
-                diem_types::SignedTransaction signed_txn;
-
-                bool await_ready() { return false; }
-                void await_resume() {}
-                void await_suspend(std::coroutine_handle<> h)
-                {
-                    _client->async_submit(signed_txn, [h]()
-                                          { h.resume(); });
-                }
-            };
+            auto promise = std::make_shared<std::promise<T>>();
+            auto future = promise->get_future();
+
+            async_call(request, [promise](Response &&response, std::exception_ptr e)
+                       {
+                           if (e)
+                               promise->set_exception(e);
+                           else if constexpr (std::is_same_v<T, void>)
+                               promise->set_value();
+                           else
+                               promise->set_value(std::get<T>(std::move(response))); });
+
+            return future;
+        }
 
-            return awaitable{shared_from_this(), std::move(signed_txn)};
+        std::future<void>
+        async_submit(const diem_types::SignedTransaction &signed_txn)
+        {
+            return async_call<void>(method::Submit{signed_txn});
         }
-#endif
 
-        virtual std::optional<TransactionView>
-        get_account_transaction(const diem_types::AccountAddress &address,
-                                uint64_t sequence_number,
-                                bool include_events) = 0;
+        void async_submit(const diem_types::SignedTransaction &signed_txn,
+                          std::function<void(std::exception_ptr)> callback)
+        {
+            async_call(method::Submit{signed_txn}, [callback](Response &&, std::exception_ptr e)
+                       { callback(e); });
+        }
 
-        virtual void
+        std::future<std::optional<TransactionView>>
         async_get_account_transaction(const diem_types::AccountAddress &address,
                                       uint64_t sequence_number,
-                                      bool include_events,
-                                      std::function<void(TransactionView &)>) = 0;
+                                      bool include_events)
+        {
+            return async_call<std::optional<TransactionView>>(method::GetAccountTransaction{address, sequence_number, include_events});
+        }
 
-#if defined(__GNUC__) && !defined(__llvm__)
-        auto await_get_account_transaction(const diem_types::AccountAddress &address,
+        void async_get_account_transaction(const diem_types::AccountAddress &address,
                                            uint64_t sequence_number,
-                                           bool include_events)
+                                           bool include_events,
+                                           std::function<void(std::optional<TransactionView> &&, std::exception_ptr)> callback)
         {
-            struct awaitable
-            {
-                std::shared_ptr<Client> _client;
-                diem_types::AccountAddress address;
-                uint64_t sequence_number;
-                bool include_events;
+            async_call(method::GetAccountTransaction{address, sequence_number, include_events},
+                       [callback](Response &&response, std::exception_ptr e)
+                       {
+                           if (e)
+                               callback(std::nullopt, e);
+                           else
+                               callback(std::get<std::optional<TransactionView>>(std::move(response)), nullptr);
+                       });
+        }
 
-                TransactionView _txn_view;
+        std::future<std::optional<AccountView>>
+        async_get_account(const diem_types::AccountAddress &address, std::optional<uint64_t> version = std::nullopt)
+        {
+            return async_call<std::optional<AccountView>>(method::GetAccount{address, version});
+        }
 
-                bool await_ready() { return false; }
-                auto await_resume() { return _txn_view; }
-                void await_suspend(std::coroutine_handle<> h)
+        std::future<AccountStateWithProof>
+        async_get_account_state_blob(std::string account_address)
+        {
+            return async_call<AccountStateWithProof>(method::GetAccountStateWithProof{account_address});
+        }
+
+        std::future<std::vector<EventView>>
+        async_get_events(std::string event_key, uint64_t start, uint64_t limit)
+        {
+            return async_call<std::vector<EventView>>(method::GetEvents{event_key, start, limit});
+        }
+
+        std::future<std::vector<Response>>
+        async_batch(const std::vector<Request> &requests)
+        {
+            auto promise = std::make_shared<std::promise<std::vector<Response>>>();
+            auto future = promise->get_future();
+
+            async_batch(requests, [promise](std::vector<Response> &&responses, std::exception_ptr e)
+                        {
+                            if (e)
+                                promise->set_exception(e);
+                            else
+                                promise->set_value(std::move(responses)); });
+
+            return future;
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Awaitable interfaces for C++ 20 coroutine
+        ////////////////////////////////////////////////////////////////
+        //
+        //  co_await a request and get the response alternative T, the coroutine is resumed on a thread of http client
+        //
+        template <typename T>
+        CallbackAwaitable<T> await_call(Request request, CancellationToken token = {})
+        {
+            using callback_type = typename CallbackAwaitable<T>::callback_type;
+
+            return CallbackAwaitable<T>(
+                [self = shared_from_this(), request = std::move(request)](callback_type callback)
                 {
-                    _client->async_get_account_transaction(
-                        address,
-                        sequence_number,
-                        include_events,
-                        [h, this](TransactionView &view)
-                        { 
-                            _txn_view = view;
-                            h.resume(); });
-                }
-            };
-
-            return awaitable{
-                shared_from_this(),
-                address,
-                sequence_number,
-                include_events};
+                    self->async_call(request, [callback](Response &&response, std::exception_ptr e)
+                                     {
+                                         if constexpr (std::is_void_v<T>)
+                                             callback(e);
+                                         else if (e)
+                                             callback(T{}, e);
+                                         else
+                                             callback(std::get<T>(std::move(response)), nullptr); });
+                },
+                token);
         }
-#endif
-        virtual std::optional<AccountView>
-        get_account(const diem_types::AccountAddress &, std::optional<uint64_t> version = std::nullopt) = 0;
 
-        virtual std::vector<Currency>
-        get_currencies() = 0;
+        auto await_submit(diem_types::SignedTransaction signed_txn, CancellationToken token = {})
+        {
+            return await_call<void>(method::Submit{std::move(signed_txn)}, token);
+        }
 
-        virtual AccountStateWithProof
-        get_account_state_blob(std::string account_address) = 0;
+        auto await_get_account_transaction(const diem_types::AccountAddress &address,
+                                           uint64_t sequence_number,
+                                           bool include_events,
+                                           CancellationToken token = {})
+        {
+            return await_call<std::optional<TransactionView>>(method::GetAccountTransaction{address, sequence_number, include_events}, token);
+        }
 
-        virtual std::vector<EventView>
-        get_events(std::string event_key, uint64_t start, uint64_t limit, uint64_t rpc_id = 1) = 0;
+        auto await_get_account(const diem_types::AccountAddress &address,
+                               std::optional<uint64_t> version = std::nullopt,
+                               CancellationToken token = {})
+        {
+            return await_call<std::optional<AccountView>>(method::GetAccount{address, version}, token);
+        }
+
+        auto await_get_account_state_blob(std::string account_address, CancellationToken token = {})
+        {
+            return await_call<AccountStateWithProof>(method::GetAccountStateWithProof{std::move(account_address)}, token);
+        }
+
+        auto await_get_events(std::string event_key, uint64_t start, uint64_t limit, CancellationToken token = {})
+        {
+            return await_call<std::vector<EventView>>(method::GetEvents{std::move(event_key), start, limit}, token);
+        }
+
+        auto await_batch(std::vector<Request> requests, CancellationToken token = {})
+        {
+            return CallbackAwaitable<std::vector<Response>>(
+                [self = shared_from_this(), requests = std::move(requests)](BatchCallback callback)
+                { self->async_batch(requests, callback); },
+                token);
+        }
     };
 
     using client_ptr = std::shared_ptr<Client>;
+    //
+    //  A thread-safe pool of clients keyed by URL and options, all SDK components get their client from it
+    //  to share the kept-alive connections instead of creating a client for every call
+    //
+    struct ClientPool
+    {
+        /**
+         * @brief Get the pooled client of url and options, it is created if it does not exist,
+         *        the clients of the same url with different options do not share connections
+         *
+         * @param url       the url of validator or full node
+         * @param options
+         * @return client_ptr
+         */
+        static client_ptr get(std::string_view url, const ClientOptions &options = {});
+        //
+        //  Release the clients which are only held by the pool and idle over their idle timeout
+        //
+        static void release_idle();
+        //
+        //  Release all clients of the pool, the clients still held by others keep working
+        //
+        static void clear();
+    };
 }
 
 #endif
\ No newline at end of file
@@ -132,7 +132,7 @@ namespace violas::nft
     {
         using namespace json_rpc;
 
-        auto rpc_cli = json_rpc::Client::create(_url);
+        auto rpc_cli = json_rpc::ClientPool::get(_url);
 
         StructTag tag{
             Address{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2},
@@ -158,7 +158,7 @@ namespace violas::nft
     optional<NftInfo> NonFungibleToken<T>::get_nft_info(string url)
     {
         using namespace json_rpc;
-        auto rpc_cli = json_rpc::Client::create(url);
+        auto rpc_cli = json_rpc::ClientPool::get(url);
 
         violas::AccountState state(rpc_cli);
 
@@ -196,7 +196,7 @@ namespace violas::nft
     optional<Account> NonFungibleToken<T>::get_account(const violas::Address &address)
     {
         using namespace json_rpc;
-        auto rpc_cli = json_rpc::Client::create(_url);
+        auto rpc_cli = json_rpc::ClientPool::get(_url);
 
         violas::AccountState state(rpc_cli);
 
@@ -303,7 +303,7 @@ namespace violas::nft
         std::vector<EVENT> nft_events;
 
         using namespace json_rpc;
-        auto rpc_cli = json_rpc::Client::create(_url);       
+        auto rpc_cli = json_rpc::ClientPool::get(_url);
 
         auto events = rpc_cli->get_events(bytes_to_hex(event_handle.guid), start, limit);
 
@@ -0,0 +1,128 @@
+#pragma once
+/**
+ * @file signing_message.hpp
+ * @brief The domain separated messages of Diem, a message is sha3_256("DIEM::" + type name) followed by BCS bytes.
+ *        The prefix hashes are computed once for each type name and the bytes are serialized into a reused buffer.
+ *
+ */
+#include <array>
+#include <map>
+#include <string>
+#include <string_view>
+#include <mutex>
+#include <shared_mutex>
+#include <diem_types.hpp>
+#include "wallet.hpp"
+
+namespace violas
+{
+    class SigningMessage
+    {
+        // BCS serializer whose buffer keeps its capacity between messages
+        class Serializer : public serde::BcsSerializer
+        {
+        public:
+            void reset(const std::array<uint8_t, 32> &prefix)
+            {
+                bytes_.assign(prefix.begin(), prefix.end());
+            }
+
+            const std::vector<uint8_t> &buffer() const { return bytes_; }
+        };
+
+        Serializer _serializer;
+
+    public:
+        using Hash = std::array<uint8_t, 32>;
+
+        /**
+         * @brief The prefix hash sha3_256("DIEM::" + type_name), e.g. type name "RawTransaction"
+         *
+         * @param type_name the name of Diem type
+         * @return const Hash& the hash computed at first call of each type name
+         */
+        static const Hash &prefix(std::string_view type_name)
+        {
+            static std::shared_mutex mutex;
+            static std::map<std::string, Hash, std::less<>> prefixes;
+
+            {
+                std::shared_lock lock(mutex);
+
+                auto iter = prefixes.find(type_name);
+                if (iter != prefixes.end())
+                    return iter->second;
+            }
+
+            std::string salt = "DIEM::" + std::string(type_name);
+            auto hash = sha3_256((uint8_t *)salt.data(), salt.size());
+
+            std::unique_lock lock(mutex);
+
+            // the references to map elements are stable
+            return prefixes.try_emplace(std::string(type_name), hash).first->second;
+        }
+        //
+        //  Start a message with the prefix of type name, the previous message is discarded
+        //
+        SigningMessage &begin(std::string_view type_name)
+        {
+            _serializer.reset(prefix(type_name));
+            return *this;
+        }
+        //
+        //  Append the BCS bytes of value
+        //
+        template <typename T>
+        SigningMessage &append(const T &value)
+        {
+            serde::Serializable<T>::serialize(value, static_cast<serde::BcsSerializer &>(_serializer));
+            return *this;
+        }
+
+        SigningMessage &append_variant_index(uint32_t index)
+        {
+            _serializer.serialize_variant_index(index);
+            return *this;
+        }
+
+        const uint8_t *data() const { return _serializer.buffer().data(); }
+
+        size_t size() const { return _serializer.buffer().size(); }
+        //
+        //  The CryptoHash of message, sha3_256(prefix || BCS bytes)
+        //
+        Hash hash() const { return sha3_256(data(), size()); }
+        //
+        //  The message of RawTransaction for the signature of sender
+        //
+        SigningMessage &raw_txn(const diem_types::RawTransaction &raw_txn)
+        {
+            return begin("RawTransaction").append(raw_txn);
+        }
+        //
+        //  The message of RawTransactionWithData::MultiAgent for the signatures of multi agent transaction
+        //
+        SigningMessage &multi_agent_raw_txn(const diem_types::RawTransaction &raw_txn,
+                                            const std::vector<diem_types::AccountAddress> &secondary_signer_addresses)
+        {
+            return begin("RawTransactionWithData").append_variant_index(0).append(raw_txn).append(secondary_signer_addresses);
+        }
+        //
+        //  The message builder of current thread
+        //
+        static SigningMessage &local()
+        {
+            thread_local SigningMessage message;
+            return message;
+        }
+    };
+    //
+    //  The CryptoHasher of Diem, the hash of any Diem type with its type name
+    //
+    template <typename T>
+    SigningMessage::Hash crypto_hash(std::string_view type_name, const T &value)
+    {
+        return SigningMessage::local().begin(type_name).append(value).hash();
+    }
+}
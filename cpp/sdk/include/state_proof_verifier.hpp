@@ -0,0 +1,148 @@
+#pragma once
+/**
+ * @file state_proof_verifier.hpp
+ * @brief Verify the account states read from untrusted full nodes with the proofs of get_account_state_with_proof,
+ *        against the root hashes of transaction accumulator which are trusted by the caller.
+ *
+ *  The proof of an account state is a chain of
+ *      1. the sparse Merkle proof from the account state blob to the state root hash in TransactionInfo,
+ *      2. the accumulator proof from TransactionInfo to the root hash of transaction accumulator at ledger version.
+ *  The hashes are the CryptoHash of Diem, sha3_256(sha3_256("DIEM::" + type name) || bytes).
+ */
+#include <array>
+#include <map>
+#include <tuple>
+#include <span>
+#include <vector>
+#include <optional>
+#include <shared_mutex>
+#include <diem_types.hpp>
+#include "bcs_serde.hpp"
+#include "json_rpc.hpp"
+
+namespace violas
+{
+    //
+    //  The types of proofs, which are not in the generated diem_types
+    //
+    namespace proof
+    {
+        // HashValue is serialized as bytes with length
+        using HashValue = std::span<const uint8_t>;
+
+        struct AccumulatorProof
+        {
+            // from the bottom level to the root level
+            std::vector<HashValue> siblings;
+
+            BcsSerde &serde(BcsSerde &bs)
+            {
+                return bs && siblings;
+            }
+        };
+
+        struct SparseMerkleLeafNode
+        {
+            HashValue key;
+            HashValue value_hash;
+
+            BcsSerde &serde(BcsSerde &bs)
+            {
+                return bs && key && value_hash;
+            }
+        };
+
+        struct SparseMerkleProof
+        {
+            // the leaf on the path of key, the key of leaf is another one for a non-inclusion proof
+            std::optional<SparseMerkleLeafNode> leaf;
+            // from the bottom level to the root level
+            std::vector<HashValue> siblings;
+
+            BcsSerde &serde(BcsSerde &bs)
+            {
+                return bs && leaf && siblings;
+            }
+        };
+        //
+        //  The leading fields of TransactionInfo, gas_used and VM status follow them
+        //
+        struct TransactionInfoHead
+        {
+            HashValue transaction_hash;
+            HashValue state_root_hash;
+            HashValue event_root_hash;
+
+            BcsSerde &serde(BcsSerde &bs)
+            {
+                return bs && transaction_hash && state_root_hash && event_root_hash;
+            }
+        };
+    }
+
+    /**
+     * @brief Verify the proofs of account states, it is thread safe.
+     *
+     *  The verified nodes of the transaction accumulator are cached for each trusted ledger, an accumulator proof stops
+     *  at the first node verified before. The verified account states are cached as well, so checking the proof of an
+     *  account at the same ledger version again only hashes its blob.
+     */
+    class StateProofVerifier
+    {
+    public:
+        using Hash = std::array<uint8_t, 32>;
+
+        // the number of trusted ledgers cached, the oldest ones are dropped
+        explicit StateProofVerifier(size_t max_ledgers = 16);
+        /**
+         * @brief Trust the root hash of transaction accumulator at a ledger version, e.g. from a waypoint or the
+         *        signed ledger info of a trusted node
+         *
+         * @param version                   the ledger version
+         * @param accumulator_root_hash     the root hash of transaction accumulator at version
+         */
+        void trust(uint64_t version, const Hash &accumulator_root_hash);
+        //
+        //  The latest ledger version trusted, nullopt if none
+        //
+        std::optional<uint64_t> latest_version();
+        /**
+         * @brief Verify an account state read with get_account_state_with_proof at a trusted ledger version,
+         *        throw runtime_error if the version is not trusted, the state is not at the expected version,
+         *        or the proof is invalid. A genuine proof of an older state is rejected as well.
+         *
+         * @param address           the address of account
+         * @param version           the version of state requested, no more than ledger_version
+         * @param ledger_version    the ledger version which the proof is against
+         * @param asp               the account state with proof, an empty blob is verified as a non-existent account
+         */
+        void verify(const diem_types::AccountAddress &address,
+                    uint64_t version,
+                    uint64_t ledger_version,
+                    const json_rpc::AccountStateWithProof &asp);
+
+    private:
+        // the level and index of a node in accumulator, leaves are at level 0
+        using NodeId = std::tuple<uint32_t, uint64_t>;
+
+        struct Ledger
+        {
+            Hash accumulator_root_hash;
+            // the nodes of accumulator verified with the root hash
+            std::map<NodeId, Hash> nodes;
+            // the verified states of accounts with the hash of blob, nullopt if the account doesn't exist
+            std::map<std::array<uint8_t, 16>, std::tuple<uint64_t, std::optional<Hash>>> accounts;
+        };
+
+        size_t _max_ledgers;
+        std::shared_mutex _mutex;
+        std::map<uint64_t, Ledger> _ledgers;
+
+        void verify_accumulator(uint64_t ledger_version, const Hash &leaf_hash, uint64_t leaf_index,
+                                const proof::AccumulatorProof &proof);
+
+        static void verify_sparse_merkle(const Hash &expected_root_hash, const Hash &key,
+                                         const std::optional<Hash> &value_hash,
+                                         const proof::SparseMerkleProof &proof);
+    };
+}
@@ -0,0 +1,180 @@
+#pragma once
+/**
+ * @file txn_verifier.hpp
+ * @brief Verify the authenticators of signed transactions in batch, including the secondary signers of multi agent
+ *        transactions and the multi-signatures of MultiEd25519.
+ *
+ */
+#include <bit>
+#include <span>
+#include <vector>
+#include <algorithm>
+#include <diem_types.hpp>
+#include "ed25519.hpp"
+#include "signing_message.hpp"
+
+namespace violas
+{
+    class TxnVerifier
+    {
+        std::vector<std::vector<uint8_t>> _messages;
+        std::vector<crypto::ed25519::VerifyEntry> _entries;
+        std::vector<size_t> _owners; // the index of transaction for each entry
+        std::vector<size_t> _malformed;
+
+        template <typename T>
+        static bool to_array(const std::vector<uint8_t> &bytes, T &array)
+        {
+            if (bytes.size() != array.size())
+                return false;
+
+            std::copy(begin(bytes), end(bytes), begin(array));
+            return true;
+        }
+
+        bool add(size_t txn_index, const std::vector<uint8_t> &message,
+                 const diem_types::Ed25519PublicKey &public_key, const diem_types::Ed25519Signature &signature)
+        {
+            crypto::ed25519::VerifyEntry entry{.message = message};
+
+            if (!to_array(public_key.value, entry.public_key) || !to_array(signature.value, entry.signature))
+                return false;
+
+            _entries.push_back(entry);
+            _owners.push_back(txn_index);
+
+            return true;
+        }
+        //
+        //  The public key is N keys followed by 1 byte threshold,
+        //  the signature is K signatures followed by 4 bytes bitmap of the signing keys, the highest bit is key 0
+        //
+        bool add(size_t txn_index, const std::vector<uint8_t> &message,
+                 const diem_types::MultiEd25519PublicKey &public_key, const diem_types::MultiEd25519Signature &signature)
+        {
+            using namespace crypto::ed25519;
+            const size_t MAX_NUM_OF_KEYS = 32, BITMAP_SIZE = 4;
+
+            auto &keys = public_key.value;
+            auto &sigs = signature.value;
+
+            if (keys.size() % KEY_LENGTH != 1 || sigs.size() % SIGNATURE_LENGTH != BITMAP_SIZE)
+                return false;
+
+            size_t num_of_keys = keys.size() / KEY_LENGTH, threshold = keys.back();
+            size_t num_of_sigs = sigs.size() / SIGNATURE_LENGTH;
+
+            if (num_of_keys == 0 || num_of_keys > MAX_NUM_OF_KEYS || threshold == 0 || threshold > num_of_keys)
+                return false;
+
+            uint32_t bitmap = uint32_t(sigs[sigs.size() - 4]) << 24 | uint32_t(sigs[sigs.size() - 3]) << 16 |
+                              uint32_t(sigs[sigs.size() - 2]) << 8 | uint32_t(sigs[sigs.size() - 1]);
+
+            if (size_t(std::popcount(bitmap)) != num_of_sigs || num_of_sigs < threshold)
+                return false;
+
+            for (size_t key = 0, sig = 0; key < MAX_NUM_OF_KEYS; key++)
+            {
+                if ((bitmap & (0x80000000u >> key)) == 0)
+                    continue;
+
+                if (key >= num_of_keys)
+                    return false;
+
+                VerifyEntry entry{.message = message};
+
+                std::copy_n(begin(keys) + key * KEY_LENGTH, KEY_LENGTH, begin(entry.public_key));
+                std::copy_n(begin(sigs) + sig * SIGNATURE_LENGTH, SIGNATURE_LENGTH, begin(entry.signature));
+
+                _entries.push_back(entry);
+                _owners.push_back(txn_index);
+                sig++;
+            }
+
+            return true;
+        }
+
+        bool add(size_t txn_index, const std::vector<uint8_t> &message, const diem_types::AccountAuthenticator &authenticator)
+        {
+            return std::visit([&](const auto &auth)
+                              { return add(txn_index, message, auth.public_key, auth.signature); },
+                              authenticator.value);
+        }
+
+        bool add(size_t txn_index, const diem_types::SignedTransaction &txn)
+        {
+            using TA = diem_types::TransactionAuthenticator;
+            auto &msg = SigningMessage::local();
+            auto &message = _messages[txn_index];
+
+            if (auto multi_agent = std::get_if<TA::MultiAgent>(&txn.authenticator.value))
+            {
+                if (multi_agent->secondary_signer_addresses.size() != multi_agent->secondary_signers.size())
+                    return false;
+
+                msg.multi_agent_raw_txn(txn.raw_txn, multi_agent->secondary_signer_addresses);
+                message.assign(msg.data(), msg.data() + msg.size());
+
+                if (!add(txn_index, message, multi_agent->sender))
+                    return false;
+
+                for (auto &signer : multi_agent->secondary_signers)
+                {
+                    if (!add(txn_index, message, signer))
+                        return false;
+                }
+
+                return true;
+            }
+
+            msg.raw_txn(txn.raw_txn);
+            message.assign(msg.data(), msg.data() + msg.size());
+
+            if (auto ed25519 = std::get_if<TA::Ed25519>(&txn.authenticator.value))
+                return add(txn_index, message, ed25519->public_key, ed25519->signature);
+
+            auto &multi_ed25519 = std::get<TA::MultiEd25519>(txn.authenticator.value);
+            return add(txn_index, message, multi_ed25519.public_key, multi_ed25519.signature);
+        }
+
+    public:
+        /**
+         * @brief Verify all signatures of transactions in batch
+         *
+         * @param txns signed transactions
+         * @param thread_count the number of threads, 0 for hardware concurrency
+         * @return std::vector<size_t> the indices of transactions failed to verify in ascending order, empty if all passed
+         */
+        std::vector<size_t> verify(std::span<const diem_types::SignedTransaction> txns, size_t thread_count = 0)
+        {
+            // the entries refer to the messages, so the messages must not be reallocated
+            _messages.assign(txns.size(), {});
+            _entries.clear();
+            _owners.clear();
+            _malformed.clear();
+
+            for (size_t i = 0; i < txns.size(); i++)
+            {
+                size_t count = _entries.size();
+
+                if (!add(i, txns[i]))
+                {
+                    // drop the entries of a malformed transaction
+                    _entries.resize(count);
+                    _owners.resize(count);
+                    _malformed.push_back(i);
+                }
+            }
+
+            auto failed = _malformed;
+
+            for (auto entry : crypto::ed25519::verify_batch(_entries, thread_count))
+                failed.push_back(_owners[entry]);
+
+            std::sort(begin(failed), end(failed));
+            failed.erase(std::unique(begin(failed), end(failed)), end(failed));
+
+            return failed;
+        }
+    };
+}
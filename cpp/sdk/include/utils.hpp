@@ -4,9 +4,13 @@
 #include <sstream>
 #include <iterator>
 #include <string>
+#include <vector>
+#include <memory>
 #include <array>
 #include <algorithm>
 #include <iomanip>
+#include <span>
+#include "hex_codec.hpp"
 #include <termios.h>
 #include <unistd.h>
 
@@ -50,16 +54,10 @@ void input(T &t)
 template <size_t N>
 std::ostringstream &operator<<(std::ostringstream &oss, const std::array<uint8_t, N> &bytes)
 {
-    auto flags = oss.flags();
-    auto fill = oss.fill();
+    char buf[N * 2];
 
-    for (auto v : bytes)
-    {
-        oss << std::setfill('0') << std::setw(2) << std::hex << (int)v;
-    }
-
-    oss.setf(flags);
-    std::setfill(fill);
+    hex_encode(bytes, buf);
+    oss.write(buf, sizeof(buf));
 
     return oss;
 }
@@ -67,73 +65,34 @@ std::ostringstream &operator<<(std::ostringstream &oss, const std::array<uint8_t
 template <size_t N>
 std::ostream &operator<<(std::ostream &os, const std::array<uint8_t, N> &bytes)
 {
-    // std::ostream tos(os.rdbuf());   // temp os for setting io manipulator
-    std::ostringstream oss;
-
-    oss << bytes;
+    char buf[N * 2];
 
-    // for (auto v : bytes)
-    // {
-    //     oss << std::setfill('0') << std::setw(2) << std::hex << (int)v;
-    // }
+    hex_encode(bytes, buf);
 
-    return os << oss.str();
+    // write as one string so that setw works
+    return os << std::string_view(buf, sizeof(buf));
 }
 
-// inline std::istringstream &operator>>(std::istringstream &iss, const std::vector<uint8_t> &bytes)
-// {
-//     string str;
-//     iss >> str;
-
-//     for (auto v : bytes)
-//     {
-//         iss << std::setfill('0') << std::setw(2) << std::hex << (int)v;
-//     }
-
-//     return iss;
-// }
-
 inline std::ostringstream &operator<<(std::ostringstream &oss, const std::vector<uint8_t> &bytes)
 {
-    auto flags = oss.flags();
+    auto hex = hex_encode(bytes);
 
-    for (auto v : bytes)
-    {
-        oss << std::setfill('0') << std::setw(2) << std::hex << (int)v;
-    }
-
-    oss.setf(flags);
+    oss.write(hex.data(), hex.size());
 
     return oss;
 }
 
 inline std::ostream &operator<<(std::ostream &os, const std::vector<uint8_t> &bytes)
 {
-    std::ostringstream oss;
-
-    oss << bytes;
-
-    return os << oss.str();
+    return os << hex_encode(bytes);
 }
-
+//
+//  Decode a hex string to array, the string may be shorter or longer than the array
+//
 template <size_t N>
 void operator>>(const std::string &str, std::array<uint8_t, N> &bytes)
 {
-    for (size_t i = 0, x = 0; i < str.length() && i < N; ++i, x += 2)
-    {
-        std::istringstream iss(str.substr(x, 2));
-        unsigned short b = 0;
-
-        if (!(iss >> std::hex >> b))
-        {
-            // error!
-            break;
-        }
-
-        // set bit from high to low
-        // bytes[N - 1 - i] = b;
-        bytes[i] = b;
-    }
+    hex_decode(std::string_view(str).substr(0, std::min(N, str.length() / 2) * 2), bytes);
 }
 
 template <size_t N>
@@ -156,64 +115,14 @@ void operator>>(std::istringstream &&iss, std::array<uint8_t, N> &bytes)
     str >> bytes;
 }
 
-// template <size_t N>
-// std::istream &operator>>(std::istream &is, std::array<uint8_t, N> &bytes)
-// {
-//     std::string temp;
-
-//     is >> temp;
-
-//     size_t numbytes = temp.size() / 2;
-
-//     for (size_t i = 0, x = 0; i < numbytes && i < N; ++i, x += 2)
-//     {
-//         std::istringstream iss(temp.substr(x, 2));
-//         unsigned short b = 0;
-
-//         if (!(iss >> std::hex >> b))
-//         {
-//             // error!
-//             break;
-//         }
-
-//         // set from high to low bit
-//         //bytes[N - 1 - i] = b;
-//         bytes[i] = b;
-//     }
-
-//     return is;
-// }
-
-// template <size_t N>
-// std::istream &operator>>(std::istream &&is, std::array<uint8_t, N> &bytes)
-// {
-//     std::__rvalue_istream_type<std::istream> __ret_is = is;
-
-//     __ret_is >> bytes;
-
-//     return __ret_is;
-// }
-
-inline std::vector<uint8_t> hex_to_bytes(const std::string &str)
+inline std::vector<uint8_t> hex_to_bytes(std::string_view hex)
 {
-    std::vector<uint8_t> bytes;
-
-    auto beg = std::begin(str);
-    auto end = std::end(str);
-
-    if (*beg == '0' && *(beg + 1) == 'x')
-        beg += 2;
-
-    while (beg != end)
-    {
-        std::stringstream ss;
-        uint16_t byte = 0;
+    if (hex.starts_with("0x"))
+        hex.remove_prefix(2);
 
-        ss << *beg++ << *beg++; // read two chars
-        ss >> std::hex >> byte;
+    std::vector<uint8_t> bytes(hex.size() / 2);
 
-        bytes.push_back(byte);
-    }
+    hex_decode(hex, bytes);
 
     return bytes;
 }
@@ -223,35 +132,20 @@ inline std::array<uint8_t, N> hex_to_array_u8(std::string_view hex)
 {
     std::array<uint8_t, N> array_u8;
 
-    if (hex.size() < array_u8.size())
+    if (hex.size() < array_u8.size() * 2)
         std::__throw_runtime_error("hex_to_array_u8 error, the length of hex is less than the size of array");
 
-    for (size_t i = 0; i < array_u8.size(); i++)
-    {
-        std::stringstream ss;
-        uint16_t byte = 0;
-
-        ss << hex.at(i * 2) << hex.at(i * 2 + 1); // read two chars
-        ss >> std::hex >> byte;
-
-        array_u8[i] = byte;
-    }
+    hex_decode(hex.substr(0, array_u8.size() * 2), array_u8);
 
     return array_u8;
 }
 
-auto bytes_to_hex(const auto &bytes)
+std::string bytes_to_hex(const auto &bytes)
 {
-    using namespace std;
-    ostringstream oss;
+    static_assert(sizeof(*std::data(bytes)) == 1, "bytes_to_hex requires a container of bytes");
 
-    for (auto v : bytes)
-    {
-        oss << hex << setw(2) << setfill('0') << (int)v;
-    }
-
-    return oss.str();
-};
+    return hex_encode(std::span<const uint8_t>((const uint8_t *)std::data(bytes), std::size(bytes)));
+}
 
 std::string bytes_to_string(const auto &bytes)
 {
@@ -338,58 +232,3 @@ struct overloaded : Ts...
 template <class... Ts>
 overloaded(Ts...) -> overloaded<Ts...>;
 
-
-#if defined(__GNUC__) && !defined(__llvm__)
-#include <coroutine>
-//
-//  Task class for C++ 20 coroutine  
-//
-template <typename T>
-struct Task
-{
-    struct promise_type;
-    using co_handle = std::coroutine_handle<promise_type>;
-    co_handle _handle;
-
-    struct promise_type
-    {
-        T value;
-
-        Task get_return_object() { return Task{co_handle::from_promise(*this)}; }
-
-        std::suspend_never initial_suspend() { return {}; }
-
-        std::suspend_never final_suspend() { return {}; }
-
-        void unhandled_exception() { std::rethrow_exception(std::current_exception()); }
-
-        std::suspend_never return_value(T v)
-        {
-            value = v;
-            return {};
-        }
-    };
-
-    T get() { return _handle.promise().value; }
-
-    ~Task()
-    {
-        if (_handle)
-            _handle.destroy();
-    }
-};
-
-template <>
-struct Task<void>
-{
-    struct promise_type
-    {
-        Task<void> get_return_object() { return {}; }
-        std::suspend_never initial_suspend() { return {}; }
-        std::suspend_never final_suspend() noexcept { return {}; }
-        void return_void() {}
-        void unhandled_exception() { std::rethrow_exception(std::current_exception()); }
-    };
-};
-
-#endif
\ No newline at end of file
@@ -2,16 +2,21 @@
 #include <string_view>
 #include <memory>
 #include <tuple>
+#include <span>
+#include <algorithm>
+#include <mutex>
+#include <map>
+#include <typeindex>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
 #include <diem_types.hpp>
 #include <utils.hpp>
 #include <bcs_serde.hpp>
 #include <json_rpc.hpp>
+#include <co_helper.hpp>
 #include "wallet.hpp"
 
-#if defined(__GNUC__) && !defined(__llvm__)
-#include <coroutine>
-#endif
-
 namespace dt = diem_types;
 using ta = diem_types::TransactionArgument;
 
@@ -70,35 +75,302 @@ namespace violas
             return std::move(serializer).bytes();
         }
     };
+}
+
+template <>
+template <typename Serializer>
+void serde::Serializable<violas::ResourcePath>::serialize(const violas::ResourcePath &obj, Serializer &serializer)
+{
+    serializer.increase_container_depth();
+    serde::Serializable<decltype(obj.path)>::serialize(obj.path, serializer);
+    serializer.decrease_container_depth();
+}
 
+namespace violas
+{
+    /**
+     * @brief The resources of an account state blob, which are indexed and decoded on demand.
+     *
+     *  The blob is kept as it is. The index of resource paths to the BCS bytes in blob is built at the first lookup,
+     *  and a resource decoded as a type is memoized. The copies share the blob, the index and the decoded resources,
+     *  so a state served repeatedly, e.g. by the account state cache, decodes each resource once.
+     */
     class AccountState2
     {
-        std::map<std::vector<uint8_t>, std::vector<uint8_t>> _resources;
+        using Bytes = std::span<const uint8_t>;
+
+        struct Index
+        {
+            std::once_flag built;
+            // the paths and BCS bytes of resources in blob, sorted by path
+            std::vector<std::pair<Bytes, Bytes>> resources;
+
+            std::mutex mutex;
+            // the decoded resources by the position of their bytes in blob and the type decoded as
+            std::map<std::pair<const uint8_t *, std::type_index>, std::shared_ptr<const void>> decoded;
+            // the BCS bytes of the decoded resources, they are not memoized beyond the size of blob
+            size_t decoded_bytes = 0;
+        };
+
+        // the account state blob which is shared by the copies, the index refers to it
+        std::shared_ptr<const std::vector<uint8_t>> _blob;
+        std::shared_ptr<Index> _index;
+
+        // the BCS bytes of resource path of tag, which is valid until the next call on the same thread
+        static Bytes resource_path(const dt::StructTag &tag);
+        // the BCS bytes of resource at path, build the index if it is the first lookup
+        std::optional<Bytes> find(Bytes path) const;
 
     public:
         AccountState2(const std::string &hex);
-
+        // the bcs bytes of account state blob
+        AccountState2(std::vector<uint8_t> bytes);
+        //
+        //  Get a resource without copying it, nullptr if not found
+        //
         template <typename T>
-        std::optional<T> get_resource(dt::StructTag tag)
+        std::shared_ptr<const T> get_resource_ptr(const dt::StructTag &tag) const
         {
-            ResourcePath path{tag};
+            auto bytes = find(resource_path(tag));
+            if (!bytes)
+                return nullptr;
 
-            auto iter = _resources.find(path.bcsSerialize());
-            if (iter != end(_resources))
+            auto key = std::make_pair(bytes->data(), std::type_index(typeid(T)));
             {
-                T t;
+                std::lock_guard<std::mutex> lock(_index->mutex);
 
-                BcsSerde serde(iter->second);
+                auto iter = _index->decoded.find(key);
+                if (iter != end(_index->decoded))
+                    return std::static_pointer_cast<const T>(iter->second);
+            }
 
-                serde &&t;
+            auto t = std::make_shared<T>();
 
+            // deserialize the resource in blob without copying
+            BcsSerde bs(*bytes);
+
+            bs && *t;
+
+            std::lock_guard<std::mutex> lock(_index->mutex);
+
+            // keep the one decoded by another thread at the same time
+            auto iter = _index->decoded.find(key);
+            if (iter != end(_index->decoded))
+                return std::static_pointer_cast<const T>(iter->second);
+
+            // the memo is bounded, e.g. if a resource is decoded as many types
+            if (_index->decoded_bytes + bytes->size() > _blob->size())
                 return t;
-            }
+
+            _index->decoded_bytes += bytes->size();
+            _index->decoded.emplace(key, t);
+
+            return t;
+        }
+        //
+        //  The memory held by the state for the limit of caches, which counts the blob and its memoized resources
+        //  by their BCS bytes
+        //
+        size_t memory_bytes() const { return _blob->size() * 2; }
+
+        template <typename T>
+        std::optional<T> get_resource(const dt::StructTag &tag) const
+        {
+            if (auto t = get_resource_ptr<T>(tag))
+                return *t;
             else
                 return {};
         }
     };
 
+    //
+    //  A script transaction of bulk submission
+    //
+    struct ScriptTxn
+    {
+        size_t account_index;
+        std::vector<uint8_t> script_bytecode;
+        std::vector<diem_types::TypeTag> type_tags;
+        std::vector<diem_types::TransactionArgument> args;
+        uint64_t max_gas_amount = 1'000'000;
+        uint64_t gas_unit_price = 0;
+        std::string gas_currency_code = "VLS";
+        uint64_t expiration_timestamp_secs = 100;
+    };
+    //
+    //  The result of a transaction of bulk submission
+    //
+    struct SubmittedTxn
+    {
+        diem_types::AccountAddress sender;
+        uint64_t sequence_number = 0;
+        std::exception_ptr error; // nullptr if the transaction was accepted by the node
+    };
+
+    /**
+     * @brief The handle of a submitted transaction whose VM status is checked in the background,
+     *        the handles are copyable and share the result
+     */
+    class PendingTxn
+    {
+        //
+        //  Wakes up a wait_any, it is registered to the states being waited for
+        //
+        struct Waiter
+        {
+            std::mutex mutex;
+            std::condition_variable cv;
+            bool notified = false;
+        };
+
+        struct State
+        {
+            std::mutex mutex;
+            std::condition_variable cv;
+            bool done = false;
+            std::exception_ptr error;
+            std::vector<std::shared_ptr<Waiter>> waiters;
+        };
+
+        diem_types::AccountAddress _sender;
+        uint64_t _sequence_number;
+        std::shared_ptr<State> _state;
+
+        void wait() const
+        {
+            std::unique_lock<std::mutex> lock(_state->mutex);
+
+            _state->cv.wait(lock, [this]
+                            { return _state->done; });
+        }
+
+    public:
+        PendingTxn(const diem_types::AccountAddress &sender, uint64_t sequence_number)
+            : _sender(sender), _sequence_number(sequence_number), _state(std::make_shared<State>())
+        {
+        }
+
+        const diem_types::AccountAddress &sender() const { return _sender; }
+
+        uint64_t sequence_number() const { return _sequence_number; }
+
+        bool is_done() const
+        {
+            std::lock_guard<std::mutex> lock(_state->mutex);
+            return _state->done;
+        }
+        //
+        //  Wait until the VM status is checked, throw if it is not "executed"
+        //
+        void get() const
+        {
+            wait();
+
+            // the error is not changed after done
+            if (_state->error)
+                std::rethrow_exception(_state->error);
+        }
+        //
+        //  The callback which completes the handle, e.g. for Client2::async_check_txn_vm_status
+        //
+        std::function<void(std::exception_ptr)> completion() const
+        {
+            return [state = _state](std::exception_ptr e)
+            {
+                std::vector<std::shared_ptr<Waiter>> waiters;
+
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->done = true;
+                    state->error = e;
+                    waiters = std::move(state->waiters);
+                }
+
+                state->cv.notify_all();
+
+                for (auto &waiter : waiters)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(waiter->mutex);
+                        waiter->notified = true;
+                    }
+
+                    waiter->cv.notify_all();
+                }
+            };
+        }
+        //
+        //  Wait for all transactions, then throw the error of the first failed one in order
+        //
+        static void wait_all(const std::vector<PendingTxn> &txns)
+        {
+            for (auto &txn : txns)
+                txn.wait();
+
+            for (auto &txn : txns)
+            {
+                if (txn._state->error)
+                    std::rethrow_exception(txn._state->error);
+            }
+        }
+        //
+        //  Wait for any transaction and return the lowest index of the checked ones, call get() for its result.
+        //  Return txns.size() if txns is empty.
+        //
+        static size_t wait_any(const std::vector<PendingTxn> &txns)
+        {
+            auto first_done = [&]
+            {
+                return std::find_if(begin(txns), end(txns), [](const auto &txn)
+                                    { return txn.is_done(); }) -
+                       begin(txns);
+            };
+
+            auto waiter = std::make_shared<Waiter>();
+            bool done = false;
+
+            // register the waiter until a done one is found
+            for (size_t i = 0; i < txns.size() && !done; i++)
+            {
+                auto &state = *txns[i]._state;
+                std::lock_guard<std::mutex> lock(state.mutex);
+
+                if (state.done)
+                    done = true;
+                else
+                    state.waiters.push_back(waiter);
+            }
+
+            if (!done && !txns.empty())
+            {
+                std::unique_lock<std::mutex> lock(waiter->mutex);
+
+                waiter->cv.wait(lock, [&]
+                                { return waiter->notified; });
+            }
+
+            for (auto &txn : txns)
+            {
+                std::lock_guard<std::mutex> lock(txn._state->mutex);
+                std::erase(txn._state->waiters, waiter);
+            }
+
+            return first_done();
+        }
+    };
+
+    class StateProofVerifier;
+
+    struct AccountStateCacheOptions
+    {
+        // a cached state older than max_staleness is fetched again, zero disables the cache
+        std::chrono::milliseconds max_staleness{1000};
+        // the least recently used states are evicted beyond the number of accounts or the total size of blobs and
+        // their decoded resources
+        size_t max_entries = 1024;
+        size_t max_bytes = 16 << 20;
+    };
+
     class Client2 : public std::enable_shared_from_this<Client2>
     {
     public:
@@ -115,11 +387,20 @@ namespace violas
         virtual std::tuple<size_t, diem_types::AccountAddress>
         create_next_account(std::optional<diem_types::AccountAddress> opt_address = std::nullopt) = 0;
 
+        // Resynchronize the sequence number of account with chain before its next transaction
         virtual void
         update_account_info(size_t account_index) = 0;
 
         virtual std::vector<Wallet::Account>
         get_all_accounts() = 0;
+
+        // The address of account index, throw out_of_range if the account does not exist
+        virtual diem_types::AccountAddress
+        get_account_address(size_t account_index) = 0;
+
+        // Find the account index of address without scanning all accounts, return nullopt if the address is not in wallet
+        virtual std::optional<size_t>
+        find_account(const diem_types::AccountAddress &address) = 0;
         /**
          * @brief Submit a transaction  with script bytes and return the sequence number of account index
          *
@@ -153,60 +434,86 @@ namespace violas
                             std::string_view gas_currency_code = "VLS",
                             uint64_t expiration_timestamp_secs = 100) = 0;
 
-#if defined(__GNUC__) && !defined(__llvm__)
+        /**
+         * @brief Execute a script file on the executor without blocking the caller,
+         *        the asynchronous submissions are serialized to keep the sequence numbers in order
+         *
+         * @param callback  called with sender's address and sequence number, or an exception
+         */
         virtual void
         async_submit_script(size_t account_index,
                             std::string_view script_file_name,
                             std::vector<diem_types::TypeTag> type_tags,
                             std::vector<diem_types::TransactionArgument> args,
-                            uint64_t max_gas_amount = 1'000'000,
-                            uint64_t gas_unit_price = 0,
-                            std::string_view gas_currency_code = "VLS",
-                            uint64_t expiration_timestamp_secs = 100,
-                            std::function<void(diem_types::AccountAddress, uint64_t)> callback = nullptr) = 0;
-
+                            uint64_t max_gas_amount,
+                            uint64_t gas_unit_price,
+                            std::string_view gas_currency_code,
+                            uint64_t expiration_timestamp_secs,
+                            std::function<void(diem_types::AccountAddress, uint64_t, std::exception_ptr)> callback) = 0;
+        //
+        //  co_await await_execute_script to get the sender's address and sequence number
+        //
         auto await_execute_script(size_t account_index,
                                   std::string_view script_file_name,
-                                  std::vector<diem_types::TypeTag> &&type_tags,
-                                  std::vector<diem_types::TransactionArgument> &&args,
+                                  std::vector<diem_types::TypeTag> type_tags,
+                                  std::vector<diem_types::TransactionArgument> args,
                                   uint64_t max_gas_amount = 1'000'000,
                                   uint64_t gas_unit_price = 0,
                                   std::string_view gas_currency_code = "VLS",
-                                  uint64_t expiration_timestamp_secs = 100)
+                                  uint64_t expiration_timestamp_secs = 100,
+                                  CancellationToken token = {})
         {
-            struct awaitable
-            {
-                std::shared_ptr<Client2> _client;
-                size_t account_index;
-                std::string_view script_file_name;
-                std::vector<diem_types::TypeTag> type_tags;
-                std::vector<diem_types::TransactionArgument> args;
-                uint64_t max_gas_amount = 1'000'000;
-                uint64_t gas_unit_price = 0;
-                std::string_view gas_currency_code = "VLS";
-                uint64_t expiration_timestamp_secs = 100;
-
-                diem_types::AccountAddress _sender_address;
-                uint64_t _sequence_number;
-
-                bool await_ready() { return false; }
-                auto await_resume() { return std::make_tuple<>(_sender_address, _sequence_number); }
-                void await_suspend(std::coroutine_handle<> h)
+            using result_type = std::tuple<diem_types::AccountAddress, uint64_t>;
+
+            return CallbackAwaitable<result_type>(
+                [=, self = shared_from_this(),
+                 script_file_name = std::string(script_file_name),
+                 gas_currency_code = std::string(gas_currency_code)](std::function<void(result_type &&, std::exception_ptr)> callback)
                 {
-                    _client->async_submit_script(account_index, script_file_name, type_tags, args,
-                                                 max_gas_amount, gas_unit_price, gas_currency_code, expiration_timestamp_secs,
-                                                 [h, this](diem_types::AccountAddress address, uint64_t sn) mutable
-                                                 {
-                                                     this->_sender_address = address;
-                                                     this->_sequence_number = sn;
-                                                     h.resume();
-                                                 });
-                }
-            };
+                    self->async_submit_script(account_index, script_file_name, type_tags, args,
+                                              max_gas_amount, gas_unit_price, gas_currency_code, expiration_timestamp_secs,
+                                              [callback](diem_types::AccountAddress address, uint64_t sn, std::exception_ptr e)
+                                              { callback(std::make_tuple(address, sn), e); });
+                },
+                token);
+        }
+        /**
+         * @brief Submit script transactions in bulk without blocking, the transactions are built, signed and serialized
+         *        on the worker threads of executor, then submitted by the pipelined JSON-RPC client in the order of sequence numbers
+         *
+         * @param txns      the sequence numbers of each sender are reserved in the order of txns
+         * @param callback  called with the results in the order of txns
+         */
+        virtual void
+        async_submit_scripts(std::vector<ScriptTxn> txns,
+                             std::function<void(std::vector<SubmittedTxn> &&)> callback) = 0;
+        //
+        //  Submit script transactions in bulk and wait for the results
+        //
+        std::vector<SubmittedTxn>
+        submit_scripts(std::vector<ScriptTxn> txns)
+        {
+            auto promise = std::make_shared<std::promise<std::vector<SubmittedTxn>>>();
+            auto future = promise->get_future();
+
+            async_submit_scripts(std::move(txns), [promise](std::vector<SubmittedTxn> &&results)
+                                 { promise->set_value(std::move(results)); });
 
-            return awaitable{shared_from_this(), account_index, script_file_name, std::move(type_tags), std::move(args)};
+            return future.get();
+        }
+
+        auto await_submit_scripts(std::vector<ScriptTxn> txns, CancellationToken token = {})
+        {
+            using callback_type = CallbackAwaitable<std::vector<SubmittedTxn>>::callback_type;
+
+            return CallbackAwaitable<std::vector<SubmittedTxn>>(
+                [self = shared_from_this(), txns = std::move(txns)](callback_type callback)
+                {
+                    self->async_submit_scripts(txns, [callback](std::vector<SubmittedTxn> &&results)
+                                               { callback(std::move(results), nullptr); });
+                },
+                token);
         }
-#endif
         /**
          * @brief Sign a multi agent script bytes code and return a signed txn which contains sender authenticator and no secondary signature
          *
@@ -242,7 +549,7 @@ namespace violas
         sign_and_submit_multi_agent_signed_txn(size_t account_index,
                                                diem_types::SignedTransaction &&txn) = 0;
         /**
-         * @brief Check the VM status of transaction, if the VM status is not "executed" it throw a exception with error info
+         * @brief Check the VM status of transaction, if the VM status is not "executed" it throw a exception with error info.
          *
          * @param address           account address
          * @param sequence_number   the sequence number, both of them indicated a transaction sent by an account
@@ -253,33 +560,99 @@ namespace violas
                             uint64_t sequence_number,
                             std::string_view error_info) = 0;
 
+        /**
+         * @brief Check the VM status of transaction without blocking, the transaction is polled by asynchronous
+         *        JSON-RPC requests and the executor's timer instead of a sleeping thread
+         *
+         * @param callback  called with nullptr if vm status is "executed", otherwise with an exception
+         */
         virtual void
         async_check_txn_vm_status(const diem_types::AccountAddress &address,
                                   uint64_t sequence_number,
-                                  std::function<void()> callback) = 0;
+                                  std::string_view error_info,
+                                  std::function<void(std::exception_ptr)> callback) = 0;
+
+        /**
+         * @brief Wait for a transaction to be executed without blocking, the pending transactions of all callers are
+         *        queried together in JSON-RPC batches with a backoff adapted to the observed commit latency
+         *
+         * @param address           account address
+         * @param sequence_number   the sequence number of transaction
+         * @param callback          called with the VM status once executed, otherwise with an exception of timeout
+         *                          or transport error, which doesn't mean the transaction was dropped, so its sequence
+         *                          number is not reused until the transaction expires
+         */
+        virtual void
+        async_confirm_txn(const diem_types::AccountAddress &address,
+                          uint64_t sequence_number,
+                          std::function<void(json_rpc::VMStatus &&, std::exception_ptr)> callback) = 0;
+
+        std::future<json_rpc::VMStatus>
+        confirm_txn(const diem_types::AccountAddress &address, uint64_t sequence_number)
+        {
+            auto promise = std::make_shared<std::promise<json_rpc::VMStatus>>();
+            auto future = promise->get_future();
+
+            async_confirm_txn(address, sequence_number, [promise](json_rpc::VMStatus &&status, std::exception_ptr e)
+                              {
+                                  if (e)
+                                      promise->set_exception(e);
+                                  else
+                                      promise->set_value(std::move(status)); });
+
+            return future;
+        }
+
+        auto await_confirm_txn(const diem_types::AccountAddress &address,
+                               uint64_t sequence_number,
+                               CancellationToken token = {})
+        {
+            return CallbackAwaitable<json_rpc::VMStatus>(
+                [self = shared_from_this(), address, sequence_number](std::function<void(json_rpc::VMStatus &&, std::exception_ptr)> callback)
+                { self->async_confirm_txn(address, sequence_number, callback); },
+                token);
+        }
+
+        /**
+         * @brief Check the VM status of transaction in the background and return a handle of it
+         *
+         * @return PendingTxn   wait it by get(), PendingTxn::wait_all or PendingTxn::wait_any
+         */
+        PendingTxn watch_txn(const diem_types::AccountAddress &address,
+                             uint64_t sequence_number,
+                             std::string_view error_info)
+        {
+            PendingTxn txn(address, sequence_number);
+
+            async_check_txn_vm_status(address, sequence_number, error_info, txn.completion());
+
+            return txn;
+        }
 
-#if defined(__GNUC__) && !defined(__llvm__)
         auto await_check_txn_vm_status(const diem_types::AccountAddress &address,
                                        uint64_t sequence_number,
-                                       std::string_view error_info)
+                                       std::string_view error_info,
+                                       CancellationToken token = {})
         {
-            struct awaitable
-            {
-                const diem_types::AccountAddress &address;
-                uint64_t sequence_number;
+            return CallbackAwaitable<void>(
+                [self = shared_from_this(), address, sequence_number, error_info = std::string(error_info)](std::function<void(std::exception_ptr)> callback)
+                { self->async_check_txn_vm_status(address, sequence_number, error_info, callback); },
+                token);
+        }
+        //
+        //  Run any synchronous operation of Client2 on the executor and co_await its result, e.g.
+        //      auto state = co_await client->co_run([=](Client2 &c) { return c.get_account_state(address); });
+        //
+        template <typename F>
+        Task<std::invoke_result_t<F, Client2 &>>
+        co_run(F f, CancellationToken token = {}, Executor &executor = Executor::default_executor())
+        {
+            auto self = shared_from_this();
 
-                bool await_ready() { return false; }
-                void await_suspend(std::coroutine_handle<> h)
-                {
-                    // std::jthread([h]
-                    //              { h.resume(); });
-                }
-                void await_resume() {}
-            };
+            co_await executor.schedule(token);
 
-            return awaitable{address, sequence_number};
+            co_return f(*self);
         }
-#endif
         virtual void
         publish_module(size_t account_index,
                        std::vector<uint8_t> &&module_bytes_code) = 0;
@@ -287,23 +660,98 @@ namespace violas
         virtual void
         publish_module(size_t account_index,
                        std::string_view module_file_name) = 0;
+        //
+        //  The _pending methods return once the transaction is submitted, the VM status is checked in the background
+        //  and waited by PendingTxn::get, wait_all or wait_any. The transactions depending on the execution of
+        //  others, e.g. sent by an account being created, must be submitted after the wait.
+        //      std::vector<PendingTxn> txns;
+        //      for (auto module : modules)
+        //          txns.push_back(client->publish_module_pending(ACCOUNT_ROOT_ID, module));
+        //      PendingTxn::wait_all(txns);  // throw the first failure
+        //
+        virtual PendingTxn
+        publish_module_pending(size_t account_index,
+                               std::vector<uint8_t> &&module_bytes_code) = 0;
+
+        virtual PendingTxn
+        publish_module_pending(size_t account_index,
+                               std::string_view module_file_name) = 0;
 
+        /**
+         * @brief Get the state of an account, it may be served by the cache of account states
+         *
+         *  The state of an account touched by a transaction of this client is fetched again after submitting,
+         *  and a state read before a transaction confirmed by this client is never returned after it.
+         */
         virtual std::optional<AccountState2>
         get_account_state(const dt::AccountAddress address) = 0;
+        //
+        //  Configure the cache of account states, set max_staleness to zero to disable it
+        //
+        virtual void
+        set_account_state_cache_options(const AccountStateCacheOptions &options) = 0;
+        //
+        //  Drop the cached state of an account, e.g. after it was changed by another client
+        //
+        virtual void
+        invalidate_account_state(const dt::AccountAddress &address) = 0;
+        /**
+         * @brief Get the state of an account at the latest ledger version trusted by verifier and verify its proof,
+         *        so that it can be read from an untrusted full node. The state is not cached.
+         *
+         * @param address   the address of account
+         * @param verifier  the verifier with the trusted root hashes of transaction accumulator
+         * @return std::optional<AccountState2> nullopt if the account doesn't exist, throw if the proof is invalid
+         */
+        virtual std::optional<AccountState2>
+        get_verified_account_state(const dt::AccountAddress &address, StateProofVerifier &verifier) = 0;
+        /**
+         * @brief Get the states of multiple accounts with one JSON-RPC batch request
+         *
+         * @param addresses
+         * @return std::vector<std::optional<AccountState2>> in the same order as addresses
+         */
+        virtual std::vector<std::optional<AccountState2>>
+        get_account_states(const std::vector<dt::AccountAddress> &addresses) = 0;
 
         virtual std::vector<json_rpc::EventView>
         get_events(EventHandle handle, uint64_t start, uint64_t limit) = 0;
+        /**
+         * @brief Get the events of multiple event handles with one JSON-RPC batch request
+         *
+         * @param handles
+         * @param start
+         * @param limit
+         * @return std::vector<std::vector<json_rpc::EventView>> in the same order as handles
+         */
+        virtual std::vector<std::vector<json_rpc::EventView>>
+        get_events(const std::vector<EventHandle> &handles, uint64_t start, uint64_t limit) = 0;
 
         template <typename T>
         std::vector<T> query_events(EventHandle handle, uint64_t start, uint64_t limit)
+        {
+            return decode_events<T>(this->get_events(handle, start, limit));
+        }
+
+        template <typename T>
+        std::vector<std::vector<T>> query_events(const std::vector<EventHandle> &handles, uint64_t start, uint64_t limit)
+        {
+            std::vector<std::vector<T>> events;
+
+            for (auto &views : this->get_events(handles, start, limit))
+                events.push_back(decode_events<T>(views));
+
+            return events;
+        }
+
+        template <typename T>
+        static std::vector<T> decode_events(const std::vector<json_rpc::EventView> &views)
         {
             std::vector<T> events;
 
-            for (auto &e : this->get_events(handle, start, limit))
+            for (auto &e : views)
             {
-                auto unknow_event = std::get<json_rpc::UnknownEvent>(e.event);
-
-                BcsSerde serde(std::get<json_rpc::UnknownEvent>(e.event).bytes);
+                BcsSerde serde(std::span<const uint8_t>(std::get<json_rpc::UnknownEvent>(e.event).bytes));
                 T event;
 
                 serde &&event;
@@ -322,6 +770,9 @@ namespace violas
         virtual void
         add_currency(size_t account_index, std::string_view currency_code) = 0;
 
+        virtual PendingTxn
+        add_currency_pending(size_t account_index, std::string_view currency_code) = 0;
+
         virtual void
         allow_custom_script(bool is_allowing) = 0;
 
@@ -334,6 +785,12 @@ namespace violas
                                    std::string_view human_name,
                                    bool add_all_currencies = false) = 0;
 
+        virtual PendingTxn
+        create_parent_vasp_account_pending(const diem_types::AccountAddress &address,
+                                           const std::array<uint8_t, 32> &auth_key,
+                                           std::string_view human_name,
+                                           bool add_all_currencies = false) = 0;
+
         virtual void
         create_child_vasp_account(size_t account_index,
                                   const diem_types::AccountAddress &address,
@@ -342,6 +799,14 @@ namespace violas
                                   uint64_t child_initial_balance,
                                   bool add_all_currencies = false) = 0;
 
+        virtual PendingTxn
+        create_child_vasp_account_pending(size_t account_index,
+                                          const diem_types::AccountAddress &address,
+                                          const std::array<uint8_t, 32> &auth_key,
+                                          std::string_view currency,
+                                          uint64_t child_initial_balance,
+                                          bool add_all_currencies = false) = 0;
+
         virtual void
         create_designated_dealer_ex(std::string_view currency_code,
                                     uint64_t sliding_nonce,
@@ -349,6 +814,14 @@ namespace violas
                                     const std::array<uint8_t, 32> &auth_key,
                                     std::string_view human_name,
                                     bool add_all_currencies) = 0;
+
+        virtual PendingTxn
+        create_designated_dealer_ex_pending(std::string_view currency_code,
+                                            uint64_t sliding_nonce,
+                                            const diem_types::AccountAddress &address,
+                                            const std::array<uint8_t, 32> &auth_key,
+                                            std::string_view human_name,
+                                            bool add_all_currencies) = 0;
         /**
          * @brief Registers a stable currency coin
          *
@@ -388,6 +861,13 @@ namespace violas
              uint64_t amount,
              diem_types::AccountAddress dd_address,
              uint64_t tier_index) = 0;
+
+        virtual PendingTxn
+        mint_pending(std::string_view currency_code,
+                     uint64_t sliding_nonce,
+                     uint64_t amount,
+                     diem_types::AccountAddress dd_address,
+                     uint64_t tier_index) = 0;
     };
 
     using client2_ptr = std::shared_ptr<Client2>;
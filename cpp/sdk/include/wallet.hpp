@@ -2,14 +2,40 @@
 
 #include <vector>
 #include <tuple>
+#include <span>
+#include <cstring>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
 #include <diem_types.hpp>
 #include "ed25519.hpp"
 
 namespace violas
 {
-    std::array<uint8_t, 32> sha_256(uint8_t *data, size_t len);
-    std::array<uint8_t, 64> sha_512(uint8_t *data, size_t len);
-    std::array<uint8_t, 32> sha3_256(uint8_t *data, size_t len);
+    // the hash functions reuse a digest context of current thread
+    std::array<uint8_t, 32> sha_256(const uint8_t *data, size_t len);
+    std::array<uint8_t, 64> sha_512(const uint8_t *data, size_t len);
+    std::array<uint8_t, 32> sha3_256(const uint8_t *data, size_t len);
+    //
+    //  Streaming SHA3-256 hasher, it can be reused after finalize
+    //
+    class Sha3Hasher
+    {
+        EVP_MD_CTX *m_context;
+
+    public:
+        Sha3Hasher();
+        ~Sha3Hasher();
+
+        Sha3Hasher(const Sha3Hasher &) = delete;
+        Sha3Hasher &operator=(const Sha3Hasher &) = delete;
+
+        Sha3Hasher &update(const uint8_t *data, size_t len);
+
+        Sha3Hasher &update(std::span<const uint8_t> bytes) { return update(bytes.data(), bytes.size()); }
+
+        std::array<uint8_t, 32> finalize();
+    };
     
     class Wallet
     {
@@ -17,6 +43,28 @@ namespace violas
         // using Entropy = std::array<uint8_t, 33>;
         using Key = std::array<uint8_t, 32>;
 
+        struct Account
+        {
+            size_t index;
+            diem_types::AccountAddress address;
+            std::array<uint8_t, 32> auth_key;
+            crypto::ed25519::RawKey public_key;
+        };
+
+        //
+        //  The hash of address or auth key, their bytes are the output of sha3 already
+        //
+        struct BytesHash
+        {
+            template <size_t N>
+            size_t operator()(const std::array<uint8_t, N> &bytes) const
+            {
+                size_t hash;
+                std::memcpy(&hash, bytes.data(), sizeof(hash));
+                return hash;
+            }
+        };
+
     private:
         // 32 bytes entropy + 1 byte hash
         std::array<uint8_t, 33> m_entropy_hash;
@@ -29,14 +77,23 @@ namespace violas
 
         void extract_main_key();
 
-        Key extend_child_private_key(uint64_t index);
+        Key extend_child_private_key(uint64_t index) const;
 
+        // the derived accounts, the account at position i has index i
         std::vector<crypto::ed25519::PrivateKey> m_private_keys;
+        std::vector<Account> m_accounts;
+        std::unordered_map<std::array<uint8_t, 16>, size_t, BytesHash> m_address_indices;
+        std::unordered_map<Key, size_t, BytesHash> m_auth_key_indices;
+        mutable std::shared_mutex m_mutex;
+
+        // the caller must hold the unique lock
+        void add_account(crypto::ed25519::PrivateKey &&priv_key, Account &&account);
 
         Wallet();
 
     public:
         Wallet(Key &&entropy);
+        Wallet(Wallet &&wallet);
         ~Wallet();
 
         static Wallet generate_from_random();
@@ -51,21 +108,33 @@ namespace violas
 
         // return account index and raw public key
         std::tuple<size_t, diem_types::AccountAddress> create_next_account();
+        /**
+         * @brief Derive the accounts in range [first, last) with multiple threads,
+         *        the accounts not derived yet below first are derived as well
+         *
+         * @param first the index of first account
+         * @param last the index after the last account
+         * @param thread_count the number of threads, 0 for hardware concurrency
+         * @return std::vector<Account> the accounts in range [first, last)
+         */
+        std::vector<Account> derive_accounts(size_t first, size_t last, size_t thread_count = 0);
 
-        struct Account
-        {
-            size_t index;
-            diem_types::AccountAddress address;
-            std::array<uint8_t, 32> auth_key;
-        };
+        size_t account_count() const;
+
+        // the cached account, throw out_of_range if the account was not derived
+        Account get_account(size_t index) const;
+
+        std::vector<Account> get_all_accounts() const;
 
-        std::vector<Account> get_all_accounts();
+        // find the account by address or auth key in constant time
+        std::optional<Account> find_account(const diem_types::AccountAddress &address) const;
+        std::optional<Account> find_account(const Key &auth_key) const;
 
         std::array<uint8_t, 16>
-        get_account_address(size_t index);
+        get_account_address(size_t index) const;
 
         crypto::ed25519::PrivateKey
-        get_account_priv_key(size_t index);
+        get_account_priv_key(size_t index) const;
 
         static void run_test_case();
     };
@@ -0,0 +1,191 @@
+#include "account_state_cache.hpp"
+
+using namespace std;
+using namespace std::chrono;
+
+namespace violas
+{
+    AccountStateCache::AccountStateCache(fetcher fetch, AccountStateCacheOptions options)
+        : _fetch(move(fetch)), _options(options)
+    {
+    }
+
+    optional<AccountState2> AccountStateCache::get(const diem_types::AccountAddress &address)
+    {
+        const Key &key = address.value;
+        auto flight = make_shared<Flight>();
+        promise<optional<AccountState2>> result;
+        shared_future<optional<AccountState2>> other;
+
+        {
+            lock_guard<mutex> lock(_mutex);
+
+            if (auto entry = find_fresh(key))
+                return entry->state;
+
+            auto [iter, is_new] = _flights.try_emplace(key, flight);
+            if (is_new)
+                flight->result = result.get_future().share();
+            else
+                other = iter->second->result;
+        }
+
+        // another thread is fetching the same account
+        if (other.valid())
+            return other.get();
+
+        Fetched fetched;
+
+        try
+        {
+            fetched = _fetch(address);
+        }
+        catch (...)
+        {
+            {
+                lock_guard<mutex> lock(_mutex);
+
+                auto iter = _flights.find(key);
+                if (iter != end(_flights) && iter->second == flight)
+                    _flights.erase(iter);
+            }
+
+            result.set_exception(current_exception());
+            throw;
+        }
+
+        auto state = fetched.state;
+
+        {
+            lock_guard<mutex> lock(_mutex);
+
+            // the result is dropped if the account was invalidated while fetching
+            auto iter = _flights.find(key);
+            if (iter != end(_flights) && iter->second == flight)
+            {
+                _flights.erase(iter);
+                store(key, move(fetched));
+            }
+        }
+
+        result.set_value(state);
+
+        return state;
+    }
+
+    optional<optional<AccountState2>> AccountStateCache::find(const diem_types::AccountAddress &address)
+    {
+        lock_guard<mutex> lock(_mutex);
+
+        if (auto entry = find_fresh(address.value))
+            return entry->state;
+
+        return nullopt;
+    }
+
+    void AccountStateCache::put(const diem_types::AccountAddress &address, Fetched &&fetched)
+    {
+        lock_guard<mutex> lock(_mutex);
+
+        // a fetch in flight may have read an older version
+        _flights.erase(address.value);
+
+        store(address.value, move(fetched));
+    }
+
+    void AccountStateCache::invalidate(const diem_types::AccountAddress &address)
+    {
+        lock_guard<mutex> lock(_mutex);
+
+        _flights.erase(address.value);
+
+        auto iter = _entries.find(address.value);
+        if (iter != end(_entries))
+            erase(iter);
+    }
+
+    void AccountStateCache::advance(uint64_t version)
+    {
+        lock_guard<mutex> lock(_mutex);
+
+        // the stale entries are dropped lazily by find_fresh or evict
+        _min_version = max(_min_version, version);
+    }
+
+    void AccountStateCache::set_options(const AccountStateCacheOptions &options)
+    {
+        lock_guard<mutex> lock(_mutex);
+
+        _options = options;
+
+        if (_options.max_staleness <= milliseconds(0))
+        {
+            _entries.clear();
+            _lru.clear();
+            _bytes = 0;
+        }
+        else
+            evict();
+    }
+
+    size_t AccountStateCache::size()
+    {
+        lock_guard<mutex> lock(_mutex);
+
+        return _entries.size();
+    }
+
+    AccountStateCache::Entry *AccountStateCache::find_fresh(const Key &key)
+    {
+        auto iter = _entries.find(key);
+        if (iter == end(_entries))
+            return nullptr;
+
+        auto &entry = iter->second;
+
+        if (entry.version < _min_version || clock::now() - entry.fetched > _options.max_staleness)
+        {
+            erase(iter);
+            return nullptr;
+        }
+
+        _lru.splice(begin(_lru), _lru, entry.lru);
+
+        return &entry;
+    }
+
+    void AccountStateCache::store(const Key &key, Fetched &&fetched)
+    {
+        if (_options.max_staleness <= milliseconds(0) || fetched.version < _min_version)
+            return;
+
+        auto iter = _entries.find(key);
+        if (iter != end(_entries))
+        {
+            // keep the newer one if the fetches were out of order
+            if (iter->second.version > fetched.version)
+                return;
+
+            erase(iter);
+        }
+
+        _lru.push_front(key);
+        _bytes += fetched.bytes;
+        _entries.emplace(key, Entry{fetched.version, move(fetched.state), fetched.bytes, clock::now(), begin(_lru)});
+
+        evict();
+    }
+
+    void AccountStateCache::erase(map<Key, Entry>::iterator iter)
+    {
+        _bytes -= iter->second.bytes;
+        _lru.erase(iter->second.lru);
+        _entries.erase(iter);
+    }
+
+    void AccountStateCache::evict()
+    {
+        while (!_lru.empty() && (_entries.size() > _options.max_entries || _bytes > _options.max_bytes))
+            erase(_entries.find(_lru.back()));
+    }
+}
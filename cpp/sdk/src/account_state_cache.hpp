@@ -0,0 +1,105 @@
+#pragma once
+#include <cstdint>
+#include <array>
+#include <map>
+#include <list>
+#include <tuple>
+#include <memory>
+#include <mutex>
+#include <future>
+#include <chrono>
+#include <optional>
+#include <functional>
+#include <diem_types.hpp>
+#include "../include/violas_client2.hpp"
+
+namespace violas
+{
+    /**
+     * @brief Thread safe cache of account states which are tagged by the ledger version they were read at.
+     *
+     *  An entry is fresh if it is younger than max_staleness and not older than the version floor. The floor is
+     *  raised to the version of each transaction confirmed by this client, so that a state read before a
+     *  transaction of this client is never returned after it. The accounts touched by a transaction are invalidated
+     *  when it is submitted. The concurrent gets of the same account share one fetch, and the least recently used
+     *  entries are evicted beyond max_entries or max_bytes of states, see AccountState2::memory_bytes.
+     */
+    class AccountStateCache
+    {
+    public:
+        struct Fetched
+        {
+            uint64_t version;
+            std::optional<AccountState2> state;
+            // the memory of state, for the memory limit
+            size_t bytes;
+        };
+        // fetch the state of an account from the chain
+        using fetcher = std::function<Fetched(const diem_types::AccountAddress &)>;
+
+        explicit AccountStateCache(fetcher fetch, AccountStateCacheOptions options = {});
+        //
+        //  Get the state from cache if it is fresh, otherwise fetch it, or wait for the fetch of another thread
+        //
+        std::optional<AccountState2> get(const diem_types::AccountAddress &address);
+        //
+        //  Find a fresh state without fetching, the outer optional is empty for a miss
+        //
+        std::optional<std::optional<AccountState2>> find(const diem_types::AccountAddress &address);
+        //
+        //  Store a state fetched by the caller, e.g. with a batch request
+        //
+        void put(const diem_types::AccountAddress &address, Fetched &&fetched);
+        //
+        //  Drop the state of an account, the result of a fetch in flight is not stored either
+        //
+        void invalidate(const diem_types::AccountAddress &address);
+        //
+        //  A transaction was executed at version, the states read before it are stale
+        //
+        void advance(uint64_t version);
+
+        void set_options(const AccountStateCacheOptions &options);
+
+        size_t size();
+
+    private:
+        using clock = std::chrono::steady_clock;
+        using Key = std::array<uint8_t, 16>;
+
+        struct Entry
+        {
+            uint64_t version;
+            std::optional<AccountState2> state;
+            size_t bytes;
+            clock::time_point fetched;
+            std::list<Key>::iterator lru;
+        };
+
+        struct Flight
+        {
+            std::shared_future<std::optional<AccountState2>> result;
+        };
+
+        fetcher _fetch;
+
+        std::mutex _mutex;
+        AccountStateCacheOptions _options;
+        std::map<Key, Entry> _entries;
+        // the keys of entries from the most to the least recently used
+        std::list<Key> _lru;
+        size_t _bytes = 0;
+        // the states older than this version are stale
+        uint64_t _min_version = 0;
+        std::map<Key, std::shared_ptr<Flight>> _flights;
+
+        // the caller must hold the lock
+        Entry *find_fresh(const Key &key);
+
+        void store(const Key &key, Fetched &&fetched);
+
+        void erase(std::map<Key, Entry>::iterator iter);
+
+        void evict();
+    };
+}
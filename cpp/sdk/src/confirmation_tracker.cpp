@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <stdexcept>
+#include "confirmation_tracker.hpp"
+
+using namespace std;
+using namespace std::chrono;
+
+namespace violas
+{
+    ConfirmationTracker::ConfirmationTracker(json_rpc::client_ptr client, ConfirmationOptions options, Executor &executor)
+        : _client(move(client)), _options(options), _executor(executor), _latency(options.initial_latency)
+    {
+    }
+
+    void ConfirmationTracker::watch(const diem_types::AccountAddress &sender, uint64_t sequence_number, Callback callback)
+    {
+        lock_guard<mutex> lock(_mutex);
+
+        auto [iter, is_new] = _entries.try_emplace(Key{sender.value, sequence_number});
+        auto &entry = iter->second;
+
+        if (is_new)
+        {
+            auto now = clock::now();
+
+            entry.watched = now;
+            entry.deadline = now + _options.timeout;
+            // poll a little earlier than the expected commit, a miss costs one more query only
+            entry.next_poll = now + duration_cast<clock::duration>(_latency * 3 / 4);
+            entry.backoff = _options.min_interval;
+        }
+
+        entry.callbacks.push_back(move(callback));
+
+        schedule();
+    }
+
+    size_t ConfirmationTracker::pending()
+    {
+        lock_guard<mutex> lock(_mutex);
+
+        return _entries.size();
+    }
+
+    milliseconds ConfirmationTracker::latency()
+    {
+        lock_guard<mutex> lock(_mutex);
+
+        return duration_cast<milliseconds>(_latency);
+    }
+
+    void ConfirmationTracker::schedule()
+    {
+        auto earliest = clock::time_point::max();
+
+        for (auto &[key, entry] : _entries)
+        {
+            if (!entry.polling)
+                earliest = min(earliest, entry.next_poll);
+        }
+
+        // a timer armed earlier will poll and schedule again
+        if (earliest == clock::time_point::max() || earliest >= _timer)
+            return;
+
+        _timer = earliest;
+
+        auto delay = duration_cast<milliseconds>(earliest - clock::now());
+
+        _executor.post_after(max(delay, milliseconds(0)), [self = shared_from_this()]
+                             { self->poll(); });
+    }
+
+    void ConfirmationTracker::poll()
+    {
+        vector<vector<Key>> batches;
+
+        {
+            lock_guard<mutex> lock(_mutex);
+
+            _timer = clock::time_point::max();
+
+            // the entries due soon are queried together with the due ones
+            auto now = clock::now();
+            auto horizon = now + _options.min_interval / 2;
+
+            for (auto &[key, entry] : _entries)
+            {
+                if (entry.polling || entry.next_poll > horizon)
+                    continue;
+
+                if (batches.empty() || batches.back().size() >= _options.max_batch_size)
+                    batches.emplace_back();
+
+                batches.back().push_back(key);
+                entry.polling = true;
+            }
+
+            schedule();
+        }
+
+        auto self = shared_from_this();
+
+        for (auto &keys : batches)
+        {
+            vector<json_rpc::Request> requests;
+            requests.reserve(keys.size());
+
+            for (auto &[address, sequence_number] : keys)
+                requests.push_back(json_rpc::method::GetAccountTransaction{diem_types::AccountAddress{address}, sequence_number, false});
+
+            _client->async_batch(requests,
+                                 [self, keys = move(keys)](vector<json_rpc::Response> &&responses, exception_ptr e) mutable
+                                 { self->complete(move(keys), move(responses), e); });
+        }
+    }
+
+    void ConfirmationTracker::complete(vector<Key> &&keys, vector<json_rpc::Response> &&responses, exception_ptr e)
+    {
+        vector<tuple<vector<Callback>, json_rpc::TransactionView, exception_ptr>> results;
+
+        {
+            lock_guard<mutex> lock(_mutex);
+
+            auto now = clock::now();
+            size_t confirmed = 0;
+            vector<Entry *> missed;
+
+            for (size_t i = 0; i < keys.size(); i++)
+            {
+                auto iter = _entries.find(keys[i]);
+                if (iter == end(_entries))
+                    continue;
+
+                auto &entry = iter->second;
+                optional<json_rpc::TransactionView> opt_txn_view;
+
+                entry.polling = false;
+
+                if (!e && i < responses.size())
+                    opt_txn_view = get<optional<json_rpc::TransactionView>>(move(responses[i]));
+
+                if (opt_txn_view.has_value())
+                {
+                    // EWMA with weight 1/8 for the latency of this transaction
+                    auto latency = duration_cast<microseconds>(now - entry.watched);
+                    _latency += (latency - _latency) / 8;
+
+                    results.emplace_back(move(entry.callbacks), move(*opt_txn_view), nullptr);
+                    _entries.erase(iter);
+                    confirmed++;
+                }
+                else if (now >= entry.deadline)
+                {
+                    // report the transport error if it is the last one
+                    auto error = e ? e : make_exception_ptr(runtime_error("check_txn_vm_status is timeout."));
+
+                    results.emplace_back(move(entry.callbacks), json_rpc::TransactionView{}, error);
+                    _entries.erase(iter);
+                }
+                else
+                    missed.push_back(&entry);
+            }
+
+            for (auto entry : missed)
+            {
+                // the chain is committing the transactions of this batch, the rest are likely to follow soon
+                if (confirmed > 0)
+                    entry->backoff = _options.min_interval;
+
+                entry->next_poll = min(now + entry->backoff, entry->deadline);
+                entry->backoff = min(entry->backoff * 2, _options.max_interval);
+            }
+
+            schedule();
+        }
+
+        for (auto &[callbacks, txn_view, error] : results)
+        {
+            for (auto &callback : callbacks)
+                callback(json_rpc::TransactionView(txn_view), error);
+        }
+    }
+}
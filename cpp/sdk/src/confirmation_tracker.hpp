@@ -0,0 +1,95 @@
+#pragma once
+#include <cstdint>
+#include <array>
+#include <map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <functional>
+#include <diem_types.hpp>
+#include <json_rpc.hpp>
+#include <co_helper.hpp>
+
+namespace violas
+{
+    struct ConfirmationOptions
+    {
+        // the commit latency assumed before any transaction is confirmed
+        std::chrono::milliseconds initial_latency{500};
+        // the backoff of a transaction which is not found starts from min_interval and is limited by max_interval
+        std::chrono::milliseconds min_interval{50};
+        std::chrono::milliseconds max_interval{1000};
+        // a transaction not found within the timeout fails
+        std::chrono::milliseconds timeout{5000};
+        // the number of requests in one JSON-RPC batch
+        size_t max_batch_size = 100;
+    };
+
+    /**
+     * @brief Wait for many transactions to be executed with shared polling instead of a sleeping thread for each one.
+     *
+     *  The pending (sender, sequence number) pairs are queried together in JSON-RPC batches of get_account_transaction.
+     *  The first query of a transaction is delayed by the commit latency observed so far. A transaction still not
+     *  found is queried again with an exponential backoff, which restarts from min_interval while the other
+     *  transactions of its batch are being confirmed. It fails once its timeout has passed.
+     */
+    class ConfirmationTracker : public std::enable_shared_from_this<ConfirmationTracker>
+    {
+    public:
+        // called with the transaction once executed, otherwise with an exception of timeout or transport error
+        using Callback = std::function<void(json_rpc::TransactionView &&, std::exception_ptr)>;
+
+        ConfirmationTracker(json_rpc::client_ptr client,
+                            ConfirmationOptions options = {},
+                            Executor &executor = Executor::default_executor());
+
+        /**
+         * @brief Watch a transaction until it is executed or timeout
+         *
+         * @param sender            the address of sender
+         * @param sequence_number   the sequence number of transaction
+         * @param callback          called on a thread of executor or http client
+         */
+        void watch(const diem_types::AccountAddress &sender, uint64_t sequence_number, Callback callback);
+        //
+        //  The number of transactions being watched
+        //
+        size_t pending();
+        //
+        //  The EWMA of latency from watch to executed
+        //
+        std::chrono::milliseconds latency();
+
+    private:
+        using clock = std::chrono::steady_clock;
+        using Key = std::tuple<std::array<uint8_t, 16>, uint64_t>;
+
+        struct Entry
+        {
+            clock::time_point watched;
+            clock::time_point deadline;
+            clock::time_point next_poll;
+            std::chrono::milliseconds backoff;
+            bool polling = false;
+            std::vector<Callback> callbacks;
+        };
+
+        json_rpc::client_ptr _client;
+        ConfirmationOptions _options;
+        Executor &_executor;
+
+        std::mutex _mutex;
+        std::map<Key, Entry> _entries;
+        std::chrono::microseconds _latency;
+        // the time of the earliest timer armed, time_point::max() if none
+        clock::time_point _timer = clock::time_point::max();
+
+        // arm a timer for the earliest poll, the caller must hold the lock
+        void schedule();
+
+        void poll();
+
+        void complete(std::vector<Key> &&keys, std::vector<json_rpc::Response> &&responses, std::exception_ptr e);
+    };
+}
@@ -10,7 +10,12 @@
  *      调用EVP_DigestSignInit（）或EVP_DigestVerifyInit（）时，摘要类型参数必须设置为NULL。
  */
 #include <algorithm>
+#include <atomic>
+#include <map>
 #include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <iomanip>
 #include <iostream>
 #include <vector>
@@ -22,6 +27,8 @@
 #include <openssl/err.h>
 
 #include "../include/ed25519.hpp"
+#include "../include/hex_codec.hpp"
+#include "../include/co_helper.hpp"
 
 using namespace std;
 
@@ -29,34 +36,46 @@ namespace crypto::ed25519
 {
     static void check_ret(int ret, const char *error)
     {
-        std::ostringstream oss;
+        if (ret != 1)
+        {
+            std::ostringstream oss;
 
-        oss << error << "failed, error detail : " << ERR_error_string(ERR_get_error(), NULL) << std::endl;
+            oss << error << "failed, error detail : " << ERR_error_string(ERR_get_error(), NULL) << std::endl;
 
-        if (ret != 1)
             std::__throw_runtime_error(oss.str().c_str());
+        }
     }
+    //
+    //  The digest context of current thread, it is reset and reused by signing and verifying
+    //
+    static EVP_MD_CTX *local_md_ctx()
+    {
+        thread_local unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> md_ctx(EVP_MD_CTX_new(), &EVP_MD_CTX_free);
 
-    RawKey hex_to_raw_key(const string &hex_key)
+        EVP_MD_CTX_reset(md_ctx.get());
+
+        return md_ctx.get();
+    }
+
+    static RawKey get_raw_public_key(EVP_PKEY *pkey)
     {
-        RawKey raw_key;
+        RawKey raw_key = {0};
         size_t len = raw_key.size();
 
-        if (hex_key.length() != 64)
-            __throw_invalid_argument("the length of hex key string must be equal to 64");
+        int ret = EVP_PKEY_get_raw_public_key(pkey, raw_key.data(), &len);
+        check_ret(ret, "EVP_PKEY_get_raw_public_key");
 
-        auto iter = begin(raw_key);
-        for (size_t i = 0; i < hex_key.length(); i += 2)
-        {
-            stringstream ss;
-            uint16_t byte;
+        return raw_key;
+    }
+
+    RawKey hex_to_raw_key(const string &hex_key)
+    {
+        RawKey raw_key;
 
-            ss << hex_key[i] << hex_key[i + 1];
-            ss >> hex >> byte;
+        if (hex_key.length() != raw_key.size() * 2)
+            __throw_invalid_argument("the length of hex key string must be equal to 64");
 
-            // write raw_key from end to begin
-            *iter++ = (uint8_t)byte;
-        }
+        hex_decode(hex_key, raw_key);
 
         return raw_key;
     }
@@ -64,53 +83,67 @@ namespace crypto::ed25519
      *  Public Key
      ********************************************************************/
 
-    PublicKey::PublicKey(RawKey raw_key)
+    PublicKey::PublicKey(RawKey raw_key) : m_raw_key(raw_key)
     {
         m_pkey = EVP_PKEY_new_raw_public_key(EVP_PKEY_ED25519, NULL, raw_key.data(), raw_key.size());
     }
 
-    PublicKey::~PublicKey()
+    PublicKey::PublicKey(EVP_PKEY *pkey, const RawKey &raw_key) : m_pkey(pkey), m_raw_key(raw_key)
     {
-        EVP_PKEY_free(m_pkey);
+        EVP_PKEY_up_ref(m_pkey);
     }
 
-    PublicKey PublicKey::from_hex_string(const std::string &hex_str)
+    PublicKey::PublicKey(const PublicKey &r) : m_pkey(r.m_pkey), m_raw_key(r.m_raw_key)
     {
-        return PublicKey(hex_to_raw_key(hex_str));
+        if (m_pkey)
+            EVP_PKEY_up_ref(m_pkey);
     }
 
-    RawKey PublicKey::get_raw_key() const
+    PublicKey::PublicKey(PublicKey &&r) : m_pkey(r.m_pkey), m_raw_key(r.m_raw_key)
     {
-        RawKey raw_key;
-        size_t len = raw_key.size();
+        r.m_pkey = nullptr;
+    }
 
-        EVP_PKEY_get_raw_public_key(m_pkey, raw_key.data(), &len);
+    PublicKey &PublicKey::operator=(const PublicKey &r)
+    {
+        if (this != &r)
+        {
+            if (r.m_pkey)
+                EVP_PKEY_up_ref(r.m_pkey);
 
-        return raw_key;
+            EVP_PKEY_free(m_pkey);
+
+            m_pkey = r.m_pkey;
+            m_raw_key = r.m_raw_key;
+        }
+
+        return *this;
     }
 
-    std::string PublicKey::dump_hex() const
+    PublicKey::~PublicKey()
     {
-        auto raw_key = get_raw_key();
-        ostringstream oss;
-
-        for_each(begin(raw_key), end(raw_key), [&](uint8_t v)
-                 { oss << hex << setw(2) << setfill('0') << (uint16_t)v; });
+        EVP_PKEY_free(m_pkey);
+    }
 
-        return oss.str();
+    PublicKey PublicKey::from_hex_string(const std::string &hex_str)
+    {
+        return PublicKey(hex_to_raw_key(hex_str));
     }
 
-    bool PublicKey::verify(const Signature &sig, uint8_t *data, size_t len)
+    std::string PublicKey::dump_hex() const
     {
-        using ctx_ptr_t = unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)>;
+        return hex_encode(get_raw_key());
+    }
 
-        ctx_ptr_t md_ctx(EVP_MD_CTX_new(), &EVP_MD_CTX_free);
+    bool PublicKey::verify(const Signature &sig, const uint8_t *data, size_t len) const
+    {
+        EVP_MD_CTX *md_ctx = local_md_ctx();
         int ret = 0;
 
-        ret = EVP_DigestVerifyInit(md_ctx.get(), nullptr, NULL, NULL, m_pkey); // EVP_sha3_256()
+        ret = EVP_DigestVerifyInit(md_ctx, nullptr, NULL, NULL, m_pkey); // EVP_sha3_256()
         check_ret(ret, "EVP_DigestVerifyInit");
 
-        ret = EVP_DigestVerify(md_ctx.get(), sig.data(), sig.size(), data, len);
+        ret = EVP_DigestVerify(md_ctx, sig.data(), sig.size(), data, len);
         // check_ret(ret, "EVP_DigestVerify");
 
         return ret == 1;
@@ -120,12 +153,11 @@ namespace crypto::ed25519
      *  Private Key
      ********************************************************************/
 
-    PrivateKey::PrivateKey(EVP_PKEY *pkey)
+    PrivateKey::PrivateKey(EVP_PKEY *pkey) : m_pkey(pkey), m_public_key(pkey, get_raw_public_key(pkey))
     {
-        m_pkey = pkey;
     }
 
-    PrivateKey::PrivateKey(PrivateKey &&r)
+    PrivateKey::PrivateKey(PrivateKey &&r) : m_public_key(move(r.m_public_key))
     {
         m_pkey = r.m_pkey;
         r.m_pkey = nullptr;
@@ -136,18 +168,27 @@ namespace crypto::ed25519
         EVP_PKEY_free(m_pkey);
     }
 
-    PrivateKey::PrivateKey(const PrivateKey &r)
+    PrivateKey::PrivateKey(const PrivateKey &r) : m_public_key(r.m_public_key)
     {
         m_pkey = r.m_pkey;
 
-        EVP_PKEY_up_ref(m_pkey);
+        // a moved-from key has no EVP_PKEY
+        if (m_pkey)
+            EVP_PKEY_up_ref(m_pkey);
     }
 
-    PrivateKey PrivateKey::operator=(const PrivateKey &r)
+    PrivateKey &PrivateKey::operator=(const PrivateKey &r)
     {
-        m_pkey = r.m_pkey;
+        if (this != &r)
+        {
+            if (r.m_pkey)
+                EVP_PKEY_up_ref(r.m_pkey);
 
-        EVP_PKEY_up_ref(m_pkey);
+            EVP_PKEY_free(m_pkey);
+
+            m_pkey = r.m_pkey;
+            m_public_key = r.m_public_key;
+        }
 
         return *this;
     }
@@ -199,43 +240,144 @@ namespace crypto::ed25519
     std::string PrivateKey::dump_hex() const
     {
         auto raw_key = get_raw_key();
-        ostringstream oss;
-
-        for_each(rbegin(raw_key), rend(raw_key), [&](uint8_t v)
-                 { oss << hex << setw(2) << setfill('0') << (uint16_t)v; });
-
-        return oss.str();
-    }
-
-    PublicKey PrivateKey::get_public_key() const
-    {
-        RawKey raw_key = {0};
-        size_t len = raw_key.size();
 
-        int ret = EVP_PKEY_get_raw_public_key(m_pkey, raw_key.data(), &len);
-        check_ret(ret, "EVP_PKEY_get_raw_public_key");
+        // the private key is dumped in the reversed order of its bytes
+        reverse(begin(raw_key), end(raw_key));
 
-        return PublicKey(raw_key);
+        return hex_encode(raw_key);
     }
 
-    Signature PrivateKey::sign(uint8_t *data, size_t data_len)
+    Signature PrivateKey::sign(const uint8_t *data, size_t data_len) const
     {
-        using ctx_ptr_t = unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)>;
-        ctx_ptr_t md_ctx(EVP_MD_CTX_new(), &EVP_MD_CTX_free);
+        EVP_MD_CTX *md_ctx = local_md_ctx();
 
         Signature signature;
         size_t sig_len = signature.size();
         int ret = 0;
 
-        ret = EVP_DigestSignInit(md_ctx.get(), NULL, NULL, NULL, m_pkey);
+        ret = EVP_DigestSignInit(md_ctx, NULL, NULL, NULL, m_pkey);
         check_ret(ret, "EVP_DigestSignInit");
 
-        ret = EVP_DigestSign(md_ctx.get(), signature.data(), &sig_len, data, data_len);
+        ret = EVP_DigestSign(md_ctx, signature.data(), &sig_len, data, data_len);
         check_ret(ret, "EVP_DigestSign");
 
         return signature;
     }
 
+    /********************************************************************
+     *  Batch verification
+     *
+     *  OpenSSL does not expose the group operations of edwards25519, so the randomized linear combination
+     *  of signatures is not feasible here. The batch is verified one by one with the keys built once
+     *  and the work shared by the threads of the default executor.
+     ********************************************************************/
+
+    // the entries less than this are verified on the calling thread
+    const size_t MIN_ENTRIES_PER_THREAD = 32;
+
+    //
+    //  The state of a batch shared with the jobs on executor, a job may start after verify_batch returned,
+    //  then it only finds nothing left to verify
+    //
+    struct VerifyBatch
+    {
+        span<const VerifyEntry> entries;
+        vector<PublicKey> keys;
+        vector<size_t> key_of;
+        vector<uint8_t> passed;
+        atomic<size_t> next = 0;
+        atomic<size_t> verified = 0;
+        mutex done_mutex;
+        condition_variable done_cv;
+
+        void verify(size_t i)
+        {
+            try
+            {
+                const auto &entry = entries[i];
+                passed[i] = keys[key_of[i]].verify(entry.signature, entry.message.data(), entry.message.size());
+            }
+            catch (const std::exception &)
+            {
+                // an invalid public key fails to initialize the verification
+                passed[i] = false;
+            }
+        }
+
+        void work()
+        {
+            size_t size = passed.size();
+
+            for (size_t first = next.fetch_add(MIN_ENTRIES_PER_THREAD); first < size;
+                 first = next.fetch_add(MIN_ENTRIES_PER_THREAD))
+            {
+                size_t last = min(first + MIN_ENTRIES_PER_THREAD, size);
+
+                for (size_t i = first; i < last; i++)
+                    verify(i);
+
+                if (verified.fetch_add(last - first) + (last - first) == size)
+                {
+                    lock_guard<mutex> lock(done_mutex);
+                    done_cv.notify_all();
+                }
+            }
+        }
+    };
+
+    vector<size_t> verify_batch(span<const VerifyEntry> entries, size_t thread_count)
+    {
+        auto batch = make_shared<VerifyBatch>();
+
+        batch->entries = entries;
+        batch->key_of.resize(entries.size());
+        batch->passed.resize(entries.size(), 0);
+
+        // create the key for each distinct public key, an indexer sees the same senders repeatedly
+        map<RawKey, size_t> key_indices;
+
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            auto [iter, inserted] = key_indices.try_emplace(entries[i].public_key, batch->keys.size());
+            if (inserted)
+                batch->keys.emplace_back(entries[i].public_key);
+
+            batch->key_of[i] = iter->second;
+        }
+
+        auto &executor = Executor::default_executor();
+
+        // the calling thread works too
+        if (thread_count == 0)
+            thread_count = executor.thread_count() + 1;
+
+        thread_count = min(thread_count, max<size_t>(entries.size() / MIN_ENTRIES_PER_THREAD, 1));
+
+        for (size_t i = 1; i < thread_count; i++)
+            executor.post([batch]
+                          { batch->work(); });
+
+        batch->work();
+
+        // the entries taken by the jobs may be still in verification
+        {
+            unique_lock<mutex> lock(batch->done_mutex);
+            batch->done_cv.wait(lock, [&]
+                                { return batch->verified == entries.size(); });
+        }
+
+        auto &passed = batch->passed;
+        vector<size_t> failed;
+
+        for (size_t i = 0; i < passed.size(); i++)
+        {
+            if (!passed[i])
+                failed.push_back(i);
+        }
+
+        return failed;
+    }
+
     void run_test_case()
     {
         try
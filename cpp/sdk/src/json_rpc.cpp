@@ -1,8 +1,13 @@
 #include <cpprest/filestream.h>
 #include <cpprest/http_client.h>
 #include <cpprest/json.h>
+#include <mutex>
+#include <deque>
+#include <map>
+#include <tuple>
 #include "../include/utils.hpp"
 #include "../include/json_rpc.hpp"
+#include "json_rpc_parser.hpp"
 
 using namespace std;
 using namespace utility;
@@ -12,20 +17,382 @@ using namespace web::http::client;
 
 namespace json_rpc
 {
+    //
+    //  Build the method name and the params of a JSON-RPC request
+    //
+    static tuple<string, string> to_method_params(const Request &request)
+    {
+        return std::visit(
+            overloaded{[](const method::GetAccount &r)
+                       {
+                           auto address = bytes_to_hex(r.address.value);
+                           return make_tuple<string, string>(
+                               "get_account",
+                               r.version.has_value()
+                                   ? format(R"(["%s", %lu])", address.c_str(), *r.version)
+                                   : format(R"(["%s"])", address.c_str()));
+                       },
+                       [](const method::GetAccountTransaction &r)
+                       {
+                           return make_tuple<string, string>(
+                               "get_account_transaction",
+                               format(R"(["%s", %lu, %s])",
+                                      bytes_to_hex(r.address.value).c_str(),
+                                      r.sequence_number,
+                                      r.include_events ? "true" : "false"));
+                       },
+                       [](const method::GetAccountStateWithProof &r)
+                       {
+                           auto to_param = [](const optional<uint64_t> &v)
+                           { return v ? to_string(*v) : string("null"); };
+
+                           return make_tuple<string, string>(
+                               "get_account_state_with_proof",
+                               format(R"(["%s", %s, %s])",
+                                      r.account_address.c_str(),
+                                      to_param(r.version).c_str(),
+                                      to_param(r.ledger_version).c_str()));
+                       },
+                       [](const method::GetEvents &r)
+                       {
+                           return make_tuple<string, string>(
+                               "get_events",
+                               format(R"(["%s", %lu, %lu])", r.event_key.c_str(), r.start, r.limit));
+                       },
+                       [](const method::Submit &r)
+                       {
+                           auto hex = r.bytes.empty() ? bytes_to_hex(serde::BcsBuffer::local().serialize(r.signed_txn)) : bytes_to_hex(r.bytes);
+
+                           return make_tuple<string, string>(
+                               "submit",
+                               format(R"(["%s"])", hex.c_str()));
+                       }},
+            request);
+    }
+
+    static string to_json_request(const Request &request, size_t id)
+    {
+        auto [method, params] = to_method_params(request);
+
+        return format(R"({"jsonrpc":"2.0","method":"%s","params":%s,"id":%lu})", method.c_str(), params.c_str(), id);
+    }
+
+    static optional<AccountView> to_account_view(json::value &result)
+    {
+        if (result.is_null())
+            return nullopt;
+
+        AccountView view;
+
+        if (!result["sequence_number"].is_null())
+        {
+            view.sequence_number = result["sequence_number"].as_number().to_int64();
+            view.address = diem_types::AccountAddress{hex_to_array_u8<16>(result["address"].as_string())};
+        }
+
+        return view;
+    }
+
+    static optional<TransactionView> to_transaction_view(json::value &result)
+    {
+        if (result.is_null())
+            return nullopt;
+
+        TransactionView txn;
+
+        txn.version = result["version"].as_number().to_uint64();
+        txn.gas_used = result["gas_used"].as_number().to_uint64();
+
+        if (!result["hash"].is_null())
+            txn.hash = result["hash"].as_string();
+
+        if (!result["bytes"].is_null())
+            txn.bytes = result["bytes"].as_string();
+
+        auto vm_status = result["vm_status"];
+        auto type = vm_status["type"].as_string();
+        if (type == "executed")
+            txn.vm_status.value = VMStatus::Executed{type};
+        else if (type == "execution_failure")
+        {
+            txn.vm_status.value = VMStatus::ExecutionFailure{
+                type,
+                vm_status["location"].as_string(),
+                (uint64_t)vm_status["function_index"].as_integer(),
+                (uint64_t)vm_status["code_offset"].as_integer()};
+        }
+        else if (type == "out_of_gas")
+            txn.vm_status.value = VMStatus::OutOfGas{type};
+        else if (type == "miscellaneous_error")
+            txn.vm_status.value = VMStatus::MiscellaneousError{type};
+        else if (type == "move_abort")
+            txn.vm_status.value = VMStatus::MoveAbort{
+                type,
+                vm_status["location"].as_string(),
+                (uint64_t)vm_status["abort_code"].as_integer(),
+                {
+                    vm_status["explanation"].is_null() ? "" : vm_status["explanation"]["category"].as_string(),
+                    vm_status["explanation"].is_null() ? "" : vm_status["explanation"]["category_description"].as_string(),
+                    vm_status["explanation"].is_null() ? "" : vm_status["explanation"]["reason"].as_string(),
+                    vm_status["explanation"].is_null() ? "" : vm_status["explanation"]["reason_description"].as_string(),
+                }};
+        else
+            throw runtime_error("unknow vm status");
+
+        return txn;
+    }
+
+    static AccountStateWithProof to_account_state_with_proof(json::value &result)
+    {
+        AccountStateWithProof asp;
+
+        asp.version = result["version"].as_integer();
+
+        auto blob = result["blob"];
+        if (!blob.is_null())
+            asp.blob = hex_to_bytes(blob.as_string());
+
+        asp.proof.ledger_info_to_transaction_info_proof = hex_to_bytes(result["proof"]["ledger_info_to_transaction_info_proof"].as_string());
+        asp.proof.transaction_info = hex_to_bytes(result["proof"]["transaction_info"].as_string());
+        asp.proof.transaction_info_to_account_proof = hex_to_bytes(result["proof"]["transaction_info_to_account_proof"].as_string());
+
+        return asp;
+    }
+
+    static vector<EventView> to_events(json::value &result)
+    {
+        vector<EventView> events;
+
+        for (auto &e : result.as_array())
+        {
+            EventView ev;
+
+            ev.key = e["key"].as_string();
+            ev.sequence_number = e["sequence_number"].as_integer();
+            ev.transaction_version = e["transaction_version"].as_integer();
+
+            if (e["data"]["type"].as_string() == "unknown")
+            {
+                UnknownEvent ue;
+
+                ue.bytes = hex_to_bytes(e["data"]["bytes"].as_string());
+
+                ev.event = ue;
+            }
+
+            events.emplace_back(ev);
+        }
+
+        return events;
+    }
+    //
+    //  Convert the result to the response which has the same alternative index as the request
+    //
+    static Response to_response(const Request &request, json::value &result)
+    {
+        return std::visit(
+            overloaded{[&](const method::GetAccount &) -> Response
+                       { return to_account_view(result); },
+                       [&](const method::GetAccountTransaction &) -> Response
+                       { return to_transaction_view(result); },
+                       [&](const method::GetAccountStateWithProof &) -> Response
+                       { return to_account_state_with_proof(result); },
+                       [&](const method::GetEvents &) -> Response
+                       { return to_events(result); },
+                       [&](const method::Submit &) -> Response
+                       { return monostate{}; }},
+            request);
+    }
+
+    static void check_error(json::value &rpc_response, string_view method)
+    {
+        auto error = rpc_response["error"];
+        if (!error.is_null())
+            throw RpcError(fmt("fun : ", method, ", error : ", error.serialize()));
+    }
+
+    static string to_json_batch(const vector<Request> &requests)
+    {
+        // The id of each request is its index
+        string content = "[";
+        for (size_t i = 0; i < requests.size(); i++)
+        {
+            if (i)
+                content += ",";
+
+            content += to_json_request(requests[i], i);
+        }
+        content += "]";
+
+        return content;
+    }
+
+    static vector<Response> to_responses(const vector<Request> &requests, json::value &rpc_response)
+    {
+        if (!rpc_response.is_array())
+        {
+            // the server may reply a single error object for a malformed batch
+            check_error(rpc_response, "batch");
+            __throw_runtime_error("fun : batch, error : the response is not an array");
+        }
+
+        vector<optional<Response>> responses(requests.size());
+
+        for (auto &r : rpc_response.as_array())
+        {
+            if (r["id"].is_null())
+                check_error(r, "batch");
+
+            size_t id = r["id"].as_number().to_uint64();
+            if (id >= requests.size())
+                __throw_runtime_error(fmt("fun : batch, error : unknown response id ", id).c_str());
+
+            check_error(r, get<0>(to_method_params(requests[id])));
+
+            responses[id] = to_response(requests[id], r["result"]);
+        }
+
+        vector<Response> results;
+        results.reserve(requests.size());
+
+        for (size_t i = 0; i < responses.size(); i++)
+        {
+            if (!responses[i].has_value())
+                __throw_runtime_error(fmt("fun : batch, error : missing response for id ", i).c_str());
+
+            results.emplace_back(move(*responses[i]));
+        }
+
+        return results;
+    }
+
+    //
+    //  The diem_ledger_version of a response, the smallest one of a batch, 0 if unknown
+    //
+    static uint64_t to_ledger_version(json::value &rpc_response)
+    {
+        if (rpc_response.is_array())
+        {
+            uint64_t version = 0;
+
+            for (auto &r : rpc_response.as_array())
+            {
+                auto v = to_ledger_version(r);
+                if (v && (version == 0 || v < version))
+                    version = v;
+            }
+
+            return version;
+        }
+
+        if (rpc_response.is_object() && rpc_response.has_field("diem_ledger_version"))
+            return rpc_response["diem_ledger_version"].as_number().to_uint64();
+
+        return 0;
+    }
+
+    //
+    //  Parse the body of a response with the SAX parser
+    //
+    static tuple<Response, uint64_t> parse_response(const Request &request, const string &body)
+    {
+        auto replies = parse_replies({&request, 1}, body, false);
+        auto method = get<0>(to_method_params(request));
+
+        if (!replies.errors[0].empty())
+            throw RpcError(fmt("fun : ", method, ", error : ", replies.errors[0]));
+
+        if (!replies.responses[0].has_value())
+            __throw_runtime_error(fmt("fun : ", method, ", error : no result in response").c_str());
+
+        return {move(*replies.responses[0]), replies.ledger_version};
+    }
+    //
+    //  Parse the body of a batch response with the SAX parser,
+    //  the DOM parser is used only if a result comes before its id in a batch of different methods
+    //
+    static tuple<vector<Response>, uint64_t> parse_responses(const vector<Request> &requests, const string &body)
+    {
+        Replies replies;
+
+        try
+        {
+            replies = parse_replies(requests, body, true);
+        }
+        catch (const unordered_reply &)
+        {
+            auto rpc_response = json::value::parse(body);
+
+            return {to_responses(requests, rpc_response), to_ledger_version(rpc_response)};
+        }
+
+        if (!replies.error.empty())
+            throw RpcError(fmt("fun : batch, error : ", replies.error));
+
+        vector<Response> results;
+        results.reserve(requests.size());
+
+        for (size_t i = 0; i < requests.size(); i++)
+        {
+            if (!replies.errors[i].empty())
+                throw RpcError(fmt("fun : ", get<0>(to_method_params(requests[i])), ", error : ", replies.errors[i]));
+
+            if (!replies.responses[i].has_value())
+                __throw_runtime_error(fmt("fun : batch, error : missing response for id ", i).c_str());
+
+            results.emplace_back(move(*replies.responses[i]));
+        }
+
+        return {move(results), replies.ledger_version};
+    }
 
     class ClientImp : public Client
     {
-        http_client m_http_cli;
+        struct PendingRequest
+        {
+            string content;
+            pplx::task_completion_event<string> tce;
+        };
+
+        // the requests are spread over the http clients, each one keeps its own connections alive
+        vector<http_client> m_http_clis;
+        bool m_keep_alive;
+
+        // the requests in flight and the requests waiting for a free slot
+        mutex m_mutex;
+        size_t m_max_in_flight;
+        size_t m_in_flight = 0;
+        size_t m_next_cli = 0;
+        deque<PendingRequest> m_pending;
+        // the time of the last request posted or completed
+        chrono::steady_clock::time_point m_last_used = chrono::steady_clock::now();
 
     public:
-        ClientImp(string_view url) : m_http_cli(U(string(url)), client_config_for_proxy())
+        ClientImp(string_view url, const ClientOptions &options)
+            : m_keep_alive(options.keep_alive),
+              m_max_in_flight(std::max<size_t>(options.max_requests_in_flight, 1))
         {
+            auto config = client_config(options);
+            size_t count = std::max<size_t>(options.max_connections, 1);
+
+            m_http_clis.reserve(count);
+            for (size_t i = 0; i < count; i++)
+                m_http_clis.emplace_back(U(string(url)), config);
         }
 
         virtual ~ClientImp()
         {
         }
 
+        web::http::client::http_client_config client_config(const ClientOptions &options)
+        {
+            auto client_config = client_config_for_proxy();
+
+            client_config.set_timeout(options.timeout);
+
+            return client_config;
+        }
+
         web::http::client::http_client_config client_config_for_proxy()
         {
             web::http::client::http_client_config client_config;
@@ -53,254 +420,710 @@ namespace json_rpc
 
             return client_config;
         }
+        //
+        //  Post a JSON-RPC request or batch without blocking,
+        //  it is queued if the number of requests in flight reaches the limit
+        //
+        pplx::task<string> post_async(string content)
+        {
+            pplx::task_completion_event<string> tce;
+            {
+                lock_guard<mutex> lock(m_mutex);
 
-        virtual void submit(const diem_types::SignedTransaction &signed_txn) override
+                m_last_used = chrono::steady_clock::now();
+
+                if (m_in_flight >= m_max_in_flight)
+                {
+                    m_pending.push_back({move(content), tce});
+                    return pplx::create_task(tce);
+                }
+
+                m_in_flight++;
+            }
+
+            send(move(content), tce);
+
+            return pplx::create_task(tce);
+        }
+
+        void send(string content, pplx::task_completion_event<string> tce)
+        {
+            auto self = shared_from_this(); // keep the client alive until the response comes back
+
+            http_request request(methods::POST);
+            request.set_request_uri(U("/"));
+            request.set_body(content, "application/json");
+            if (!m_keep_alive)
+                request.headers().add(header_names::connection, U("close"));
+
+            http_client *http_cli;
+            {
+                lock_guard<mutex> lock(m_mutex);
+                http_cli = &m_http_clis[m_next_cli++ % m_http_clis.size()];
+            }
+
+            http_cli->request(request)
+                .then([=](http_response response) -> pplx::task<string>
+                      {
+                          if (response.status_code() != 200)
+                              __throw_runtime_error(response.extract_string().get().c_str());
+
+                          // the body is parsed by the SAX parser, no DOM is built
+                          return response.extract_utf8string(true); })
+                .then([this, self, tce](pplx::task<string> task)
+                      {
+                          try
+                          {
+                              tce.set(task.get());
+                          }
+                          catch (...)
+                          {
+                              tce.set_exception(current_exception());
+                          }
+
+                          on_completed(); });
+        }
+        //
+        //  Send the next pending request on the slot released by a completed one
+        //
+        void on_completed()
         {
-            auto data = bytes_to_hex(signed_txn.bcsSerialize());
+            PendingRequest next;
+            {
+                lock_guard<mutex> lock(m_mutex);
 
-            string method = format(R"({"jsonrpc":"2.0","method":"submit","params":["%s"],"id":1})", data.c_str());
-            string content_type = "application/json";
+                m_last_used = chrono::steady_clock::now();
 
-            auto rpc_response = m_http_cli.request(methods::POST, "/", method, content_type)
-                                    .then([=](http_response response) -> pplx::task<json::value>
-                                          {
-                                              if (response.status_code() != 200)
-                                                  __throw_runtime_error(response.extract_string().get().c_str());
+                if (m_pending.empty())
+                {
+                    m_in_flight--;
+                    return;
+                }
 
-                                              return response.extract_json(); })
-                                    .get();
+                next = move(m_pending.front());
+                m_pending.pop_front();
+            }
 
-            auto error = rpc_response["error"];
-            if (!error.is_null())
-                __throw_runtime_error(("fun : get_account_state_blob, error : " + error.serialize()).c_str());
+            send(move(next.content), next.tce);
+        }
+        //
+        //  No request is in flight or waiting, and none was posted or completed within timeout
+        //
+        bool is_idle(chrono::steady_clock::duration timeout)
+        {
+            lock_guard<mutex> lock(m_mutex);
 
-            auto version = rpc_response["diem_ledger_version"].as_integer();
+            return m_in_flight == 0 && m_pending.empty() && chrono::steady_clock::now() - m_last_used > timeout;
+        }
+        //
+        //  Post a JSON-RPC request or batch and return the body of response
+        //
+        string post(const string &content)
+        {
+            return post_async(content).get();
         }
-        
-#if defined(__GNUC__) && !defined(__llvm__)
         //
-        //  Async submit
+        //  Call a single request with id 1
         //
-        virtual void async_submit(const diem_types::SignedTransaction &signed_txn,
-                                  std::function<void()> callback) override
+        Response call(const Request &request)
         {
+            return get<0>(parse_response(request, post(to_json_request(request, 1))));
+        }
 
+        virtual void submit(const diem_types::SignedTransaction &signed_txn) override
+        {
+            call(method::Submit{signed_txn});
         }
-#endif
+
         virtual std::optional<TransactionView>
         get_account_transaction(const diem_types::AccountAddress &address,
                                 uint64_t sequence_number,
                                 bool include_events) override
         {
-            string method = format(R"({"jsonrpc":"2.0","method":"get_account_transaction","params":["%s", %d, %s],"id":1})",
-                                   bytes_to_hex(address.value).c_str(),
-                                   sequence_number,
-                                   include_events ? "true" : "false");
-            string content_type = "application/json";
+            return get<optional<TransactionView>>(call(method::GetAccountTransaction{address, sequence_number, include_events}));
+        }
 
-            auto rpc_response = m_http_cli.request(methods::POST, "/", method, content_type)
-                                    .then([=](http_response response) -> pplx::task<json::value>
-                                          {
-                                              if (response.status_code() != 200)
-                                                  __throw_runtime_error(response.extract_string().get().c_str());
+        virtual std::optional<AccountView>
+        get_account(const diem_types::AccountAddress &address, std::optional<uint64_t> version) override
+        {
+            return get<optional<AccountView>>(call(method::GetAccount{address, version}));
+        }
 
-                                              return response.extract_json(); })
-                                    .get();
+        virtual std::vector<Currency> get_currencies() override
+        {
+            vector<Currency> crc;
 
-            auto error = rpc_response["error"];
-            if (!error.is_null())
-                __throw_runtime_error(("get_account_transaction error, " + error.serialize()).c_str());
+            return crc;
+        }
 
-            auto result = rpc_response["result"];
-            TransactionView txn;
+        virtual AccountStateWithProof
+        get_account_state_blob(string account_address) override
+        {
+            return get<AccountStateWithProof>(call(method::GetAccountStateWithProof{account_address}));
+        }
 
-            if (!result.is_null())
-            {
-                auto vm_status = result["vm_status"];
-                auto type = vm_status["type"].as_string();
-                if (type == "executed")
-                    txn.vm_status.value = VMStatus::Executed{type};
-                else if (type == "execution_failure")
-                {
-                    txn.vm_status.value = VMStatus::ExecutionFailure{
-                        type,
-                        vm_status["location"].as_string(),
-                        (uint64_t)vm_status["function_index"].as_integer(),
-                        (uint64_t)vm_status["code_offset"].as_integer()};
-                }
-                else if (type == "out_of_gas")
-                    txn.vm_status.value = VMStatus::OutOfGas{type};
-                else if (type == "miscellaneous_error")
-                    txn.vm_status.value = VMStatus::MiscellaneousError{type};
-                else if (type == "move_abort")
-                    txn.vm_status.value = VMStatus::MoveAbort{
-                        type,
-                        vm_status["location"].as_string(),
-                        (uint64_t)vm_status["abort_code"].as_integer(),
-                        {
-                            vm_status["explanation"].is_null() ? "" : vm_status["explanation"]["category"].as_string(),
-                            vm_status["explanation"].is_null() ? "" : vm_status["explanation"]["category_description"].as_string(),
-                            vm_status["explanation"].is_null() ? "" : vm_status["explanation"]["reason"].as_string(),
-                            vm_status["explanation"].is_null() ? "" : vm_status["explanation"]["reason_description"].as_string(),
-                        }};
-                else
-                    throw runtime_error("unknow vm status");
+        virtual std::vector<EventView>
+        get_events(std::string event_key, uint64_t start, uint64_t limit, uint64_t rpc_id) override
+        {
+            return get<vector<EventView>>(call(method::GetEvents{event_key, start, limit}));
+        }
 
-                // cout << result.serialize() << endl;
-                return txn;
-            }
-            else
-                return std::nullopt;
+        virtual std::vector<Response>
+        batch(const std::vector<Request> &requests) override
+        {
+            if (requests.empty())
+                return {};
+
+            return get<0>(parse_responses(requests, post(to_json_batch(requests))));
         }
 
         virtual void
-        async_get_account_transaction(const diem_types::AccountAddress &address,
-                                      uint64_t sequence_number,
-                                      bool include_events,
-                                      std::function<void(TransactionView &)>) override
+        async_call(const Request &request, Callback callback) override
         {
+            post_async(to_json_request(request, 1))
+                .then([request, callback](pplx::task<string> task)
+                      {
+                          Response response;
+                          exception_ptr e;
+
+                          try
+                          {
+                              response = get<0>(parse_response(request, task.get()));
+                          }
+                          catch (...)
+                          {
+                              e = current_exception();
+                          }
+
+                          callback(move(response), e); });
         }
 
-        virtual std::optional<AccountView>
-        get_account(const diem_types::AccountAddress &address, std::optional<uint64_t> version) override
+        virtual void
+        async_batch(const std::vector<Request> &requests, BatchCallback callback) override
         {
-            string method = format(R"({"jsonrpc":"2.0","method":"get_account","params":["%s"],"id":1})", bytes_to_hex(address.value).c_str());
-            string content_type = "application/json";
+            if (requests.empty())
+            {
+                callback({}, nullptr);
+                return;
+            }
+
+            post_async(to_json_batch(requests))
+                .then([requests, callback](pplx::task<string> task)
+                      {
+                          vector<Response> responses;
+                          exception_ptr e;
+
+                          try
+                          {
+                              responses = get<0>(parse_responses(requests, task.get()));
+                          }
+                          catch (...)
+                          {
+                              e = current_exception();
+                          }
 
-            auto rpc_response = m_http_cli.request(methods::POST, "/", method, content_type)
-                                    .then([=](http_response response) -> pplx::task<json::value>
-                                          {                                              
+                          callback(move(responses), e); });
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////
+    //  Client over multiple endpoints
+    ////////////////////////////////////////////////////////////////////////////////////
+    class MultiClientImp : public Client
+    {
+        using clock = chrono::steady_clock;
+
+        struct Endpoint
+        {
+            string url;
+            shared_ptr<ClientImp> client;
 
-                                              if (response.status_code() != 200)
-                                                  __throw_runtime_error(response.extract_string().get().c_str());
+            // guarded by m_mutex
+            size_t outstanding = 0;
+            double latency_ms = 0; // EWMA of latency
+            size_t failures = 0;   // consecutive transport failures
+            clock::time_point ejected_until;
+        };
+        //
+        //  The state of a request which may be sent to several endpoints,
+        //  the first accepted reply completes it
+        //
+        template <typename R>
+        struct Call
+        {
+            string content;
+            function<tuple<R, uint64_t>(const string &)> parse; // throws the JSON-RPC error
+            function<void(R &&, exception_ptr)> callback;
+            bool is_read;
 
-                                              return response.extract_json(); })
-                                    .get();
+            std::mutex state_mutex;
+            bool done = false;
+            size_t running = 0;
+            vector<bool> tried;
+            size_t stale_retries = 0;
+            bool stale = false;
+            exception_ptr last_error;
+        };
 
-            auto error = rpc_response["error"];
-            if (!error.is_null())
-                __throw_runtime_error(("fun : get_account_state_blob, error : " + error.serialize()).c_str());
+        static constexpr double EWMA_ALPHA = 0.3;
+        static constexpr size_t MAX_STALE_RETRIES = 3;
 
-            auto result = rpc_response["result"];
+        vector<Endpoint> m_endpoints;
+        MultiClientOptions m_options;
+        mutex m_mutex;
+        // the highest ledger version has been read, reads from endpoints behind it are rejected
+        atomic<uint64_t> m_ledger_version{0};
 
-            if (!result.is_null())
+        //
+        //  Pick the best endpoint which has not been tried, the ejected endpoints are picked only if no other one is left
+        //
+        optional<size_t> pick(const vector<bool> &tried)
+        {
+            lock_guard<mutex> lock(m_mutex);
+
+            auto now = clock::now();
+            optional<size_t> best;
+            double best_score = 0;
+            bool best_ejected = true;
+
+            for (size_t i = 0; i < m_endpoints.size(); i++)
             {
-                AccountView view;
+                if (tried[i])
+                    continue;
+
+                auto &ep = m_endpoints[i];
+                bool ejected = ep.ejected_until > now;
+                double score = m_options.balance == MultiClientOptions::Balance::least_outstanding
+                                   ? double(ep.outstanding)
+                                   : (ep.latency_ms + 1) * (ep.outstanding + 1);
 
-                if (!result["sequence_number"].is_null())
+                if (!best || (best_ejected && !ejected) || (best_ejected == ejected && score < best_score))
                 {
-                    view.sequence_number = result["sequence_number"].as_number().to_int64();
-                    view.address = diem_types::AccountAddress{hex_to_array_u8<16>(result["address"].as_string())};
+                    best = i;
+                    best_score = score;
+                    best_ejected = ejected;
                 }
-                return view;
+            }
+
+            if (best)
+                m_endpoints[*best].outstanding++;
+
+            return best;
+        }
+
+        void on_endpoint_reply(size_t index, clock::time_point start, bool transport_failed)
+        {
+            lock_guard<mutex> lock(m_mutex);
+
+            auto &ep = m_endpoints[index];
+            ep.outstanding--;
+
+            if (transport_failed)
+            {
+                if (++ep.failures >= m_options.max_failures)
+                    ep.ejected_until = clock::now() + m_options.eject_duration;
             }
             else
-                return std::nullopt;
+            {
+                double latency = chrono::duration<double, milli>(clock::now() - start).count();
+
+                ep.latency_ms = ep.latency_ms == 0 ? latency : EWMA_ALPHA * latency + (1 - EWMA_ALPHA) * ep.latency_ms;
+                ep.failures = 0;
+                ep.ejected_until = {};
+            }
         }
 
-        virtual std::vector<Currency> get_currencies() override
+        template <typename R>
+        void start(shared_ptr<Call<R>> call)
         {
-            vector<Currency> crc;
+            call->tried.assign(m_endpoints.size(), false);
 
-            return crc;
+            launch(call);
+
+            if (call->is_read && m_options.hedge_delay.count() > 0 && m_endpoints.size() > 1)
+            {
+                auto self = static_pointer_cast<MultiClientImp>(shared_from_this());
+
+                Executor::default_executor().post_after(m_options.hedge_delay, [self, call]
+                                                        {
+                                                            {
+                                                                lock_guard<mutex> lock(call->state_mutex);
+                                                                if (call->done)
+                                                                    return;
+                                                            }
+
+                                                            self->launch(call); });
+            }
         }
+        //
+        //  Send the call to the next best endpoint
+        //
+        template <typename R>
+        void launch(shared_ptr<Call<R>> call)
+        {
+            optional<size_t> index;
+            {
+                lock_guard<mutex> lock(call->state_mutex);
 
-        virtual AccountStateWithProof
-        get_account_state_blob(string account_address) override
+                index = pick(call->tried);
+                if (!index)
+                    return;
+
+                call->tried[*index] = true;
+                call->running++;
+            }
+
+            auto self = static_pointer_cast<MultiClientImp>(shared_from_this());
+            auto start = clock::now();
+            size_t i = *index;
+
+            m_endpoints[i].client->post_async(call->content).then([self, call, i, start](pplx::task<string> task)
+                                                                 { self->on_reply(call, i, start, task); });
+        }
+
+        template <typename R>
+        void on_reply(shared_ptr<Call<R>> call, size_t index, clock::time_point start, pplx::task<string> task)
         {
-            AccountStateWithProof asp;
-            string method = format(R"({"jsonrpc":"2.0","method":"get_account_state_with_proof","params":["%s", null, null],"id":1})", account_address.c_str());
-            string content_type = "application/json";
+            string body;
 
-            auto rpc_response = m_http_cli.request(methods::POST, "/", method, content_type)
-                                    .then([=](http_response response) -> pplx::task<json::value>
-                                          {
-                                              // printf("Response status code %u returned.\n", response.status_code());
+            try
+            {
+                body = task.get();
+            }
+            catch (...)
+            {
+                on_endpoint_reply(index, start, true);
+                return on_failed(call, current_exception(), false);
+            }
+
+            on_endpoint_reply(index, start, false);
 
-                                              if (response.status_code() != 200)
-                                                  __throw_runtime_error(response.extract_string().get().c_str());
+            R result{};
+            uint64_t version = 0;
+            exception_ptr e;
 
-                                              return response.extract_json(); })
-                                    .get();
+            try
+            {
+                tie(result, version) = call->parse(body);
+            }
+            catch (...)
+            {
+                // the endpoint is healthy, a JSON-RPC error is returned to caller directly
+                e = current_exception();
+            }
 
-            auto error = rpc_response["error"];
-            if (!error.is_null())
-                __throw_runtime_error(("fun : get_account_state_blob, error : " + error.serialize()).c_str());
+            auto highest = m_ledger_version.load();
 
-            auto result = rpc_response["result"];
-            // cout << result.serialize() << endl;
+            if (!e && call->is_read && version != 0 && version < highest)
+                return on_failed(call,
+                                 make_exception_ptr(runtime_error(fmt("fun : multi client, error : ", m_endpoints[index].url,
+                                                                      " is behind ledger version ", highest))),
+                                 true);
 
-            asp.version = result["version"].as_integer();
+            while (!e && version > highest && !m_ledger_version.compare_exchange_weak(highest, version))
+                ;
 
-            auto blob = result["blob"];
-            // if (blob.is_null())
-            //     __throw_runtime_error(("fun : get_account_state_blob, error : " + rpc_response.serialize()).c_str());
+            {
+                lock_guard<mutex> lock(call->state_mutex);
 
-            if (!blob.is_null())
-                asp.blob = blob.as_string();
+                call->running--;
+                if (call->done)
+                    return;
 
-            asp.proof.ledger_info_to_transaction_info_proof = result["proof"]["ledger_info_to_transaction_info_proof"].as_string();
-            asp.proof.transaction_info = result["proof"]["transaction_info"].as_string();
-            asp.proof.transaction_info_to_account_proof = result["proof"]["transaction_info_to_account_proof"].as_string();
+                call->done = true;
+            }
 
-            return asp;
+            call->callback(move(result), e);
+        }
+        //
+        //  Fail over to the next endpoint, the call fails when all endpoints failed.
+        //  A submit is not failed over, the endpoint may have accepted it before the transport failed
+        //  and the mempool of another one rejects the same sequence number
+        //
+        template <typename R>
+        void on_failed(shared_ptr<Call<R>> call, exception_ptr e, bool stale)
+        {
+            bool untried = false;
+            bool retry = false;
+            {
+                lock_guard<mutex> lock(call->state_mutex);
+
+                call->running--;
+                call->last_error = e;
+                call->stale = call->stale || stale;
+
+                if (call->done)
+                    return;
+
+                untried = call->is_read && find(begin(call->tried), end(call->tried), false) != end(call->tried);
+                if (!untried && call->running > 0)
+                    return; // wait for the other endpoints
+
+                if (!untried && call->stale && call->stale_retries < MAX_STALE_RETRIES)
+                {
+                    // all endpoints are behind, give them a while to catch up
+                    call->stale_retries++;
+                    call->stale = false;
+                    call->tried.assign(call->tried.size(), false);
+                    retry = true;
+                }
+                else if (!untried)
+                    call->done = true;
+            }
+
+            if (untried)
+                launch(call);
+            else if (retry)
+            {
+                auto self = static_pointer_cast<MultiClientImp>(shared_from_this());
+
+                Executor::default_executor().post_after(chrono::milliseconds(100), [self, call]
+                                                        { self->launch(call); });
+            }
+            else
+                call->callback(R{}, call->last_error);
+        }
+
+        Response call_sync(const Request &request)
+        {
+            promise<Response> promise;
+            auto future = promise.get_future();
+
+            async_call(request, [&promise](Response &&response, exception_ptr e)
+                       {
+                           if (e)
+                               promise.set_exception(e);
+                           else
+                               promise.set_value(move(response)); });
+
+            return future.get();
+        }
+
+    public:
+        MultiClientImp(const vector<string> &urls, const MultiClientOptions &options)
+            : m_endpoints(urls.size()), m_options(options)
+        {
+            if (urls.empty())
+                __throw_runtime_error("fun : multi client, error : no endpoint");
+
+            for (size_t i = 0; i < urls.size(); i++)
+            {
+                m_endpoints[i].url = urls[i];
+                m_endpoints[i].client = static_pointer_cast<ClientImp>(ClientPool::get(urls[i], options.client));
+            }
+        }
+
+        virtual void submit(const diem_types::SignedTransaction &signed_txn) override
+        {
+            call_sync(method::Submit{signed_txn});
+        }
+
+        virtual std::optional<TransactionView>
+        get_account_transaction(const diem_types::AccountAddress &address,
+                                uint64_t sequence_number,
+                                bool include_events) override
+        {
+            return get<optional<TransactionView>>(call_sync(method::GetAccountTransaction{address, sequence_number, include_events}));
+        }
+
+        virtual std::optional<AccountView>
+        get_account(const diem_types::AccountAddress &address, std::optional<uint64_t> version) override
+        {
+            return get<optional<AccountView>>(call_sync(method::GetAccount{address, version}));
+        }
+
+        virtual std::vector<Currency> get_currencies() override
+        {
+            return {};
+        }
+
+        virtual AccountStateWithProof
+        get_account_state_blob(string account_address) override
+        {
+            return get<AccountStateWithProof>(call_sync(method::GetAccountStateWithProof{account_address}));
         }
 
         virtual std::vector<EventView>
         get_events(std::string event_key, uint64_t start, uint64_t limit, uint64_t rpc_id) override
         {
-            vector<EventView> events;
-            string method = format(R"({"jsonrpc":"2.0","method":"get_events","params":["%s", %d, %d],"id":1})",
-                                   event_key.c_str(),
-                                   start,
-                                   limit,
-                                   rpc_id);
-            string content_type = "application/json";
-
-            auto rpc_response = m_http_cli.request(methods::POST, "/", method, content_type)
-                                    .then([=](http_response response) -> pplx::task<json::value>
-                                          {
-                                              if (response.status_code() != 200)
-                                                  __throw_runtime_error(response.extract_string().get().c_str());
-
-                                              return response.extract_json(); })
-                                    .get();
-
-            auto error = rpc_response["error"];
-            if (!error.is_null())
-                __throw_runtime_error(("fun : get_events, error : " + error.serialize()).c_str());
-
-            auto result = rpc_response["result"];
-            for (auto &e : result.as_array())
-            {
-                // cout << e.serialize() << endl;
+            return get<vector<EventView>>(call_sync(method::GetEvents{event_key, start, limit}));
+        }
 
-                EventView ev;
+        virtual std::vector<Response>
+        batch(const std::vector<Request> &requests) override
+        {
+            promise<vector<Response>> promise;
+            auto future = promise.get_future();
 
-                ev.key = e["key"].as_string();
-                ev.sequence_number = e["sequence_number"].as_integer();
-                ev.transaction_version = e["transaction_version"].as_integer();
+            async_batch(requests, [&promise](vector<Response> &&responses, exception_ptr e)
+                        {
+                            if (e)
+                                promise.set_exception(e);
+                            else
+                                promise.set_value(move(responses)); });
 
-                if (e["data"]["type"].as_string() == "unknown")
-                {
-                    UnknownEvent ue;
+            return future.get();
+        }
+        //
+        //  A submit is sent to one endpoint only, neither hedged nor failed over,
+        //  the caller checks the sequence number before submitting it again
+        //
+        virtual void
+        async_call(const Request &request, Callback callback) override
+        {
+            auto call = make_shared<Call<Response>>();
 
-                    ue.bytes = hex_to_bytes(e["data"]["bytes"].as_string());
+            call->content = to_json_request(request, 1);
+            call->parse = [request](const string &body)
+            { return parse_response(request, body); };
+            call->callback = callback;
+            call->is_read = !holds_alternative<method::Submit>(request);
 
-                    ev.event = ue;
-                }
+            start(call);
+        }
 
-                events.emplace_back(ev);
+        virtual void
+        async_batch(const std::vector<Request> &requests, BatchCallback callback) override
+        {
+            if (requests.empty())
+            {
+                callback({}, nullptr);
+                return;
             }
 
-            return events;
+            auto call = make_shared<Call<vector<Response>>>();
+
+            call->content = to_json_batch(requests);
+            call->parse = [requests](const string &body)
+            { return parse_responses(requests, body); };
+            call->callback = callback;
+            call->is_read = none_of(begin(requests), end(requests), [](const Request &r)
+                                    { return holds_alternative<method::Submit>(r); });
+
+            start(call);
         }
     };
 
     std::shared_ptr<Client>
     Client::create(std::string_view url)
     {
-        return make_shared<ClientImp>(url);
+        return make_shared<ClientImp>(url, ClientOptions{});
+    }
+
+    std::shared_ptr<Client>
+    Client::create(std::string_view url, const ClientOptions &options)
+    {
+        return make_shared<ClientImp>(url, options);
+    }
+
+    std::shared_ptr<Client>
+    Client::create(const std::vector<std::string> &urls, const MultiClientOptions &options)
+    {
+        return make_shared<MultiClientImp>(urls, options);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////
+    //  Client pool
+    ////////////////////////////////////////////////////////////////////////////////////
+    struct PooledClient
+    {
+        shared_ptr<ClientImp> client;
+        chrono::seconds idle_timeout;
+    };
+    //
+    //  The clients of the same url but different options are pooled separately
+    //
+    using PoolKey = tuple<string, size_t, size_t, chrono::seconds::rep, bool, chrono::seconds::rep>;
+
+    static PoolKey pool_key(std::string_view url, const ClientOptions &options)
+    {
+        return {string(url), options.max_requests_in_flight, options.max_connections,
+                options.timeout.count(), options.keep_alive, options.idle_timeout.count()};
+    }
+
+    static mutex g_pool_mutex;
+    static map<PoolKey, PooledClient> g_pool;
+    // a sweep of idle clients is scheduled
+    static bool g_sweeping = false;
+
+    // Move the idle clients out of the pool to released, g_pool_mutex must be locked,
+    // the caller destroys them after unlocking it because closing their connections may block
+    static void release_idle_clients(vector<shared_ptr<ClientImp>> &released)
+    {
+        for (auto iter = begin(g_pool); iter != end(g_pool);)
+        {
+            auto &pooled = iter->second;
+
+            // the client is in use if anyone else holds it, or it was used recently by one who released it since
+            if (pooled.client.use_count() == 1 && pooled.client->is_idle(pooled.idle_timeout))
+            {
+                released.push_back(move(pooled.client));
+                iter = g_pool.erase(iter);
+            }
+            else
+                ++iter;
+        }
+    }
+    //
+    //  Sweep the idle clients periodically while the pool is not empty, g_pool_mutex must be locked
+    //
+    static void schedule_sweep()
+    {
+        if (g_sweeping || g_pool.empty())
+            return;
+
+        auto interval = min_element(begin(g_pool), end(g_pool), [](const auto &a, const auto &b)
+                                    { return a.second.idle_timeout < b.second.idle_timeout; })
+                            ->second.idle_timeout;
+
+        g_sweeping = true;
+
+        Executor::default_executor().post_after(max<chrono::milliseconds>(interval, 1s), []
+                                                {
+                                                    vector<shared_ptr<ClientImp>> released;
+                                                    lock_guard<mutex> lock(g_pool_mutex);
+
+                                                    g_sweeping = false;
+                                                    release_idle_clients(released);
+                                                    schedule_sweep(); });
+    }
+
+    client_ptr
+    ClientPool::get(std::string_view url, const ClientOptions &options)
+    {
+        // "http://host:port/" and "http://host:port" are the same endpoint
+        while (url.size() > 1 && url.back() == '/')
+            url.remove_suffix(1);
+
+        auto key = pool_key(url, options);
+        vector<shared_ptr<ClientImp>> released;
+        lock_guard<mutex> lock(g_pool_mutex);
+
+        release_idle_clients(released);
+
+        auto iter = g_pool.find(key);
+        if (iter == end(g_pool))
+            iter = g_pool.emplace(move(key), PooledClient{make_shared<ClientImp>(url, options), options.idle_timeout}).first;
+
+        schedule_sweep();
+
+        return iter->second.client;
+    }
+
+    void ClientPool::release_idle()
+    {
+        vector<shared_ptr<ClientImp>> released;
+        lock_guard<mutex> lock(g_pool_mutex);
+
+        release_idle_clients(released);
+    }
+
+    void ClientPool::clear()
+    {
+        map<PoolKey, PooledClient> released;
+        lock_guard<mutex> lock(g_pool_mutex);
+
+        g_pool.swap(released);
     }
 
 }
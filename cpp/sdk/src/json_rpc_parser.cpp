@@ -0,0 +1,567 @@
+#include <json.hpp>
+#include "../include/utils.hpp"
+#include "json_rpc_parser.hpp"
+
+using namespace std;
+
+namespace json_rpc
+{
+    using sax_json = nlohmann::json;
+
+    //
+    //  Decode a hex string into bytes which are resized once
+    //
+    static void decode_hex(string_view hex, vector<uint8_t> &bytes)
+    {
+        if (hex.size() % 2)
+            __throw_runtime_error(fmt("fun : decode_hex, error : odd length ", hex.size()).c_str());
+
+        bytes.resize(hex.size() / 2);
+
+        hex_decode(hex, bytes);
+    }
+    //
+    //  The fields of vm_status, the variant is built when the object ends since "type" may not come first
+    //
+    struct VMStatusFields
+    {
+        string type, location;
+        uint64_t function_index = 0, code_offset = 0, abort_code = 0;
+        VMStatus::MoveAbort::Explanation explanation;
+
+        VMStatus to_vm_status()
+        {
+            VMStatus status;
+
+            if (type == "executed")
+                status.value = VMStatus::Executed{move(type)};
+            else if (type == "execution_failure")
+                status.value = VMStatus::ExecutionFailure{move(type), move(location), function_index, code_offset};
+            else if (type == "out_of_gas")
+                status.value = VMStatus::OutOfGas{move(type)};
+            else if (type == "miscellaneous_error")
+                status.value = VMStatus::MiscellaneousError{move(type)};
+            else if (type == "move_abort")
+                status.value = VMStatus::MoveAbort{move(type), move(location), abort_code, move(explanation)};
+            else
+                throw runtime_error("unknow vm status");
+
+            return status;
+        }
+    };
+    //
+    //  SAX handler, it tracks the path of the current value inside "result" or "error",
+    //  e.g. "vm_status.type" or "[].data.bytes", and writes the value into the response directly
+    //
+    class ReplyHandler : public nlohmann::json_sax<sax_json>
+    {
+        enum class Target
+        {
+            none,
+            result,
+            error
+        };
+
+        span<const Request> _requests;
+        bool _is_batch;
+        Replies &_replies;
+
+        // envelope
+        size_t _depth = 0;
+        size_t _elem_depth;
+        std::string _key;
+        optional<size_t> _id;
+
+        // the sub document of "result" or "error"
+        Target _target = Target::none;
+        bool _pending = false;
+        std::string _path;
+        vector<size_t> _path_lengths;
+
+        Response _response;
+        const Request *_request = nullptr;
+        optional<VMStatusFields> _vm_status;
+        int64_t _error_code = 0;
+        std::string _error_message;
+        bool _has_error = false;
+        bool _has_result = false;
+
+        const Request &current_request()
+        {
+            if (!_is_batch)
+                return _requests[0];
+
+            if (_id)
+            {
+                if (*_id >= _requests.size())
+                    __throw_runtime_error(fmt("fun : batch, error : unknown response id ", *_id).c_str());
+
+                return _requests[*_id];
+            }
+
+            // the id is unknown yet, it does not matter if all requests are the same method
+            for (auto &r : _requests)
+                if (r.index() != _requests[0].index())
+                    throw unordered_reply();
+
+            return _requests[0];
+        }
+        //
+        //  Called for the first value of "result" or "error"
+        //
+        void begin_target(bool is_null)
+        {
+            _pending = false;
+            _path.clear();
+            _path_lengths.clear();
+
+            if (_target == Target::error)
+                return;
+
+            _request = &current_request();
+
+            std::visit(
+                overloaded{[&](const method::GetAccount &)
+                           { _response = is_null ? optional<AccountView>{} : optional<AccountView>{AccountView{}}; },
+                           [&](const method::GetAccountTransaction &)
+                           { _response = is_null ? optional<TransactionView>{} : optional<TransactionView>{TransactionView{}}; },
+                           [&](const method::GetAccountStateWithProof &)
+                           { _response = AccountStateWithProof{}; },
+                           [&](const method::GetEvents &)
+                           { _response = vector<EventView>{}; },
+                           [&](const method::Submit &)
+                           { _response = monostate{}; }},
+                *_request);
+        }
+
+        bool in_target() const { return _target != Target::none && !_pending; }
+
+        void on_string(std::string &val)
+        {
+            if (_target == Target::error)
+            {
+                if (_path == "message")
+                    _error_message = move(val);
+
+                return;
+            }
+
+            std::visit(
+                overloaded{[&](optional<AccountView> &view)
+                           {
+                               if (_path == "address")
+                                   view->address = diem_types::AccountAddress{hex_to_array_u8<16>(val)};
+                           },
+                           [&](optional<TransactionView> &txn)
+                           {
+                               if (_path == "hash")
+                                   txn->hash = move(val);
+                               else if (_path == "bytes")
+                                   txn->bytes = move(val);
+                               else if (_path.starts_with("vm_status."))
+                               {
+                                   auto field = string_view(_path).substr(10);
+
+                                   if (field == "type")
+                                       _vm_status->type = move(val);
+                                   else if (field == "location")
+                                       _vm_status->location = move(val);
+                                   else if (field == "explanation.category")
+                                       _vm_status->explanation.category = move(val);
+                                   else if (field == "explanation.category_description")
+                                       _vm_status->explanation.category_description = move(val);
+                                   else if (field == "explanation.reason")
+                                       _vm_status->explanation.reason = move(val);
+                                   else if (field == "explanation.reason_description")
+                                       _vm_status->explanation.reason_description = move(val);
+                               }
+                               else if (_path.starts_with("transaction."))
+                               {
+                                   auto field = string_view(_path).substr(12);
+                                   auto &data = txn->txn_data;
+
+                                   if (field == "type")
+                                       data.type = move(val);
+                                   else if (field == "sender")
+                                       data.sender = move(val);
+                                   else if (field == "signature_scheme")
+                                       data.signature_scheme = move(val);
+                                   else if (field == "signature")
+                                       data.signature = move(val);
+                                   else if (field == "public_key")
+                                       data.public_key = move(val);
+                                   else if (field == "gas_currency")
+                                       data.gas_currency = move(val);
+                                   else if (field == "script_hash")
+                                       data.script_hash = move(val);
+                                   else if (field == "script_bytes")
+                                       data.script_bytes = move(val);
+                               }
+                               else if (_path.starts_with("events[]."))
+                                   on_event_string(txn->events.back(), string_view(_path).substr(9), val);
+                           },
+                           [&](AccountStateWithProof &asp)
+                           {
+                               if (_path == "blob")
+                                   decode_hex(val, asp.blob);
+                               else if (_path == "proof.ledger_info_to_transaction_info_proof")
+                                   decode_hex(val, asp.proof.ledger_info_to_transaction_info_proof);
+                               else if (_path == "proof.transaction_info")
+                                   decode_hex(val, asp.proof.transaction_info);
+                               else if (_path == "proof.transaction_info_to_account_proof")
+                                   decode_hex(val, asp.proof.transaction_info_to_account_proof);
+                           },
+                           [&](vector<EventView> &events)
+                           {
+                               if (_path.starts_with("[]."))
+                                   on_event_string(events.back(), string_view(_path).substr(3), val);
+                           },
+                           [](monostate) {}},
+                _response);
+        }
+
+        void on_event_string(EventView &event, string_view field, std::string &val)
+        {
+            if (field == "key")
+                event.key = move(val);
+            else if (field == "data.bytes")
+                decode_hex(val, std::get<UnknownEvent>(event.event).bytes);
+        }
+
+        void on_number(uint64_t val)
+        {
+            if (_target == Target::error)
+            {
+                if (_path == "code")
+                    _error_code = int64_t(val);
+
+                return;
+            }
+
+            std::visit(
+                overloaded{[&](optional<AccountView> &view)
+                           {
+                               if (_path == "sequence_number")
+                                   view->sequence_number = val;
+                           },
+                           [&](optional<TransactionView> &txn)
+                           {
+                               if (_path == "version")
+                                   txn->version = val;
+                               else if (_path == "gas_used")
+                                   txn->gas_used = val;
+                               else if (_path == "vm_status.function_index")
+                                   _vm_status->function_index = val;
+                               else if (_path == "vm_status.code_offset")
+                                   _vm_status->code_offset = val;
+                               else if (_path == "vm_status.abort_code")
+                                   _vm_status->abort_code = val;
+                               else if (_path == "transaction.sequence_number")
+                                   txn->txn_data.sequence_number = val;
+                               else if (_path == "transaction.chain_id")
+                                   txn->txn_data.chain_id = uint8_t(val);
+                               else if (_path == "transaction.max_gas_amount")
+                                   txn->txn_data.max_gas_amount = val;
+                               else if (_path == "transaction.gas_unit_price")
+                                   txn->txn_data.gas_unit_price = val;
+                               else if (_path == "transaction.expiration_timestamp_secs")
+                                   txn->txn_data.expiration_timestamp_secs = val;
+                               else if (_path.starts_with("events[]."))
+                                   on_event_number(txn->events.back(), string_view(_path).substr(9), val);
+                           },
+                           [&](AccountStateWithProof &asp)
+                           {
+                               if (_path == "version")
+                                   asp.version = val;
+                           },
+                           [&](vector<EventView> &events)
+                           {
+                               if (_path.starts_with("[]."))
+                                   on_event_number(events.back(), string_view(_path).substr(3), val);
+                           },
+                           [](monostate) {}},
+                _response);
+        }
+
+        void on_event_number(EventView &event, string_view field, uint64_t val)
+        {
+            if (field == "sequence_number")
+                event.sequence_number = val;
+            else if (field == "transaction_version")
+                event.transaction_version = val;
+        }
+
+        void on_start_object()
+        {
+            if (_target != Target::result)
+                return;
+
+            if (auto events = get_if<vector<EventView>>(&_response); events && _path == "[]")
+                events->emplace_back();
+            else if (auto txn = get_if<optional<TransactionView>>(&_response); txn && *txn)
+            {
+                if (_path == "events[]")
+                    (*txn)->events.emplace_back();
+                else if (_path == "vm_status")
+                    _vm_status.emplace();
+            }
+        }
+
+        void on_end_object()
+        {
+            if (_target != Target::result || _path != "vm_status")
+                return;
+
+            if (auto txn = get_if<optional<TransactionView>>(&_response); txn && *txn && _vm_status)
+            {
+                (*txn)->vm_status = _vm_status->to_vm_status();
+                _vm_status.reset();
+            }
+        }
+
+        void end_target()
+        {
+            if (_target == Target::error)
+                _has_error = true;
+            else if (_target == Target::result)
+                _has_result = true;
+
+            _target = Target::none;
+        }
+        //
+        //  Store the response or error of an element when its object ends
+        //
+        void end_element()
+        {
+            size_t index = _is_batch ? _id.value_or(_replies.responses.size()) : 0;
+
+            if (_is_batch && !_id)
+            {
+                // a batch replies a single error without id if it is malformed
+                if (_has_error)
+                    _replies.error = format(R"({"code":%ld,"message":"%s"})", _error_code, _error_message.c_str());
+
+                reset_element();
+                return;
+            }
+
+            if (index >= _replies.responses.size())
+                __throw_runtime_error(fmt("fun : batch, error : unknown response id ", index).c_str());
+
+            if (_has_error)
+                _replies.errors[index] = format(R"({"code":%ld,"message":"%s"})", _error_code, _error_message.c_str());
+            else if (_has_result)
+            {
+                if (_is_batch && _request != &_requests[index])
+                {
+                    // the result was parsed as another method before the id came
+                    if (_request->index() != _requests[index].index())
+                        throw unordered_reply();
+                }
+
+                _replies.responses[index] = move(_response);
+            }
+
+            reset_element();
+        }
+
+        void reset_element()
+        {
+            _id.reset();
+            _has_error = false;
+            _has_result = false;
+            _error_code = 0;
+            _error_message.clear();
+            _request = nullptr;
+        }
+
+        void pop_path()
+        {
+            _path.resize(_path_lengths.back());
+            _path_lengths.pop_back();
+        }
+        //
+        //  Called before a scalar value
+        //
+        bool scalar_begin()
+        {
+            if (_pending)
+            {
+                begin_target(true);
+                end_target();
+                return false;
+            }
+
+            return in_target();
+        }
+
+    public:
+        ReplyHandler(span<const Request> requests, bool is_batch, Replies &replies)
+            : _requests(requests), _is_batch(is_batch), _replies(replies), _elem_depth(is_batch ? 2 : 1)
+        {
+            _replies.responses.resize(requests.size());
+            _replies.errors.resize(requests.size());
+        }
+
+        bool null() override
+        {
+            scalar_begin();
+            return true;
+        }
+
+        bool boolean(bool) override
+        {
+            scalar_begin();
+            return true;
+        }
+
+        bool number_integer(number_integer_t val) override
+        {
+            return number_unsigned(number_unsigned_t(val));
+        }
+
+        bool number_unsigned(number_unsigned_t val) override
+        {
+            if (scalar_begin())
+                on_number(val);
+            else if (_depth == _elem_depth && _target == Target::none)
+            {
+                if (_key == "id")
+                    _id = size_t(val);
+                else if (_key == "diem_ledger_version")
+                {
+                    if (_replies.ledger_version == 0 || val < _replies.ledger_version)
+                        _replies.ledger_version = val;
+                }
+            }
+
+            return true;
+        }
+
+        bool number_float(number_float_t, const string_t &) override
+        {
+            scalar_begin();
+            return true;
+        }
+
+        bool string(string_t &val) override
+        {
+            if (scalar_begin())
+                on_string(val);
+
+            return true;
+        }
+
+        bool binary(binary_t &) override
+        {
+            return true;
+        }
+
+        bool start_object(std::size_t) override
+        {
+            // a malformed batch is replied with a single error object
+            if (_depth == 0 && _is_batch)
+                _elem_depth = 1;
+
+            if (_pending)
+                begin_target(false);
+
+            if (in_target())
+            {
+                on_start_object();
+                _path_lengths.push_back(_path.size());
+            }
+
+            _depth++;
+
+            return true;
+        }
+
+        bool key(string_t &val) override
+        {
+            if (in_target())
+            {
+                // replace the last key of the object
+                _path.resize(_path_lengths.back());
+                if (!_path.empty())
+                    _path += '.';
+                _path += val;
+            }
+            else if (_depth == _elem_depth)
+            {
+                _key = move(val);
+
+                if (_key == "result")
+                    _target = Target::result, _pending = true;
+                else if (_key == "error")
+                    _target = Target::error, _pending = true;
+            }
+
+            return true;
+        }
+
+        bool end_object() override
+        {
+            _depth--;
+
+            if (in_target())
+            {
+                pop_path();
+                on_end_object();
+
+                if (_path_lengths.empty())
+                    end_target();
+            }
+            else if (_depth == _elem_depth - 1)
+                end_element();
+
+            return true;
+        }
+
+        bool start_array(std::size_t) override
+        {
+            if (_pending)
+                begin_target(false);
+
+            if (in_target())
+            {
+                _path_lengths.push_back(_path.size());
+                _path += "[]";
+            }
+
+            _depth++;
+
+            return true;
+        }
+
+        bool end_array() override
+        {
+            _depth--;
+
+            if (in_target())
+            {
+                pop_path();
+
+                if (_path_lengths.empty())
+                    end_target();
+            }
+
+            return true;
+        }
+
+        bool parse_error(std::size_t position, const std::string &, const nlohmann::detail::exception &ex) override
+        {
+            __throw_runtime_error(fmt("fun : parse_replies, error : ", ex.what(), " at ", position).c_str());
+        }
+    };
+
+    Replies parse_replies(span<const Request> requests, string_view body, bool is_batch)
+    {
+        Replies replies;
+        ReplyHandler handler(requests, is_batch, replies);
+
+        sax_json::sax_parse(body.begin(), body.end(), &handler);
+
+        return replies;
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include "../include/json_rpc.hpp"
+
+namespace json_rpc
+{
+    //
+    //  The responses of a JSON-RPC request or batch parsed in one pass
+    //
+    struct Replies
+    {
+        std::vector<std::optional<Response>> responses; // indexed by request id
+        std::vector<std::string> errors;                // the JSON-RPC error of each request, empty if none
+        std::string error;                              // the error of a whole batch
+        uint64_t ledger_version = 0;                    // the smallest diem_ledger_version, 0 if unknown
+    };
+    //
+    //  Thrown if a batch response has "result" before "id", the DOM parser has to be used for it
+    //
+    class unordered_reply : public std::runtime_error
+    {
+    public:
+        unordered_reply() : std::runtime_error("the result of batch response comes before its id") {}
+    };
+    /**
+     * @brief Parse the body of a JSON-RPC response with a SAX parser, the results are built directly
+     *        without an intermediate DOM and the hex fields are decoded straight into byte buffers
+     *
+     * @param requests  the request, or the requests of a batch whose ids are their indexes
+     * @param body      the HTTP body of response
+     * @param is_batch  whether the body is the response of a batch
+     * @return Replies
+     */
+    Replies parse_replies(std::span<const Request> requests, std::string_view body, bool is_batch);
+}
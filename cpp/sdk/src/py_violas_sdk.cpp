@@ -3,6 +3,7 @@
 #include <iomanip>
 #include <boost/python.hpp>
 #include <boost/python/suite/indexing/vector_indexing_suite.hpp>
+#include "../include/hex_codec.hpp"
 
 using namespace std;
 using namespace violas;
@@ -531,12 +532,7 @@ public:
 template <size_t N>
 std::ostream &operator<<(std::ostream &os, const std::array<uint8_t, N> &bytes)
 {
-    for (auto v : bytes)
-    {
-        os << std::setfill('0') << std::setw(2) << std::hex << (int)v;
-    }
-
-    return os << std::dec;
+    return os << hex_encode(bytes);
 }
 
 template <typename T>
@@ -0,0 +1,127 @@
+#include <ctime>
+#include <algorithm>
+#include "sequence_number_manager.hpp"
+
+using namespace std;
+
+namespace violas
+{
+    SequenceNumberManager::SequenceNumberManager(fetcher fetch) : _fetch(move(fetch))
+    {
+    }
+
+    shared_ptr<SequenceNumberManager::Sender> SequenceNumberManager::get_sender(const diem_types::AccountAddress &address)
+    {
+        lock_guard<mutex> lock(_mutex);
+
+        auto &sender = _senders[address.value];
+        if (!sender)
+            sender = make_shared<Sender>();
+
+        return sender;
+    }
+    //
+    //  Synchronize with the sequence number on chain, the caller must hold the lock of sender
+    //
+    void SequenceNumberManager::sync(const diem_types::AccountAddress &address, Sender &sender)
+    {
+        uint64_t on_chain = _fetch(address);
+        uint64_t now = time(nullptr);
+
+        // the transactions below the number on chain were executed
+        sender.in_flight.erase(begin(sender.in_flight), sender.in_flight.lower_bound(on_chain));
+        sender.gaps.erase(begin(sender.gaps), sender.gaps.lower_bound(on_chain));
+
+        // the transactions submitted by other processes
+        sender.next = max(sender.next, on_chain);
+
+        // the expired transactions will never be executed, their numbers become gaps
+        for (auto iter = begin(sender.in_flight); iter != end(sender.in_flight);)
+        {
+            if (iter->second < now)
+            {
+                sender.gaps.insert(iter->first);
+                iter = sender.in_flight.erase(iter);
+            }
+            else
+                ++iter;
+        }
+
+        // the gaps at the end are not needed to be filled
+        while (!sender.gaps.empty() && *sender.gaps.rbegin() == sender.next - 1)
+        {
+            sender.gaps.erase(prev(end(sender.gaps)));
+            sender.next--;
+        }
+
+        sender.synced = true;
+    }
+
+    uint64_t SequenceNumberManager::reserve(const diem_types::AccountAddress &address, uint64_t expiration_timestamp_secs)
+    {
+        auto sender = get_sender(address);
+        lock_guard<mutex> lock(sender->mutex);
+
+        // resync if a transaction in flight expired
+        bool expired = any_of(begin(sender->in_flight), end(sender->in_flight),
+                              [now = uint64_t(time(nullptr))](const auto &t)
+                              { return t.second < now; });
+
+        if (!sender->synced || expired)
+            sync(address, *sender);
+
+        uint64_t sn;
+
+        if (!sender->gaps.empty())
+        {
+            sn = *begin(sender->gaps);
+            sender->gaps.erase(begin(sender->gaps));
+        }
+        else
+            sn = sender->next++;
+
+        sender->in_flight[sn] = expiration_timestamp_secs;
+
+        return sn;
+    }
+
+    void SequenceNumberManager::commit(const diem_types::AccountAddress &address, uint64_t sequence_number)
+    {
+        auto sender = get_sender(address);
+        lock_guard<mutex> lock(sender->mutex);
+
+        // the transactions are executed in order, all the numbers below have been used
+        sender->in_flight.erase(begin(sender->in_flight), sender->in_flight.upper_bound(sequence_number));
+        sender->gaps.erase(begin(sender->gaps), sender->gaps.upper_bound(sequence_number));
+
+        sender->next = max(sender->next, sequence_number + 1);
+    }
+
+    void SequenceNumberManager::fail(const diem_types::AccountAddress &address, uint64_t sequence_number)
+    {
+        auto sender = get_sender(address);
+        lock_guard<mutex> lock(sender->mutex);
+
+        if (sender->in_flight.erase(sequence_number) && sequence_number < sender->next)
+            sender->gaps.insert(sequence_number);
+
+        // the failure may be caused by the transactions from other processes
+        sender->synced = false;
+    }
+
+    void SequenceNumberManager::resync(const diem_types::AccountAddress &address)
+    {
+        auto sender = get_sender(address);
+        lock_guard<mutex> lock(sender->mutex);
+
+        sender->synced = false;
+    }
+
+    size_t SequenceNumberManager::in_flight(const diem_types::AccountAddress &address)
+    {
+        auto sender = get_sender(address);
+        lock_guard<mutex> lock(sender->mutex);
+
+        return sender->in_flight.size();
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <array>
+#include <map>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <diem_types.hpp>
+
+namespace violas
+{
+    /**
+     * @brief Thread safe allocator of sequence numbers for the senders of transactions,
+     *        it allows many transactions of an account to be in mempool at the same time.
+     *
+     *  The numbers of a sender are reserved locally without querying the chain. A transaction which is rejected or
+     *  expired leaves a gap, which is filled by the next reservation since the transactions after the gap cannot be
+     *  executed until the gap is filled. A transaction whose outcome is unknown, e.g. after a transport error, keeps
+     *  its number in flight, it becomes a gap only if it expired and the number on chain has not passed it.
+     *  The sender is resynchronized with the chain when it is used at first, after a failure, or when an in-flight
+     *  transaction expired.
+     */
+    class SequenceNumberManager
+    {
+    public:
+        // fetch the sequence number of an account on chain, throw if the account doesn't exist
+        using fetcher = std::function<uint64_t(const diem_types::AccountAddress &)>;
+
+        explicit SequenceNumberManager(fetcher fetch);
+
+        /**
+         * @brief Reserve a sequence number for a transaction of sender
+         *
+         * @param sender                        the address of sender
+         * @param expiration_timestamp_secs     the expiration time of transaction
+         * @return uint64_t the sequence number
+         */
+        uint64_t reserve(const diem_types::AccountAddress &sender, uint64_t expiration_timestamp_secs);
+        //
+        //  The transaction has been executed, whatever its VM status is
+        //
+        void commit(const diem_types::AccountAddress &sender, uint64_t sequence_number);
+        //
+        //  The transaction was rejected by the node and will never be executed, its sequence number is reused
+        //  and the sender is resynchronized. Don't call it if the transaction may still be in mempool.
+        //
+        void fail(const diem_types::AccountAddress &sender, uint64_t sequence_number);
+        //
+        //  Resynchronize the sender with the chain at the next reservation, the numbers in flight are kept until they
+        //  are executed or expired, e.g. when the outcome of a submission is unknown
+        //
+        void resync(const diem_types::AccountAddress &sender);
+        //
+        //  The number of transactions which were reserved but not yet executed or failed
+        //
+        size_t in_flight(const diem_types::AccountAddress &sender);
+
+    private:
+        struct Sender
+        {
+            std::mutex mutex;
+            bool synced = false;
+            uint64_t next = 0;                       // the next number after all reserved
+            std::map<uint64_t, uint64_t> in_flight;  // sequence number -> expiration timestamp
+            std::set<uint64_t> gaps;                 // the numbers below next which are not in flight
+        };
+
+        fetcher _fetch;
+        std::mutex _mutex;
+        std::map<std::array<uint8_t, 16>, std::shared_ptr<Sender>> _senders; // keyed by the value of address
+
+        std::shared_ptr<Sender> get_sender(const diem_types::AccountAddress &address);
+
+        void sync(const diem_types::AccountAddress &address, Sender &sender);
+    };
+}
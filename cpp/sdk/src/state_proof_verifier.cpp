@@ -0,0 +1,293 @@
+#include <algorithm>
+#include <stdexcept>
+#include <mutex>
+#include "../include/state_proof_verifier.hpp"
+#include "../include/signing_message.hpp"
+
+using namespace std;
+
+namespace violas
+{
+    using Hash = StateProofVerifier::Hash;
+
+    // the proofs are longer for more leaves, a longer one is malformed
+    static const size_t MAX_ACCUMULATOR_PROOF_DEPTH = 63;
+    static const size_t HASH_LENGTH_IN_BITS = 256;
+    // the verified nodes and accounts of a ledger are dropped beyond it
+    static const size_t MAX_CACHED_ITEMS = 1 << 16;
+    //
+    //  The CryptoHash of Diem for the raw bytes, sha3_256(sha3_256("DIEM::" + type name) || a || b)
+    //
+    static Hash hash_bytes(string_view type_name, span<const uint8_t> a, span<const uint8_t> b = {})
+    {
+        thread_local Sha3Hasher hasher;
+
+        return hasher.update(SigningMessage::prefix(type_name)).update(a).update(b).finalize();
+    }
+    //
+    //  The hash of a literal word padded with zeros, such as the placeholder of empty subtree
+    //
+    static Hash literal_hash(string_view word)
+    {
+        Hash hash{};
+        copy(begin(word), end(word), begin(hash));
+
+        return hash;
+    }
+
+    static Hash to_hash(proof::HashValue bytes)
+    {
+        Hash hash;
+
+        if (bytes.size() != hash.size())
+            __throw_runtime_error("state proof: the length of HashValue is not 32");
+
+        copy(begin(bytes), end(bytes), begin(hash));
+
+        return hash;
+    }
+    //
+    //  Decode the BCS bytes of a proof, the extra bytes are not allowed if exact
+    //
+    template <typename T>
+    static T decode(span<const uint8_t> bytes, bool exact = true)
+    {
+        T t;
+
+        try
+        {
+            BcsSerde bs(bytes);
+            bs &&t;
+
+            if (exact && bs.remaining() != 0)
+                __throw_runtime_error("state proof: extra bytes after proof");
+        }
+        catch (const serde::deserialization_error &e)
+        {
+            __throw_runtime_error((string("state proof: ") + e.what()).c_str());
+        }
+
+        return t;
+    }
+
+    static bool bit_of(const Hash &key, size_t index)
+    {
+        return (key[index / 8] >> (7 - index % 8)) & 1;
+    }
+
+    StateProofVerifier::StateProofVerifier(size_t max_ledgers) : _max_ledgers(max(max_ledgers, size_t(1)))
+    {
+    }
+
+    void StateProofVerifier::trust(uint64_t version, const Hash &accumulator_root_hash)
+    {
+        unique_lock lock(_mutex);
+
+        auto &ledger = _ledgers[version];
+
+        // the cached nodes are for the previous root hash
+        if (ledger.accumulator_root_hash != accumulator_root_hash)
+            ledger = Ledger{accumulator_root_hash};
+
+        while (_ledgers.size() > _max_ledgers)
+            _ledgers.erase(begin(_ledgers));
+    }
+
+    optional<uint64_t> StateProofVerifier::latest_version()
+    {
+        shared_lock lock(_mutex);
+
+        if (_ledgers.empty())
+            return nullopt;
+        else
+            return rbegin(_ledgers)->first;
+    }
+
+    void StateProofVerifier::verify(const diem_types::AccountAddress &address,
+                                    uint64_t version,
+                                    uint64_t ledger_version,
+                                    const json_rpc::AccountStateWithProof &asp)
+    {
+        if (version > ledger_version)
+            __throw_runtime_error("state proof: the state version is newer than the ledger version");
+
+        // a node may reply an older state with its genuine proof
+        if (asp.version != version)
+            __throw_runtime_error("state proof: the state is not at the version requested");
+
+        // the blob is the BCS bytes of AccountStateBlob, whose hash is of the bytes inside
+        optional<Hash> value_hash;
+        if (!asp.blob.empty())
+            value_hash = hash_bytes("AccountStateBlob", decode<span<const uint8_t>>(asp.blob));
+
+        {
+            shared_lock lock(_mutex);
+
+            auto iter = _ledgers.find(ledger_version);
+            if (iter == end(_ledgers))
+                __throw_runtime_error("state proof: the ledger version is not trusted");
+
+            auto &accounts = iter->second.accounts;
+            auto account = accounts.find(address.value);
+
+            if (account != end(accounts) && account->second == make_tuple(asp.version, value_hash))
+                return;
+        }
+
+        auto txn_info = decode<proof::TransactionInfoHead>(asp.proof.transaction_info, false);
+        auto state_proof = decode<proof::SparseMerkleProof>(asp.proof.transaction_info_to_account_proof);
+        auto accumulator_proof = decode<proof::AccumulatorProof>(asp.proof.ledger_info_to_transaction_info_proof);
+
+        verify_sparse_merkle(to_hash(txn_info.state_root_hash),
+                             hash_bytes("AccountAddress", address.value),
+                             value_hash,
+                             state_proof);
+
+        verify_accumulator(ledger_version,
+                           hash_bytes("TransactionInfo", asp.proof.transaction_info),
+                           asp.version,
+                           accumulator_proof);
+
+        unique_lock lock(_mutex);
+
+        auto iter = _ledgers.find(ledger_version);
+        if (iter != end(_ledgers))
+        {
+            auto &accounts = iter->second.accounts;
+
+            if (accounts.size() >= MAX_CACHED_ITEMS)
+                accounts.clear();
+
+            accounts.insert_or_assign(address.value, make_tuple(asp.version, value_hash));
+        }
+    }
+
+    void StateProofVerifier::verify_accumulator(uint64_t ledger_version, const Hash &leaf_hash, uint64_t leaf_index,
+                                                const proof::AccumulatorProof &proof)
+    {
+        auto &siblings = proof.siblings;
+
+        if (siblings.size() > MAX_ACCUMULATOR_PROOF_DEPTH)
+            __throw_runtime_error("state proof: the accumulator proof is too long");
+
+        // the nodes on the path and their siblings, which are verified if the root hash matches
+        vector<pair<NodeId, Hash>> path;
+        path.reserve(siblings.size() * 2 + 1);
+
+        {
+            shared_lock lock(_mutex);
+
+            auto iter = _ledgers.find(ledger_version);
+            if (iter == end(_ledgers))
+                __throw_runtime_error("state proof: the ledger version is not trusted");
+
+            auto &ledger = iter->second;
+            auto hash = leaf_hash;
+            auto index = leaf_index;
+            bool is_verified = false;
+
+            for (uint32_t level = 0; level <= siblings.size(); level++)
+            {
+                // stop at a node verified by a previous proof
+                auto node = ledger.nodes.find(NodeId{level, index});
+                if (node != end(ledger.nodes))
+                {
+                    if (node->second != hash)
+                        __throw_runtime_error("state proof: the accumulator proof doesn't match the verified node");
+
+                    is_verified = true;
+                    break;
+                }
+
+                path.emplace_back(NodeId{level, index}, hash);
+
+                if (level == siblings.size())
+                    break;
+
+                auto sibling = to_hash(siblings[level]);
+                path.emplace_back(NodeId{level, index ^ 1}, sibling);
+
+                if (index % 2 == 0)
+                    hash = hash_bytes("TransactionAccumulator", hash, sibling);
+                else
+                    hash = hash_bytes("TransactionAccumulator", sibling, hash);
+
+                index /= 2;
+            }
+
+            // the leaf must be in the tree of root, not only be hashed to the same root with its lower bits
+            if (!is_verified && (index != 0 || hash != ledger.accumulator_root_hash))
+                __throw_runtime_error("state proof: the root hash of accumulator doesn't match");
+        }
+
+        unique_lock lock(_mutex);
+
+        auto iter = _ledgers.find(ledger_version);
+        if (iter != end(_ledgers))
+        {
+            auto &nodes = iter->second.nodes;
+
+            if (nodes.size() + path.size() > MAX_CACHED_ITEMS)
+                nodes.clear();
+
+            nodes.insert(begin(path), end(path));
+        }
+    }
+
+    void StateProofVerifier::verify_sparse_merkle(const Hash &expected_root_hash, const Hash &key,
+                                                  const optional<Hash> &value_hash,
+                                                  const proof::SparseMerkleProof &proof)
+    {
+        static const Hash PLACEHOLDER_HASH = literal_hash("SPARSE_MERKLE_PLACEHOLDER_HASH");
+        auto &siblings = proof.siblings;
+
+        if (siblings.size() > HASH_LENGTH_IN_BITS)
+            __throw_runtime_error("state proof: the sparse Merkle proof is too long");
+
+        Hash hash = PLACEHOLDER_HASH;
+
+        if (proof.leaf)
+        {
+            auto leaf_key = to_hash(proof.leaf->key);
+            auto leaf_value_hash = to_hash(proof.leaf->value_hash);
+
+            if (value_hash)
+            {
+                if (leaf_key != key || leaf_value_hash != *value_hash)
+                    __throw_runtime_error("state proof: the leaf of sparse Merkle proof is another account state");
+            }
+            else
+            {
+                // the leaf of another key takes the place of the key, so they share the prefix of path
+                if (leaf_key == key)
+                    __throw_runtime_error("state proof: the account exists in the sparse Merkle proof");
+
+                auto mismatch_bytes = mismatch(begin(key), end(key), begin(leaf_key));
+                size_t common_prefix_bits = (mismatch_bytes.first - begin(key)) * 8;
+                while (bit_of(key, common_prefix_bits) == bit_of(leaf_key, common_prefix_bits))
+                    common_prefix_bits++;
+
+                if (common_prefix_bits < siblings.size())
+                    __throw_runtime_error("state proof: the leaf of sparse Merkle proof is not on the path of account");
+            }
+
+            hash = hash_bytes("SparseMerkleLeafNode", leaf_key, leaf_value_hash);
+        }
+        else if (value_hash)
+            __throw_runtime_error("state proof: the sparse Merkle proof is a non-inclusion proof");
+
+        // the bits of key from the bottom level to the root level
+        for (size_t i = 0; i < siblings.size(); i++)
+        {
+            auto sibling = to_hash(siblings[i]);
+
+            if (bit_of(key, siblings.size() - 1 - i))
+                hash = hash_bytes("SparseMerkleInternal", sibling, hash);
+            else
+                hash = hash_bytes("SparseMerkleInternal", hash, sibling);
+        }
+
+        if (hash != expected_root_hash)
+            __throw_runtime_error("state proof: the state root hash doesn't match");
+    }
+}
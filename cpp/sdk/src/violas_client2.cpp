@@ -1,6 +1,7 @@
 #include <fstream>
 #include <filesystem>
 #include <iterator>
+#include <list>
 #include <algorithm>
 #include <diem_framework.hpp>
 #include <optional>
@@ -12,26 +13,147 @@
 
 #include "../include/json_rpc.hpp"
 #include "wallet.hpp"
+#include "sequence_number_manager.hpp"
+#include "confirmation_tracker.hpp"
+#include "account_state_cache.hpp"
+#include "../include/signing_message.hpp"
+#include "../include/state_proof_verifier.hpp"
 
 using namespace std;
 using namespace crypto;
 
 namespace violas
 {
-    AccountState2::AccountState2(const std::string &hex)
+    AccountState2::AccountState2(const std::string &hex) : AccountState2(hex_to_bytes(hex))
     {
-        auto bytes = hex_to_bytes(hex);
+    }
+
+    AccountState2::AccountState2(std::vector<uint8_t> bytes)
+        : _blob(make_shared<const vector<uint8_t>>(move(bytes))), _index(make_shared<Index>())
+    {
+    }
+
+    AccountState2::Bytes AccountState2::resource_path(const dt::StructTag &tag)
+    {
+        // most of lookups are for a few tags, comparing a tag is cheaper than serializing it
+        static const size_t MAX_PATHS = 32;
+        thread_local list<pair<dt::StructTag, vector<uint8_t>>> paths;
+
+        auto iter = find_if(begin(paths), end(paths), [&](const auto &path)
+                            { return path.first == tag; });
 
-        // Deserialize to vector
-        vector<uint8_t> data;
+        if (iter != end(paths))
+            paths.splice(begin(paths), paths, iter);
+        else
         {
-            BcsSerde serde(move(bytes));
-            serde &&data;
+            paths.emplace_front(tag, ResourcePath{tag}.bcsSerialize());
+
+            if (paths.size() > MAX_PATHS)
+                paths.pop_back();
         }
 
-        BcsSerde serde(move(data));
+        return paths.front().second;
+    }
+
+    optional<AccountState2::Bytes> AccountState2::find(Bytes path) const
+    {
+        auto &index = *_index;
+
+        call_once(index.built, [&]
+                  {
+                      // the blob is the BCS bytes of the map from path to resource
+                      Bytes data;
+                      {
+                          BcsSerde bs{Bytes(*_blob)};
+                          bs &&data;
+                      }
+
+                      // a map is encoded as a sequence of key and value pairs, which are sorted by key if canonical
+                      BcsSerde bs(data);
+                      bs &&index.resources;
+
+                      auto less = [](const auto &a, const auto &b)
+                      { return lexicographical_compare(begin(a.first), end(a.first), begin(b.first), end(b.first)); };
+
+                      if (!is_sorted(begin(index.resources), end(index.resources), less))
+                          sort(begin(index.resources), end(index.resources), less);
+                  });
+
+        auto iter = lower_bound(begin(index.resources), end(index.resources), path,
+                                [](const auto &resource, Bytes path)
+                                { return lexicographical_compare(begin(resource.first), end(resource.first), begin(path), end(path)); });
+
+        if (iter != end(index.resources) && equal(begin(iter->first), end(iter->first), begin(path), end(path)))
+            return iter->second;
+        else
+            return nullopt;
+    }
+
+    static void throw_if_not_executed(const json_rpc::VMStatus &vm_status, string_view error_info)
+    {
+        using namespace json_rpc;
+
+        std::visit(
+            overloaded{[](VMStatus::Executed status) {},
+                       [=](VMStatus::ExecutionFailure status)
+                       {
+                           ostringstream oss;
+
+                           oss << error_info << " error, "
+                               << "vm_status : {\n"
+                               << "type : " << status.type << ", "
+                               << "location : " << status.location << ", \n"
+                               << "function index : " << status.function_index << ", \n"
+                               << "code offset : " << status.code_offset << ", \n"
+                               << "}";
+
+                           __throw_runtime_error(oss.str().c_str());
+                       },
+                       [](VMStatus::OutOfGas status)
+                       {
+                           __throw_runtime_error(status.type.c_str());
+                       },
+                       [=](VMStatus::MiscellaneousError status)
+                       {
+                           ostringstream oss;
+                           oss << error_info << " failed, VM status : " << status.type;
+
+                           __throw_runtime_error(oss.str().c_str());
+                       },
+                       [=](VMStatus::MoveAbort status)
+                       {
+                           ostringstream oss;
+
+                           oss << error_info << " error, "
+                               << "vm_status : { "
+                               << "type : " << status.type << ", "
+                               << "abort code : " << status.abort_code
+                               << " }";
+
+                           __throw_runtime_error(oss.str().c_str());
+                       }},
+            vm_status.value);
+    }
+
+    //
+    //  Sign a raw transaction with the Ed25519 key of sender
+    //
+    static diem_types::SignedTransaction sign_txn(ed25519::PrivateKey &priv_key, diem_types::RawTransaction &&raw_txn)
+    {
+        using namespace diem_types;
+        SignedTransaction signed_txn;
+
+        signed_txn.raw_txn = move(raw_txn);
+
+        auto &message = SigningMessage::local().raw_txn(signed_txn.raw_txn);
 
-        serde &&_resources;
+        ed25519::Signature signature = priv_key.sign(message.data(), message.size());
+
+        signed_txn.authenticator.value = TransactionAuthenticator::Ed25519{
+            Ed25519PublicKey{u8_array_to_vector(priv_key.get_public_key().get_raw_key())},
+            Ed25519Signature{u8_array_to_vector(signature)}};
+
+        return signed_txn;
     }
 
     class Client2Imp : public Client2
@@ -45,12 +167,146 @@ namespace violas
         // Account Root, Treasure Complaince, Test Designated Dealer
         optional<ed25519::PrivateKey> m_opt_root, m_opt_tc, m_opt_dd;
 
-        map<size_t, json_rpc::AccountView> m_accounts;
+        // the addresses of accounts created by create_next_account
+        map<size_t, diem_types::AccountAddress> m_accounts;
+        // the indices of the accounts created with a specified address
+        unordered_map<array<uint8_t, 16>, size_t, Wallet::BytesHash> m_specified_addresses;
+        mutex m_accounts_mutex;
+
+        // allocate the sequence numbers of senders
+        SequenceNumberManager m_seq_numbers;
+
+        // wait for the transactions to be executed
+        shared_ptr<ConfirmationTracker> m_tracker;
+        //
+        //  The tracker runs its timers on its own thread, so that it is never starved by the callers blocking
+        //  in check_txn_vm_status on the default executor
+        //
+        static Executor &tracker_executor()
+        {
+            static Executor executor(1);
+            return executor;
+        }
+
+        // the states of accounts read recently
+        AccountStateCache m_states;
+
+        ed25519::PrivateKey get_private_key(size_t account_index)
+        {
+            if (account_index == ACCOUNT_ROOT_ID)
+                return m_opt_root.value();
+            else if (account_index == ACCOUNT_TC_ID)
+                return m_opt_tc.value();
+            else if (account_index == ACCOUNT_DD_ID)
+                return m_opt_dd.value();
+            else
+                return m_wallet->get_account_priv_key(account_index);
+        }
+        //
+        //  Build a raw transaction and reserve a sequence number for it
+        //
+        diem_types::RawTransaction make_raw_txn(size_t account_index,
+                                                diem_types::TransactionPayload &&txn_paylod,
+                                                uint64_t max_gas_amount,
+                                                uint64_t gas_unit_price,
+                                                std::string_view gas_currency_code,
+                                                uint64_t expiration_timestamp_secs)
+        {
+            diem_types::RawTransaction raw_txn;
+
+            raw_txn.payload = move(txn_paylod);
+            raw_txn.sender = get_account_address(account_index);
+            raw_txn.max_gas_amount = max_gas_amount;
+            raw_txn.gas_unit_price = gas_unit_price;
+            raw_txn.gas_currency_code = gas_currency_code;
+            raw_txn.expiration_timestamp_secs = time(nullptr) + expiration_timestamp_secs;
+            raw_txn.chain_id = diem_types::ChainId{m_chain_id};
+            raw_txn.sequence_number = m_seq_numbers.reserve(raw_txn.sender, raw_txn.expiration_timestamp_secs);
 
-        uint64_t get_sequence_number(size_t account_index)
+            return raw_txn;
+        }
+        static AccountStateCache::Fetched make_fetched(json_rpc::AccountStateWithProof &&asp)
         {
-            auto accounts = m_wallet->get_all_accounts();
-            return m_rpc_cli->get_account(accounts[account_index].address)->sequence_number;
+            if (asp.blob.empty())
+                return {asp.version, nullopt, 0};
+
+            AccountState2 state(move(asp.blob));
+            size_t bytes = state.memory_bytes();
+
+            return {asp.version, move(state), bytes};
+        }
+        //
+        //  Drop the cached states of the accounts which a transaction may change
+        //
+        void invalidate_account_states(const diem_types::SignedTransaction &signed_txn)
+        {
+            m_states.invalidate(signed_txn.raw_txn.sender);
+
+            if (auto multi_agent = get_if<diem_types::TransactionAuthenticator::MultiAgent>(&signed_txn.authenticator.value))
+            {
+                for (auto &address : multi_agent->secondary_signer_addresses)
+                    m_states.invalidate(address);
+            }
+
+            auto &payload = signed_txn.raw_txn.payload.value;
+
+            if (auto script = get_if<diem_types::TransactionPayload::Script>(&payload))
+            {
+                for (auto &arg : script->value.args)
+                {
+                    if (auto address = get_if<diem_types::TransactionArgument::Address>(&arg.value))
+                        m_states.invalidate(address->value);
+                }
+            }
+            else if (auto script_fun = get_if<diem_types::TransactionPayload::ScriptFunction>(&payload))
+            {
+                // the arguments are BCS bytes without types, the 16 bytes ones are taken as addresses
+                for (auto &arg : script_fun->value.args)
+                {
+                    if (arg.size() == sizeof(diem_types::AccountAddress::value))
+                    {
+                        diem_types::AccountAddress address;
+                        copy(begin(arg), end(arg), begin(address.value));
+                        m_states.invalidate(address);
+                    }
+                }
+            }
+        }
+        //
+        //  The sequence number is given back only if the node rejected the submission. After a transport error or
+        //  timeout the transaction may be in mempool, so the number stays in flight until it is executed or expires.
+        //
+        void on_submit_failed(const diem_types::AccountAddress &sender, uint64_t sequence_number, exception_ptr e)
+        {
+            try
+            {
+                rethrow_exception(e);
+            }
+            catch (const json_rpc::RpcError &)
+            {
+                m_seq_numbers.fail(sender, sequence_number);
+            }
+            catch (...)
+            {
+                m_seq_numbers.resync(sender);
+            }
+        }
+        //
+        //  Submit a signed transaction, its sequence number is given back if the node rejected it
+        //
+        void submit(const diem_types::SignedTransaction &signed_txn)
+        {
+            invalidate_account_states(signed_txn);
+
+            try
+            {
+                m_rpc_cli->submit(signed_txn);
+            }
+            catch (...)
+            {
+                on_submit_failed(signed_txn.raw_txn.sender, signed_txn.raw_txn.sequence_number, current_exception());
+                throw;
+            }
         }
 
     public:
@@ -58,9 +314,21 @@ namespace violas
                    uint8_t chain_id,
                    std::string_view mnemonic_file,
                    std::string_view mint_key_file)
+            : m_seq_numbers([this](const diem_types::AccountAddress &address)
+                            {
+                                auto opt_account_view = m_rpc_cli->get_account(address);
+                                if (!opt_account_view.has_value())
+                                    __throw_runtime_error("Account index does not exist.");
+
+                                return opt_account_view->sequence_number; }),
+              m_states([this](const diem_types::AccountAddress &address)
+                       {
+                           json_rpc::AccountStateWithProof asp = m_rpc_cli->get_account_state_blob(bytes_to_hex(address.value));
+                           return make_fetched(move(asp)); })
         {
-            m_rpc_cli = json_rpc::Client::create(url);
+            m_rpc_cli = json_rpc::ClientPool::get(url);
             m_chain_id = chain_id;
+            m_tracker = make_shared<ConfirmationTracker>(m_rpc_cli, ConfirmationOptions{}, tracker_executor());
 
             ifstream ifs(mnemonic_file.data());
             if (ifs.fail())
@@ -98,18 +366,6 @@ namespace violas
                     copy(begin(buf) + 1, begin(buf) + 33, begin(raw_key));
 
                     m_opt_root = m_opt_tc = m_opt_dd = ed25519::PrivateKey::from_raw_key(raw_key);
-
-                    auto root_account_view = m_rpc_cli->get_account(ROOT_ADDRESS);
-                    if (root_account_view.has_value())
-                        m_accounts[ACCOUNT_ROOT_ID] = *root_account_view;
-
-                    auto tc_account_view = m_rpc_cli->get_account(TC_ADDRESS);
-                    if (tc_account_view.has_value())
-                        m_accounts[ACCOUNT_TC_ID] = *tc_account_view;
-
-                    auto dd_account_view = m_rpc_cli->get_account(TESTNET_DD_ADDRESS);
-                    if (dd_account_view.has_value())
-                        m_accounts[ACCOUNT_DD_ID] = *dd_account_view;
                 }
             }
         }
@@ -127,16 +383,12 @@ namespace violas
             if (opt_address.has_value())
                 address = *opt_address;
 
-            auto opt_account_view = m_rpc_cli->get_account(address);
-            if (opt_account_view.has_value())
-                m_accounts[index] = *opt_account_view;
-            else
             {
-                json_rpc::AccountView view;
-                view.address = address;
-                view.sequence_number = 0;
+                lock_guard<mutex> lock(m_accounts_mutex);
+                m_accounts[index] = address;
 
-                m_accounts[index] = view;
+                if (opt_address.has_value())
+                    m_specified_addresses[address.value] = index;
             }
 
             return make_tuple<>(index, address);
@@ -145,6 +397,7 @@ namespace violas
         virtual void
         update_account_info(size_t account_index) override
         {
+            m_seq_numbers.resync(get_account_address(account_index));
         }
 
         virtual std::vector<Wallet::Account>
@@ -152,100 +405,75 @@ namespace violas
         {
             return m_wallet->get_all_accounts();
         }
-        //
-        // submit a script and return sequence number of sender's account
-        //
-        std::tuple<dt::AccountAddress, uint64_t>
-        submit_txn_paylod(size_t account_index,
-                          diem_types::TransactionPayload &&txn_paylod,
-                          uint64_t max_gas_amount = 1'000'000,
-                          uint64_t gas_unit_price = 0,
-                          std::string_view gas_currency_code = "VLS",
-                          uint64_t expiration_timestamp_secs = 100)
-        {
-            using namespace diem_types;
-            SignedTransaction signed_txn;
-            RawTransaction &raw_txn = signed_txn.raw_txn;
-
-            raw_txn.payload = txn_paylod;
 
-            auto iter = m_accounts.find(account_index);
-            if (iter != end(m_accounts))
-            {
-                raw_txn.sequence_number = iter->second.sequence_number;
-                raw_txn.sender = iter->second.address;
-            }
-            else if (auto opt_account_view = m_rpc_cli->get_account(m_wallet->get_all_accounts().at(account_index).address);
-                     opt_account_view.has_value())
-            {
-                m_accounts[account_index] = *opt_account_view;
-                raw_txn.sequence_number = opt_account_view->sequence_number;
-                raw_txn.sender = opt_account_view->address;
-                iter = m_accounts.find(account_index);
-            }
-            else
-                __throw_runtime_error("Account index does not exist.");
-
-            raw_txn.max_gas_amount = max_gas_amount;
-            raw_txn.gas_unit_price = gas_unit_price;
-            raw_txn.gas_currency_code = gas_currency_code;
-            raw_txn.expiration_timestamp_secs = time(nullptr) + expiration_timestamp_secs;
-            raw_txn.chain_id = diem_types::ChainId{m_chain_id};
+        virtual diem_types::AccountAddress
+        get_account_address(size_t account_index) override
+        {
             if (account_index == ACCOUNT_ROOT_ID)
-                raw_txn.sender = ROOT_ADDRESS;
+                return ROOT_ADDRESS;
             else if (account_index == ACCOUNT_TC_ID)
-                raw_txn.sender = TC_ADDRESS;
+                return TC_ADDRESS;
             else if (account_index == ACCOUNT_DD_ID)
-                raw_txn.sender = TESTNET_DD_ADDRESS;
-
-            auto bytes = raw_txn.bcsSerialize();
-
-            string_view flag = "DIEM::RawTransaction";
-            auto hash = sha3_256((uint8_t *)flag.data(), flag.size());
+                return TESTNET_DD_ADDRESS;
 
-            vector<uint8_t> message(begin(hash), end(hash));
-            copy(begin(bytes), end(bytes), back_insert_iterator(message));
-
-            if (account_index == ACCOUNT_ROOT_ID)
             {
-                ed25519::Signature signature = m_opt_root->sign(message.data(), message.size());
-                signed_txn.authenticator.value = TransactionAuthenticator::Ed25519{
-                    Ed25519PublicKey{u8_array_to_vector(m_opt_root->get_public_key().get_raw_key())},
-                    Ed25519Signature{u8_array_to_vector(signature)}};
+                lock_guard<mutex> lock(m_accounts_mutex);
+
+                auto iter = m_accounts.find(account_index);
+                if (iter != end(m_accounts))
+                    return iter->second;
             }
-            else if (account_index == ACCOUNT_TC_ID)
-            {
-                auto priv_key = m_opt_tc->get_public_key().get_raw_key();
 
-                ed25519::Signature signature = m_opt_tc->sign(message.data(), message.size());
-                signed_txn.authenticator.value = TransactionAuthenticator::Ed25519{
-                    Ed25519PublicKey{u8_array_to_vector(m_opt_tc->get_public_key().get_raw_key())},
-                    Ed25519Signature{u8_array_to_vector(signature)}};
+            return m_wallet->get_account(account_index).address;
+        }
+        virtual std::optional<size_t>
+        find_account(const diem_types::AccountAddress &address) override
+        {
+            if (m_opt_root.has_value() && address == ROOT_ADDRESS)
+                return ACCOUNT_ROOT_ID;
+            else if (m_opt_tc.has_value() && address == TC_ADDRESS)
+                return ACCOUNT_TC_ID;
+            else if (m_opt_dd.has_value() && address == TESTNET_DD_ADDRESS)
+                return ACCOUNT_DD_ID;
 
-                // bool ret = m_opt_tc->get_public_key().verify(signature, message.data(), message.size());
-            }
-            else if (account_index == ACCOUNT_DD_ID)
             {
-                ed25519::Signature signature = m_opt_dd->sign(message.data(), message.size());
-                signed_txn.authenticator.value = TransactionAuthenticator::Ed25519{
-                    Ed25519PublicKey{u8_array_to_vector(m_opt_tc->get_public_key().get_raw_key())},
-                    Ed25519Signature{u8_array_to_vector(signature)}};
+                lock_guard<mutex> lock(m_accounts_mutex);
+
+                auto iter = m_specified_addresses.find(address.value);
+                if (iter != end(m_specified_addresses))
+                    return iter->second;
             }
-            else
-            {
-                auto priv_key = m_wallet->get_account_priv_key(account_index);
 
-                ed25519::Signature signature = priv_key.sign(message.data(), message.size());
+            auto opt_account = m_wallet->find_account(address);
+            if (!opt_account.has_value())
+                return nullopt;
 
-                signed_txn.authenticator.value = TransactionAuthenticator::Ed25519{
-                    Ed25519PublicKey{u8_array_to_vector(priv_key.get_public_key().get_raw_key())},
-                    Ed25519Signature{u8_array_to_vector(signature)}};
-            }
+            // the account was created with another address
+            if (get_account_address(opt_account->index) != address)
+                return nullopt;
 
-            m_rpc_cli->submit(signed_txn);
+            return opt_account->index;
+        }
+        //
+        // submit a script and return sequence number of sender's account
+        //
+        std::tuple<dt::AccountAddress, uint64_t>
+        submit_txn_paylod(size_t account_index,
+                          diem_types::TransactionPayload &&txn_paylod,
+                          uint64_t max_gas_amount = 1'000'000,
+                          uint64_t gas_unit_price = 0,
+                          std::string_view gas_currency_code = "VLS",
+                          uint64_t expiration_timestamp_secs = 100)
+        {
+            auto priv_key = get_private_key(account_index);
+            auto signed_txn = sign_txn(priv_key,
+                                       make_raw_txn(account_index, move(txn_paylod), max_gas_amount, gas_unit_price,
+                                                    gas_currency_code, expiration_timestamp_secs));
+            const auto &raw_txn = signed_txn.raw_txn;
 
-            // return the current sequence number and then increment it
-            return make_tuple<>(raw_txn.sender, iter->second.sequence_number++);
+            submit(signed_txn);
+
+            return make_tuple<>(raw_txn.sender, raw_txn.sequence_number);
         }
 
         std::tuple<dt::AccountAddress, uint64_t>
@@ -265,20 +493,186 @@ namespace violas
                 expiration_timestamp_secs);
         }
 
-#if defined(__GNUC__) && !defined(__llvm__)
         virtual void
         async_submit_script(size_t account_index,
                             std::string_view script_file_name,
                             std::vector<diem_types::TypeTag> type_tags,
                             std::vector<diem_types::TransactionArgument> args,
-                            uint64_t max_gas_amount = 1'000'000,
-                            uint64_t gas_unit_price = 0,
-                            std::string_view gas_currency_code = "VLS",
-                            uint64_t expiration_timestamp_secs = 100,
-                            std::function<void(diem_types::AccountAddress, uint64_t)> callback = nullptr) override
+                            uint64_t max_gas_amount,
+                            uint64_t gas_unit_price,
+                            std::string_view gas_currency_code,
+                            uint64_t expiration_timestamp_secs,
+                            std::function<void(diem_types::AccountAddress, uint64_t, std::exception_ptr)> callback) override
         {
+            auto self = static_pointer_cast<Client2Imp>(shared_from_this());
+
+            // the job only reads the script file, the submission goes through the non-blocking path of submit_in_bulk
+            Executor::default_executor().post(
+                [=, script_file_name = string(script_file_name), gas_currency_code = string(gas_currency_code)]() mutable
+                {
+                    ifstream ifs(script_file_name, ios::binary);
+
+                    if (!ifs.is_open())
+                    {
+                        if (callback)
+                            callback({}, 0, make_exception_ptr(runtime_error(fmt("failed to open file ", script_file_name, " at async_submit_script"))));
+                        return;
+                    }
+
+                    vector<ScriptTxn> txns(1);
+                    auto &txn = txns.front();
+
+                    txn.account_index = account_index;
+                    txn.script_bytecode.assign(istreambuf_iterator<char>(ifs), {});
+                    txn.type_tags = move(type_tags);
+                    txn.args = move(args);
+                    txn.max_gas_amount = max_gas_amount;
+                    txn.gas_unit_price = gas_unit_price;
+                    txn.gas_currency_code = move(gas_currency_code);
+                    txn.expiration_timestamp_secs = expiration_timestamp_secs;
+
+                    self->submit_in_bulk(move(txns), [callback](vector<SubmittedTxn> &&results)
+                                         {
+                                             if (callback)
+                                                 callback(results[0].sender, results[0].sequence_number, results[0].error); });
+                });
+        }
+
+        virtual void
+        async_submit_scripts(std::vector<ScriptTxn> txns,
+                             std::function<void(std::vector<SubmittedTxn> &&)> callback) override
+        {
+            auto self = static_pointer_cast<Client2Imp>(shared_from_this());
+
+            Executor::default_executor().post([=, txns = move(txns)]() mutable
+                                              { self->submit_in_bulk(move(txns), callback); });
+        }
+        //
+        //  The state of a bulk submission shared by the signing jobs and submission callbacks
+        //
+        struct Bulk
+        {
+            vector<optional<ed25519::PrivateKey>> keys;
+            vector<diem_types::RawTransaction> raw_txns;
+            vector<json_rpc::method::Submit> submits;
+            vector<SubmittedTxn> results;
+            atomic<size_t> pending = 0;
+            std::function<void(std::vector<SubmittedTxn> &&)> callback;
+        };
+
+        void submit_in_bulk(std::vector<ScriptTxn> &&txns, std::function<void(std::vector<SubmittedTxn> &&)> callback)
+        {
+            if (txns.empty())
+                return callback({});
+
+            auto bulk = make_shared<Bulk>();
+            size_t count = txns.size();
+
+            bulk->keys.resize(count);
+            bulk->raw_txns.resize(count);
+            bulk->submits.resize(count);
+            bulk->results.resize(count);
+            bulk->callback = move(callback);
+
+            // reserve the sequence numbers in the order of txns on this thread, so that the order is deterministic
+            for (size_t i = 0; i < count; i++)
+            {
+                auto &txn = txns[i];
+
+                try
+                {
+                    bulk->keys[i] = get_private_key(txn.account_index);
+                    bulk->raw_txns[i] = make_raw_txn(txn.account_index,
+                                                     {diem_types::TransactionPayload::Script{{move(txn.script_bytecode), move(txn.type_tags), move(txn.args)}}},
+                                                     txn.max_gas_amount,
+                                                     txn.gas_unit_price,
+                                                     txn.gas_currency_code,
+                                                     txn.expiration_timestamp_secs);
+
+                    bulk->results[i].sender = bulk->raw_txns[i].sender;
+                    bulk->results[i].sequence_number = bulk->raw_txns[i].sequence_number;
+                }
+                catch (...)
+                {
+                    bulk->results[i].error = current_exception();
+                }
+            }
+
+            // sign and serialize in chunks on the worker threads
+            auto &executor = Executor::default_executor();
+            size_t chunk_count = min(count, executor.thread_count() * 4);
+            size_t chunk_size = (count + chunk_count - 1) / chunk_count;
+            auto self = static_pointer_cast<Client2Imp>(shared_from_this());
+
+            bulk->pending = (count + chunk_size - 1) / chunk_size;
+
+            for (size_t first = 0; first < count; first += chunk_size)
+            {
+                executor.post([=, last = min(first + chunk_size, count)]
+                              {
+                                  for (size_t i = first; i < last; i++)
+                                  {
+                                      if (bulk->results[i].error)
+                                          continue;
+
+                                      try
+                                      {
+                                          auto &submit = bulk->submits[i];
+
+                                          submit.signed_txn = sign_txn(*bulk->keys[i], move(bulk->raw_txns[i]));
+                                          auto bytes = serde::BcsBuffer::local().serialize(submit.signed_txn);
+
+                                          submit.bytes.assign(bytes.begin(), bytes.end());
+                                      }
+                                      catch (...)
+                                      {
+                                          bulk->results[i].error = current_exception();
+                                          self->m_seq_numbers.fail(bulk->results[i].sender, bulk->results[i].sequence_number);
+                                      }
+                                  }
+
+                                  if (--bulk->pending == 0)
+                                      self->submit_signed_in_bulk(bulk);
+                              });
+            }
+        }
+        //
+        //  Feed the signed transactions to the pipelined JSON-RPC client in the order of sequence numbers
+        //
+        void submit_signed_in_bulk(shared_ptr<Bulk> bulk)
+        {
+            auto self = static_pointer_cast<Client2Imp>(shared_from_this());
+            size_t count = count_if(begin(bulk->results), end(bulk->results), [](const auto &r)
+                                    { return !r.error; });
+
+            if (count == 0)
+                return bulk->callback(move(bulk->results));
+
+            bulk->pending = count;
+
+            for (size_t i = 0; i < bulk->results.size(); i++)
+            {
+                if (bulk->results[i].error)
+                    continue;
+
+                invalidate_account_states(bulk->submits[i].signed_txn);
+
+                m_rpc_cli->async_call(move(bulk->submits[i]),
+                                      [=](json_rpc::Response &&, std::exception_ptr e)
+                                      {
+                                          auto &result = bulk->results[i];
+
+                                          if (e)
+                                          {
+                                              result.error = e;
+                                              self->on_submit_failed(result.sender, result.sequence_number, e);
+                                          }
+
+                                          if (--bulk->pending == 0)
+                                              bulk->callback(move(bulk->results));
+                                      });
+            }
         }
-#endif
 
         std::tuple<dt::AccountAddress, uint64_t>
         submit_module(size_t account_index,
@@ -299,70 +693,56 @@ namespace violas
 
         void check_txn_vm_status(const diem_types::AccountAddress &address, uint64_t sequence_number, string_view error_info) override
         {
-            using namespace json_rpc;
-            optional<TransactionView> opt_txn_view = nullopt;
-
-            for (int i = 0; i < 50; i++)
-            {
-                opt_txn_view = m_rpc_cli->get_account_transaction(address, sequence_number, false);
-                if (opt_txn_view.has_value())
-                    break;
-
-                this_thread::sleep_for(chrono::milliseconds(100)); // 0.1 second
-            }
+            throw_if_not_executed(confirm_txn(address, sequence_number).get(), error_info);
+        }
 
-            if (opt_txn_view.has_value())
-            {
-                std::visit(
-                    overloaded{[](VMStatus::Executed status) {},
-                               [=](VMStatus::ExecutionFailure status)
-                               {
-                                   ostringstream oss;
-
-                                   oss << error_info << " error, "
-                                       << "vm_status : {\n"
-                                       << "type : " << status.type << ", "
-                                       << "location : " << status.location << ", \n"
-                                       << "function index : " << status.function_index << ", \n"
-                                       << "code offset : " << status.code_offset << ", \n"
-                                       << "}";
-
-                                   __throw_runtime_error(oss.str().c_str());
-                               },
-                               [](VMStatus::OutOfGas status)
-                               {
-                                   __throw_runtime_error(status.type.c_str());
-                               },
-                               [=](VMStatus::MiscellaneousError status)
-                               {
-                                   ostringstream oss;
-                                   oss << error_info << " failed, VM status : " << status.type;
-
-                                   __throw_runtime_error(oss.str().c_str());
-                               },
-                               [=](VMStatus::MoveAbort status)
-                               {
-                                   ostringstream oss;
-
-                                   oss << error_info << " error, "
-                                       << "vm_status : { "
-                                       << "type : " << status.type << ", "
-                                       << "abort code : " << status.abort_code
-                                       << " }";
-
-                                   __throw_runtime_error(oss.str().c_str());
-                               }},
-                    opt_txn_view->vm_status.value);
-            }
-            else
-                __throw_runtime_error("check_txn_vm_status is timeout.");
+        virtual void
+        async_confirm_txn(const diem_types::AccountAddress &address,
+                          uint64_t sequence_number,
+                          std::function<void(json_rpc::VMStatus &&, std::exception_ptr)> callback) override
+        {
+            auto self = static_pointer_cast<Client2Imp>(shared_from_this());
+
+            m_tracker->watch(address, sequence_number,
+                             [=](json_rpc::TransactionView &&txn_view, std::exception_ptr e)
+                             {
+                                 // not found in time or the polls failed, the transaction may still be in mempool,
+                                 // so its number stays in flight until the chain passes it or it expires
+                                 if (e)
+                                     self->m_seq_numbers.resync(address);
+                                 else
+                                 {
+                                     self->m_seq_numbers.commit(address, sequence_number);
+                                     self->m_states.advance(txn_view.version);
+                                 }
+
+                                 callback(move(txn_view.vm_status), e);
+                             });
         }
 
         virtual void
         async_check_txn_vm_status(const diem_types::AccountAddress &address,
                                   uint64_t sequence_number,
-                                  std::function<void()> callback) override
+                                  std::string_view error_info,
+                                  std::function<void(std::exception_ptr)> callback) override
         {
+            async_confirm_txn(address, sequence_number,
+                              [error_info = string(error_info), callback](json_rpc::VMStatus &&status, std::exception_ptr e)
+                              {
+                                  if (!e)
+                                  {
+                                      try
+                                      {
+                                          throw_if_not_executed(status, error_info);
+                                      }
+                                      catch (...)
+                                      {
+                                          e = current_exception();
+                                      }
+                                  }
+
+                                  callback(e);
+                              });
         }
 
         virtual std::tuple<dt::AccountAddress, uint64_t>
@@ -447,42 +827,11 @@ namespace violas
             raw_txn.chain_id = diem_types::ChainId{m_chain_id};
 
             // Set sender and sequence number
-            auto iter = m_accounts.find(account_index);
-            if (iter != end(m_accounts))
-            {
-                raw_txn.sender = iter->second.address;
-                raw_txn.sequence_number = iter->second.sequence_number;
-            }
-            else if (auto opt_account_view = m_rpc_cli->get_account(m_wallet->get_all_accounts().at(account_index).address);
-                     opt_account_view.has_value())
-            {
-                raw_txn.sender = opt_account_view->address;
-                raw_txn.sequence_number = opt_account_view->sequence_number;
-
-                // Update m_accounts and iter
-                m_accounts[account_index] = *opt_account_view;
-                iter = m_accounts.find(account_index);
-            }
-            else
-                __throw_runtime_error("Account index does not exist.");
+            raw_txn.sender = get_account_address(account_index);
+            raw_txn.sequence_number = m_seq_numbers.reserve(raw_txn.sender, raw_txn.expiration_timestamp_secs);
 
             // Sign for flag + raw transaction + secondary_signer_addresses
-            string_view flag = "DIEM::RawTransactionWithData";
-            auto hash = sha3_256((uint8_t *)flag.data(), flag.size());
-
-            vector<uint8_t> message(begin(hash), end(hash));
-
-            // RawTransactionWithData enum 0
-            message.push_back(0);
-
-            auto bytes = raw_txn.bcsSerialize();
-            copy(begin(bytes), end(bytes), back_insert_iterator(message));
-
-            // Serialize secondary signer addresses
-            auto serializer = serde::BcsSerializer();
-            serde::Serializable<vector<AccountAddress>>::serialize(secondary_signer_addresses, serializer);
-            bytes = std::move(serializer).bytes();
-            copy(begin(bytes), end(bytes), back_insert_iterator(message));
+            auto &message = SigningMessage::local().multi_agent_raw_txn(raw_txn, secondary_signer_addresses);
 
             // Set multi agent authenticators
             TransactionAuthenticator::MultiAgent multi_agent_auth;
@@ -547,27 +896,13 @@ namespace violas
             auto &secondary_signer_addresses = multi_agent_auth.secondary_signer_addresses;
 
             // Sign for flag + raw transaction + secondary_signer_addresses
-            string_view flag = "DIEM::RawTransactionWithData";
-            auto hash = sha3_256((uint8_t *)flag.data(), flag.size());
-
-            vector<uint8_t> message(begin(hash), end(hash));
-
-            message.push_back(0);
-
-            auto bytes = raw_txn.bcsSerialize();
-            copy(begin(bytes), end(bytes), back_insert_iterator(message));
-
-            // Serialize secondary signer addresses
-            auto serializer = serde::BcsSerializer();
-            serde::Serializable<std::vector<diem_types::AccountAddress>>::serialize(secondary_signer_addresses, serializer);
-            bytes = std::move(serializer).bytes();
-            copy(begin(bytes), end(bytes), back_insert_iterator(message));
+            auto &message = SigningMessage::local().multi_agent_raw_txn(raw_txn, secondary_signer_addresses);
 
             // Set sender's authenticator
             if (account_index == ACCOUNT_ROOT_ID)
             {
                 ed25519::Signature signature = m_opt_root->sign(message.data(), message.size());
-                multi_agent_auth.secondary_signer_addresses.push_back(m_accounts[account_index].address);
+                multi_agent_auth.secondary_signer_addresses.push_back(get_account_address(account_index));
 
                 multi_agent_auth.secondary_signers.push_back(
                     {AccountAuthenticator::Ed25519{
@@ -587,7 +922,7 @@ namespace violas
             {
                 ed25519::Signature signature = m_opt_dd->sign(message.data(), message.size());
 
-                multi_agent_auth.secondary_signer_addresses.push_back(m_accounts[account_index].address);
+                multi_agent_auth.secondary_signer_addresses.push_back(get_account_address(account_index));
                 multi_agent_auth.secondary_signers.push_back(
                     {AccountAuthenticator::Ed25519{
                         Ed25519PublicKey{u8_array_to_vector(m_opt_tc->get_public_key().get_raw_key())},
@@ -605,7 +940,7 @@ namespace violas
                         Ed25519Signature{u8_array_to_vector(signature)}}});
             }
 
-            m_rpc_cli->submit(signed_txn);
+            submit(signed_txn);
 
             return make_tuple<>(raw_txn.sender, raw_txn.sequence_number);
         }
@@ -614,32 +949,105 @@ namespace violas
         publish_module(size_t account_index,
                        std::vector<uint8_t> &&module_bytes_code) override
         {
-            auto [sender, sn] = this->submit_module(account_index, {module_bytes_code});
-
-            this->check_txn_vm_status(sender, sn, "publish_module");
+            this->publish_module_pending(account_index, move(module_bytes_code)).get();
         }
 
         virtual void
         publish_module(size_t account_index,
                        std::string_view module_file_name) override
+        {
+            this->publish_module_pending(account_index, module_file_name).get();
+        }
+
+        virtual PendingTxn
+        publish_module_pending(size_t account_index,
+                               std::vector<uint8_t> &&module_bytes_code) override
+        {
+            auto [sender, sn] = this->submit_module(account_index, {module_bytes_code});
+
+            return this->watch_txn(sender, sn, "publish_module");
+        }
+
+        virtual PendingTxn
+        publish_module_pending(size_t account_index,
+                               std::string_view module_file_name) override
         {
             ifstream ifs(module_file_name.data(), ios::binary);
 
             if (!ifs.is_open())
                 throw runtime_error(format("failed to open file %s at submit_script_file", module_file_name).c_str());
 
-            this->publish_module(account_index, bytes(istreambuf_iterator<char>(ifs), {}));
+            return this->publish_module_pending(account_index, bytes(istreambuf_iterator<char>(ifs), {}));
         }
 
         virtual std::optional<AccountState2>
         get_account_state(const dt::AccountAddress address) override
         {
-            json_rpc::AccountStateWithProof asp = m_rpc_cli->get_account_state_blob(bytes_to_hex(address.value));
+            return m_states.get(address);
+        }
 
-            if (asp.blob.empty())
-                return {};
-            else
-                return AccountState2(asp.blob);
+        virtual std::vector<std::optional<AccountState2>>
+        get_account_states(const std::vector<dt::AccountAddress> &addresses) override
+        {
+            vector<optional<AccountState2>> states(addresses.size());
+            vector<size_t> misses;
+            vector<json_rpc::Request> requests;
+
+            for (size_t i = 0; i < addresses.size(); i++)
+            {
+                if (auto cached = m_states.find(addresses[i]))
+                    states[i] = move(*cached);
+                else
+                {
+                    misses.push_back(i);
+                    requests.push_back(json_rpc::method::GetAccountStateWithProof{bytes_to_hex(addresses[i].value)});
+                }
+            }
+
+            if (requests.empty())
+                return states;
+
+            auto responses = m_rpc_cli->batch(requests);
+
+            for (size_t j = 0; j < misses.size(); j++)
+            {
+                auto fetched = make_fetched(move(get<json_rpc::AccountStateWithProof>(responses[j])));
+
+                states[misses[j]] = fetched.state;
+                m_states.put(addresses[misses[j]], move(fetched));
+            }
+
+            return states;
+        }
+
+        virtual void
+        set_account_state_cache_options(const AccountStateCacheOptions &options) override
+        {
+            m_states.set_options(options);
+        }
+
+        virtual void
+        invalidate_account_state(const dt::AccountAddress &address) override
+        {
+            m_states.invalidate(address);
+        }
+
+        virtual std::optional<AccountState2>
+        get_verified_account_state(const dt::AccountAddress &address, StateProofVerifier &verifier) override
+        {
+            auto ledger_version = verifier.latest_version();
+            if (!ledger_version)
+                __throw_runtime_error("get_verified_account_state: no ledger version is trusted.");
+
+            // the state at the trusted ledger version, not an older one
+            auto responses = m_rpc_cli->batch({json_rpc::method::GetAccountStateWithProof{bytes_to_hex(address.value),
+                                                                                         *ledger_version,
+                                                                                         *ledger_version}});
+            auto &asp = get<json_rpc::AccountStateWithProof>(responses.at(0));
+
+            verifier.verify(address, *ledger_version, *ledger_version, asp);
+
+            return make_fetched(move(asp)).state;
         }
 
         virtual std::vector<json_rpc::EventView>
@@ -648,19 +1056,41 @@ namespace violas
             return m_rpc_cli->get_events(bytes_to_hex(handle.guid), start, limit);
         }
 
+        virtual std::vector<std::vector<json_rpc::EventView>>
+        get_events(const std::vector<EventHandle> &handles, uint64_t start, uint64_t limit) override
+        {
+            vector<json_rpc::Request> requests;
+
+            for (auto &handle : handles)
+                requests.push_back(json_rpc::method::GetEvents{bytes_to_hex(handle.guid), start, limit});
+
+            vector<vector<json_rpc::EventView>> events;
+
+            for (auto &response : m_rpc_cli->batch(requests))
+                events.push_back(move(get<vector<json_rpc::EventView>>(response)));
+
+            return events;
+        }
+
         //
         //
         //
         virtual void
         add_currency(size_t account_index, std::string_view currency_code) override
+        {
+            this->add_currency_pending(account_index, currency_code).get();
+        }
+
+        virtual PendingTxn
+        add_currency_pending(size_t account_index, std::string_view currency_code) override
         {
             auto [sender, sn] = submit_script(account_index,
                                               diem_framework::encode_add_currency_to_account_script(
                                                   make_struct_type_tag(STD_LIB_ADDRESS, currency_code, currency_code)));
 
-            this->check_txn_vm_status(sender,
-                                      sn,
-                                      "add_currency");
+            return this->watch_txn(sender,
+                                   sn,
+                                   "add_currency");
         }
 
         virtual void
@@ -692,6 +1122,20 @@ namespace violas
             const std::array<uint8_t, 32> &auth_key,
             string_view human_name,
             bool add_all_currencies) override
+        {
+            auto txn = this->create_parent_vasp_account_pending(address, auth_key, human_name, add_all_currencies);
+
+            txn.get();
+
+            return txn.sequence_number();
+        }
+
+        virtual PendingTxn
+        create_parent_vasp_account_pending(
+            const diem_types::AccountAddress &address,
+            const std::array<uint8_t, 32> &auth_key,
+            string_view human_name,
+            bool add_all_currencies) override
         {
             if (m_opt_tc == std::nullopt)
                 __throw_runtime_error("TC account is null, please specify the mint key file.");
@@ -706,9 +1150,7 @@ namespace violas
                     vector<uint8_t>(human_name.data(), human_name.data() + human_name.size()),
                     add_all_currencies));
 
-            this->check_txn_vm_status(sender, sn, "create_parent_vasp_account");
-
-            return sn;
+            return this->watch_txn(sender, sn, "create_parent_vasp_account");
         }
 
         virtual void
@@ -718,6 +1160,17 @@ namespace violas
                                   string_view currency,
                                   uint64_t child_initial_balance,
                                   bool add_all_currencies = false) override
+        {
+            this->create_child_vasp_account_pending(account_index, address, auth_key, currency, child_initial_balance, add_all_currencies).get();
+        }
+
+        virtual PendingTxn
+        create_child_vasp_account_pending(size_t account_index,
+                                          const diem_types::AccountAddress &address,
+                                          const std::array<uint8_t, 32> &auth_key,
+                                          string_view currency,
+                                          uint64_t child_initial_balance,
+                                          bool add_all_currencies = false) override
         {
             auto [sender, sn] = this->submit_script(
                 account_index,
@@ -728,7 +1181,7 @@ namespace violas
                     add_all_currencies,
                     child_initial_balance));
 
-            this->check_txn_vm_status(sender, sn, "create_child_vasp_account");
+            return this->watch_txn(sender, sn, "create_child_vasp_account");
         }
 
         virtual void
@@ -738,6 +1191,17 @@ namespace violas
                                     const std::array<uint8_t, 32> &auth_key,
                                     std::string_view human_name,
                                     bool add_all_currencies) override
+        {
+            this->create_designated_dealer_ex_pending(currency_code, sliding_nonce, address, auth_key, human_name, add_all_currencies).get();
+        }
+
+        virtual PendingTxn
+        create_designated_dealer_ex_pending(std::string_view currency_code,
+                                            uint64_t sliding_nonce,
+                                            const diem_types::AccountAddress &address,
+                                            const std::array<uint8_t, 32> &auth_key,
+                                            std::string_view human_name,
+                                            bool add_all_currencies) override
         {
             bytes script_bytecode = {161, 28, 235, 11, 3, 0, 0, 0, 6, 1, 0, 4, 3, 4, 11, 4, 15, 2, 5, 17, 26, 7, 43, 75, 8, 118, 16, 0, 0, 0, 1, 1, 2, 2, 1, 0, 0, 3, 4, 1, 1, 0, 1, 3, 6, 12, 3, 5, 10, 2, 10, 2, 1, 0, 2, 6, 12, 3, 1, 9, 0, 5, 6, 12, 5, 10, 2, 10, 2, 1, 11, 68, 105, 101, 109, 65, 99, 99, 111, 117, 110, 116, 12, 83, 108, 105, 100, 105, 110, 103, 78, 111, 110, 99, 101, 21, 114, 101, 99, 111, 114, 100, 95, 110, 111, 110, 99, 101, 95, 111, 114, 95, 97, 98, 111, 114, 116, 27, 99, 114, 101, 97, 116, 101, 95, 100, 101, 115, 105, 103, 110, 97, 116, 101, 100, 95, 100, 101, 97, 108, 101, 114, 95, 101, 120, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 1, 10, 14, 0, 10, 1, 17, 0, 14, 0, 10, 2, 11, 3, 11, 4, 10, 5, 56, 0, 2};
 
@@ -749,9 +1213,9 @@ namespace violas
                     make_txn_args(sliding_nonce, address, auth_key, human_name, add_all_currencies),
                 });
 
-            this->check_txn_vm_status(sender,
-                                      sn,
-                                      "create_designated_dealer_ex");
+            return this->watch_txn(sender,
+                                   sn,
+                                   "create_designated_dealer_ex");
         }
         void publish_currency_module(std::string_view currency_code)
         {
@@ -855,6 +1319,16 @@ namespace violas
              uint64_t amount,
              diem_types::AccountAddress dd_address,
              uint64_t tier_index) override
+        {
+            this->mint_pending(currency_code, sliding_nonce, amount, dd_address, tier_index).get();
+        }
+
+        virtual PendingTxn
+        mint_pending(std::string_view currency_code,
+                     uint64_t sliding_nonce,
+                     uint64_t amount,
+                     diem_types::AccountAddress dd_address,
+                     uint64_t tier_index) override
         {
             auto script = diem_framework::encode_tiered_mint_script(
                 make_struct_type_tag(STD_LIB_ADDRESS, currency_code, currency_code),
@@ -864,7 +1338,7 @@ namespace violas
                 tier_index);
 
             auto [sender, sn] = this->submit_script(ACCOUNT_TC_ID, move(script));
-            check_txn_vm_status(sender, sn, "mint");
+            return watch_txn(sender, sn, "mint");
         }
     };
 
@@ -24,6 +24,7 @@ namespace fs = boost::filesystem;
 #endif
 
 #include "violas_sdk.hpp"
+#include "../include/hex_codec.hpp"
 #include "rust_client_proxy.hpp"
 
 using namespace std;
@@ -47,17 +48,7 @@ namespace LIB_NAME
 
     std::string tx_vec_data(const std::string &data)
     {
-        ostringstream oss;
-        oss << "b\"";
-
-        for (auto v : data)
-        {
-            oss << std::setfill('0') << std::setw(2) << std::hex << (int)v;
-        }
-
-        oss << "\"";
-
-        return oss.str();
+        return "b\"" + hex_encode(std::span<const uint8_t>((const uint8_t *)data.data(), data.size())) + "\"";
     }
 
     bool is_valid_balance(uint64_t value)
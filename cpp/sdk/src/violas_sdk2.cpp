@@ -473,14 +473,10 @@ namespace violas
         if(as.blob.empty())
             __throw_runtime_error("Failed to get account state due to blob is null.");
 
-        // cout << "blob = " <<  as.blob << endl;
-
-        auto bytes = hex_to_bytes(as.blob);
-
         // Deserialize to vector
         vector<uint8_t> data;
         {
-            BcsSerde serde(bytes);
+            BcsSerde serde(move(as.blob));
             serde &&data;
         }
 
@@ -21,6 +21,11 @@
 #include <iterator>
 #include <bitset>
 #include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <optional>
 // Open SSL
 #include <openssl/hmac.h>
 #include <openssl/kdf.h>
@@ -53,43 +58,80 @@ namespace violas
             std::__throw_runtime_error(oss.str().c_str());
     }
 
+    using md_ctx_ptr = unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)>;
+    //
+    //  Create a digest context which is set up with md once, it is reinitialized with the same md for each hash
+    //  without fetching the md again
+    //
+    static md_ctx_ptr new_md_ctx(const EVP_MD *md)
+    {
+        md_ctx_ptr context(EVP_MD_CTX_new(), &EVP_MD_CTX_free);
+
+        EVP_DigestInit_ex(context.get(), md, nullptr);
+
+        return context;
+    }
+
     template <size_t N>
-    array<uint8_t, N> hash(uint8_t *data, size_t len, const EVP_MD *md)
+    array<uint8_t, N> hash(const uint8_t *data, size_t len, EVP_MD_CTX *context)
     {
         array<uint8_t, N> output;
         uint32_t out_len = output.size();
-        EVP_MD_CTX *context = EVP_MD_CTX_new();
 
-        EVP_DigestInit_ex(context, md, nullptr);
+        EVP_DigestInit_ex(context, nullptr, nullptr);
         EVP_DigestUpdate(context, data, len);
         EVP_DigestFinal_ex(context, output.data(), &out_len);
 
-        EVP_MD_CTX_destroy(context);
-
         return output;
     }
 
-    std::array<uint8_t, 32> sha_256(uint8_t *data, size_t len)
+    std::array<uint8_t, 32> sha_256(const uint8_t *data, size_t len)
+    {
+        thread_local md_ctx_ptr context = new_md_ctx(EVP_sha256());
+
+        return hash<32>(data, len, context.get());
+    }
+
+    std::array<uint8_t, 64> sha_512(const uint8_t *data, size_t len)
+    {
+        thread_local md_ctx_ptr context = new_md_ctx(EVP_sha512());
+
+        return hash<64>(data, len, context.get());
+    }
+
+    array<uint8_t, 32> sha3_256(const uint8_t *data, size_t len)
+    {
+        thread_local md_ctx_ptr context = new_md_ctx(EVP_sha3_256());
+
+        return hash<32>(data, len, context.get());
+    }
+
+    Sha3Hasher::Sha3Hasher() : m_context(EVP_MD_CTX_new())
+    {
+        EVP_DigestInit_ex(m_context, EVP_sha3_256(), nullptr);
+    }
+
+    Sha3Hasher::~Sha3Hasher()
     {
-        return hash<32>(data, len, EVP_sha256());
+        EVP_MD_CTX_free(m_context);
     }
 
-    std::array<uint8_t, 64> sha_512(uint8_t *data, size_t len)
+    Sha3Hasher &Sha3Hasher::update(const uint8_t *data, size_t len)
     {
-        return hash<64>(data, len, EVP_sha512());
+        EVP_DigestUpdate(m_context, data, len);
+
+        return *this;
     }
 
-    array<uint8_t, 32> sha3_256(uint8_t *data, size_t len)
+    array<uint8_t, 32> Sha3Hasher::finalize()
     {
         array<uint8_t, 32> output;
         uint32_t out_len = output.size();
-        EVP_MD_CTX *context = EVP_MD_CTX_new();
 
-        EVP_DigestInit_ex(context, EVP_sha3_256(), nullptr);
-        EVP_DigestUpdate(context, data, len);
-        EVP_DigestFinal_ex(context, output.data(), &out_len);
+        EVP_DigestFinal_ex(m_context, output.data(), &out_len);
 
-        EVP_MD_CTX_destroy(context);
+        // ready for the next message
+        EVP_DigestInit_ex(m_context, nullptr, nullptr);
 
         return output;
     }
@@ -108,13 +150,26 @@ namespace violas
         entropy[32] = hash[0];
     }
 
+    Wallet::Wallet(Wallet &&wallet)
+        : m_entropy_hash(wallet.m_entropy_hash),
+          m_seed(wallet.m_seed),
+          main_key(wallet.main_key),
+          m_private_keys(move(wallet.m_private_keys)),
+          m_accounts(move(wallet.m_accounts)),
+          m_address_indices(move(wallet.m_address_indices)),
+          m_auth_key_indices(move(wallet.m_auth_key_indices))
+    {
+    }
+
     Wallet::~Wallet()
     {
     }
 
     crypto::ed25519::PrivateKey
-    Wallet::get_account_priv_key(size_t index)
+    Wallet::get_account_priv_key(size_t index) const
     {
+        shared_lock lock(m_mutex);
+
         return m_private_keys.at(index);
     }
 
@@ -154,7 +209,7 @@ namespace violas
         check_ret(ret, "HMAC_Final");
     }
 
-    Wallet::Key Wallet::extend_child_private_key(uint64_t index)
+    Wallet::Key Wallet::extend_child_private_key(uint64_t index) const
     {
         int ret = 0;
         std::array<uint8_t, 32> out;
@@ -168,7 +223,7 @@ namespace violas
         ret = EVP_PKEY_CTX_set_hkdf_md(ctx.get(), EVP_sha3_256());
         check_ret(ret, "EVP_PKEY_CTX_set_hkdf_md");
 
-        ret = EVP_PKEY_CTX_set1_hkdf_salt(ctx.get(), MAIN_KEY_SALT.data(), MAIN_KEY_SALT.length());
+        ret = EVP_PKEY_CTX_set1_hkdf_salt(ctx.get(), (const uint8_t *)MAIN_KEY_SALT.data(), MAIN_KEY_SALT.length());
         check_ret(ret, "EVP_PKEY_CTX_set1_hkdf_salt");
 
         ret = EVP_PKEY_CTX_set1_hkdf_key(ctx.get(), m_seed.data(), m_seed.size());
@@ -319,55 +374,168 @@ namespace violas
         return address;
     }
 
-    std::tuple<size_t, diem_types::AccountAddress> Wallet::create_next_account()
+    static Wallet::Account make_account(size_t index, const ed25519::PrivateKey &priv_key)
     {
-        size_t keys_size = m_private_keys.size();
+        const auto &pub_key = priv_key.get_public_key();
+        Wallet::Account account{index, {}, Wallet::pub_key_to_auth_key(pub_key), pub_key.get_raw_key()};
 
-        Key raw_key = extend_child_private_key(keys_size);
-        auto priv_key = ed25519::PrivateKey::from_raw_key(ed25519::RawKey(raw_key));
+        // the address is the 16 bytes suffix of auth key
+        copy(begin(account.auth_key) + 16, end(account.auth_key), begin(account.address.value));
 
-        diem_types::AccountAddress address;
-        auto raw_pub_key = priv_key.get_public_key().get_raw_key();
+        return account;
+    }
+    //
+    //  Call fn(i) for i in [0, count) with multiple threads, the first exception is rethrown
+    //
+    static void parallel_for(size_t count, size_t thread_count, const function<void(size_t)> &fn)
+    {
+        const size_t CHUNK_SIZE = 16;
 
-        m_private_keys.push_back(priv_key);
+        if (thread_count == 0)
+            thread_count = max(thread::hardware_concurrency(), 1u);
 
-        vector<uint8_t> auth_key_preimage(begin(raw_pub_key), end(raw_pub_key));
-        auth_key_preimage.push_back(Scheme::Ed25519);
+        thread_count = min(thread_count, (count + CHUNK_SIZE - 1) / CHUNK_SIZE);
 
-        auto hash = sha3_256(auth_key_preimage.data(), auth_key_preimage.size());
-        // copy sha3 256 hash
-        copy(begin(hash) + 16, end(hash), begin(address.value));
+        atomic<size_t> next = 0;
+        exception_ptr error;
+        once_flag error_flag;
+        vector<thread> threads;
+
+        auto worker = [&]
+        {
+            try
+            {
+                for (size_t first = next.fetch_add(CHUNK_SIZE); first < count; first = next.fetch_add(CHUNK_SIZE))
+                {
+                    for (size_t i = first; i < min(first + CHUNK_SIZE, count); i++)
+                        fn(i);
+                }
+            }
+            catch (...)
+            {
+                call_once(error_flag, [&]
+                          { error = current_exception(); });
+
+                // stop the other threads
+                next = count;
+            }
+        };
 
-        return make_tuple<>(keys_size, address);
+        for (size_t i = 1; i < thread_count; i++)
+            threads.emplace_back(worker);
+
+        worker();
+
+        for (auto &t : threads)
+            t.join();
+
+        if (error)
+            rethrow_exception(error);
     }
 
-    array<uint8_t, 16>
-    Wallet::get_account_address(size_t index)
+    void Wallet::add_account(ed25519::PrivateKey &&priv_key, Account &&account)
     {
-        auto pubkey = ed25519::PrivateKey::generate().get_public_key().get_raw_key();
-        array<uint8_t, 16> address;
+        m_address_indices.emplace(account.address.value, account.index);
+        m_auth_key_indices.emplace(account.auth_key, account.index);
 
-        copy(begin(pubkey), begin(pubkey) + 16, begin(address));
+        m_private_keys.push_back(move(priv_key));
+        m_accounts.push_back(move(account));
+    }
 
-        return address;
+    std::tuple<size_t, diem_types::AccountAddress> Wallet::create_next_account()
+    {
+        unique_lock lock(m_mutex);
+
+        size_t index = m_private_keys.size();
+        auto priv_key = ed25519::PrivateKey::from_raw_key(extend_child_private_key(index));
+        auto account = make_account(index, priv_key);
+
+        add_account(move(priv_key), move(account));
+
+        return make_tuple<>(index, m_accounts.back().address);
     }
 
-    std::vector<Wallet::Account> Wallet::get_all_accounts()
+    vector<Wallet::Account> Wallet::derive_accounts(size_t first, size_t last, size_t thread_count)
     {
-        std::vector<Account> accounts;
-        size_t index = 0;
+        if (first > last)
+            __throw_invalid_argument("the first index of accounts is greater than the last one");
 
-        for (const auto &priv_key : m_private_keys)
+        size_t start = account_count();
+
+        if (start < last)
         {
-            Account account{
-                index++,
-                pub_key_account_address(priv_key.get_public_key()),
-                pub_key_to_auth_key(priv_key.get_public_key())};
+            // derive without lock, the keys are determined by index only
+            size_t count = last - start;
+            vector<optional<ed25519::PrivateKey>> keys(count);
+            vector<Account> accounts(count);
+
+            parallel_for(count, thread_count, [&](size_t i)
+                         {
+                             keys[i] = ed25519::PrivateKey::from_raw_key(extend_child_private_key(start + i));
+                             accounts[i] = make_account(start + i, *keys[i]); });
+
+            unique_lock lock(m_mutex);
 
-            accounts.push_back(move(account));
+            // skip the accounts created by others meanwhile
+            for (size_t i = m_private_keys.size() - start; i < count; i++)
+                add_account(move(*keys[i]), move(accounts[i]));
         }
 
-        return accounts;
+        shared_lock lock(m_mutex);
+
+        return vector<Account>(begin(m_accounts) + first, begin(m_accounts) + last);
+    }
+
+    size_t Wallet::account_count() const
+    {
+        shared_lock lock(m_mutex);
+
+        return m_accounts.size();
+    }
+
+    Wallet::Account Wallet::get_account(size_t index) const
+    {
+        shared_lock lock(m_mutex);
+
+        if (index >= m_accounts.size())
+            __throw_out_of_range("account index is out of account size.");
+
+        return m_accounts[index];
+    }
+
+    array<uint8_t, 16>
+    Wallet::get_account_address(size_t index) const
+    {
+        return get_account(index).address.value;
+    }
+
+    std::vector<Wallet::Account> Wallet::get_all_accounts() const
+    {
+        shared_lock lock(m_mutex);
+
+        return m_accounts;
+    }
+
+    optional<Wallet::Account> Wallet::find_account(const diem_types::AccountAddress &address) const
+    {
+        shared_lock lock(m_mutex);
+
+        auto iter = m_address_indices.find(address.value);
+        if (iter == end(m_address_indices))
+            return nullopt;
+
+        return m_accounts[iter->second];
+    }
+
+    optional<Wallet::Account> Wallet::find_account(const Key &auth_key) const
+    {
+        shared_lock lock(m_mutex);
+
+        auto iter = m_auth_key_indices.find(auth_key);
+        if (iter == end(m_auth_key_indices))
+            return nullopt;
+
+        return m_accounts[iter->second];
     }
 
     void Wallet::run_test_case()
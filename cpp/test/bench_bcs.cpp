@@ -0,0 +1,560 @@
+//
+//  Benchmark of the two BCS APIs, the generated diem_types serde and the hand-written BcsSerde structs
+//
+//  The legacy rows run the generated serde with the former per-byte kernels of serde::BcsSerializer and
+//  serde::BcsDeserializer, and the structs with the former per-byte BcsSerde, as the baselines of the shared codec
+//
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <map>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <diem_types.hpp>
+#include <bcs_serde.hpp>
+
+using namespace std;
+using namespace std::chrono;
+
+//
+//  A resource like NftInfo of NFT store, it is serialized by BcsSerde and legacy::BcsSerde
+//
+struct EventHandle
+{
+    uint64_t counter;
+    vector<uint8_t> guid;
+
+    template <typename Serde>
+    Serde &serde(Serde &bs)
+    {
+        return bs && counter && guid;
+    }
+};
+
+struct NftInfo
+{
+    bool limited;
+    uint64_t total;
+    uint64_t amount;
+    array<uint8_t, 16> admin;
+    map<vector<uint8_t>, array<uint8_t, 16>> owners;
+    EventHandle mint_event;
+    EventHandle burn_event;
+    EventHandle transferred_event;
+
+    template <typename Serde>
+    Serde &serde(Serde &bs)
+    {
+        return bs && limited && total && amount && admin && owners && mint_event && burn_event && transferred_event;
+    }
+};
+
+namespace legacy
+{
+    //
+    //  The former kernels which push and read one byte at a time, the byte vectors are not copied in bulk
+    //  since they have no serialize_bytes or deserialize_bytes
+    //
+    class BcsSerializer
+    {
+        std::vector<uint8_t> bytes_;
+        size_t container_depth_budget_ = serde::BCS_MAX_CONTAINER_DEPTH;
+
+        void serialize_u32_as_uleb128(uint32_t value)
+        {
+            while (value >= 0x80)
+            {
+                bytes_.push_back((uint8_t)((value & 0x7F) | 0x80));
+                value = value >> 7;
+            }
+            bytes_.push_back((uint8_t)value);
+        }
+
+    public:
+        static constexpr bool enforce_strict_map_ordering = true;
+
+        void serialize_len(size_t value)
+        {
+            if (value > serde::BCS_MAX_LENGTH)
+                throw serde::serialization_error("Length is too large");
+            serialize_u32_as_uleb128((uint32_t)value);
+        }
+        void serialize_variant_index(uint32_t value) { serialize_u32_as_uleb128(value); }
+
+        void serialize_str(const std::string &value)
+        {
+            serialize_len(value.size());
+            for (auto c : value)
+                bytes_.push_back(c);
+        }
+        void serialize_unit() {}
+        void serialize_bool(bool value) { bytes_.push_back((uint8_t)value); }
+        void serialize_option_tag(bool value) { serialize_bool(value); }
+
+        void serialize_u8(uint8_t value) { bytes_.push_back(value); }
+        void serialize_u16(uint16_t value)
+        {
+            for (int i = 0; i < 2; i++)
+                bytes_.push_back((uint8_t)(value >> (8 * i)));
+        }
+        void serialize_u32(uint32_t value)
+        {
+            for (int i = 0; i < 4; i++)
+                bytes_.push_back((uint8_t)(value >> (8 * i)));
+        }
+        void serialize_u64(uint64_t value)
+        {
+            for (int i = 0; i < 8; i++)
+                bytes_.push_back((uint8_t)(value >> (8 * i)));
+        }
+        void serialize_u128(const serde::uint128_t &value)
+        {
+            serialize_u64(value.low);
+            serialize_u64(value.high);
+        }
+
+        size_t get_buffer_offset() { return bytes_.size(); }
+        void increase_container_depth()
+        {
+            if (container_depth_budget_ == 0)
+                throw serde::serialization_error("Too many nested containers");
+            container_depth_budget_--;
+        }
+        void decrease_container_depth() { container_depth_budget_++; }
+
+        void sort_last_entries(std::vector<size_t> offsets)
+        {
+            if (offsets.size() <= 1)
+                return;
+            offsets.push_back(bytes_.size());
+
+            std::vector<std::vector<uint8_t>> slices;
+            for (size_t i = 1; i < offsets.size(); i++)
+                slices.emplace_back(bytes_.cbegin() + offsets[i - 1], bytes_.cbegin() + offsets[i]);
+
+            std::sort(slices.begin(), slices.end());
+
+            bytes_.resize(offsets[0]);
+            for (auto &slice : slices)
+                bytes_.insert(bytes_.end(), slice.begin(), slice.end());
+        }
+
+        std::vector<uint8_t> bytes() && { return std::move(bytes_); }
+    };
+
+    class BcsDeserializer
+    {
+        std::vector<uint8_t> bytes_;
+        size_t pos_ = 0;
+        size_t container_depth_budget_ = serde::BCS_MAX_CONTAINER_DEPTH;
+
+        uint8_t read_byte()
+        {
+            if (pos_ >= bytes_.size())
+                throw serde::deserialization_error("Input is not large enough");
+            return bytes_.at(pos_++);
+        }
+
+        uint32_t deserialize_uleb128_as_u32()
+        {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 32; shift += 7)
+            {
+                auto byte = read_byte();
+                auto digit = byte & 0x7F;
+                value |= (uint64_t)digit << shift;
+                if (value > std::numeric_limits<uint32_t>::max())
+                    throw serde::deserialization_error("Overflow while parsing uleb128-encoded uint32 value");
+                if (digit == byte)
+                {
+                    if (shift > 0 && digit == 0)
+                        throw serde::deserialization_error("Invalid uleb128 number (unexpected zero digit)");
+                    return (uint32_t)value;
+                }
+            }
+            throw serde::deserialization_error("Overflow while parsing uleb128-encoded uint32 value");
+        }
+
+    public:
+        static constexpr bool enforce_strict_map_ordering = true;
+
+        explicit BcsDeserializer(std::vector<uint8_t> bytes) : bytes_(std::move(bytes)) {}
+
+        size_t deserialize_len()
+        {
+            auto value = deserialize_uleb128_as_u32();
+            if (value > serde::BCS_MAX_LENGTH)
+                throw serde::deserialization_error("Length is too large");
+            return (size_t)value;
+        }
+        uint32_t deserialize_variant_index() { return deserialize_uleb128_as_u32(); }
+
+        std::string deserialize_str()
+        {
+            auto len = deserialize_len();
+            std::string result;
+            result.reserve(len);
+            for (size_t i = 0; i < len; i++)
+                result.push_back(read_byte());
+            if (!serde::is_valid_utf8(result))
+                throw serde::deserialization_error("Invalid UTF8 string: " + result);
+            return result;
+        }
+        std::monostate deserialize_unit() { return {}; }
+        bool deserialize_bool()
+        {
+            switch (read_byte())
+            {
+            case 0:
+                return false;
+            case 1:
+                return true;
+            default:
+                throw serde::deserialization_error("Invalid boolean value");
+            }
+        }
+        bool deserialize_option_tag() { return deserialize_bool(); }
+
+        uint8_t deserialize_u8() { return read_byte(); }
+        uint16_t deserialize_u16()
+        {
+            uint16_t val = 0;
+            for (int i = 0; i < 2; i++)
+                val |= (uint16_t)read_byte() << (8 * i);
+            return val;
+        }
+        uint32_t deserialize_u32()
+        {
+            uint32_t val = 0;
+            for (int i = 0; i < 4; i++)
+                val |= (uint32_t)read_byte() << (8 * i);
+            return val;
+        }
+        uint64_t deserialize_u64()
+        {
+            uint64_t val = 0;
+            for (int i = 0; i < 8; i++)
+                val |= (uint64_t)read_byte() << (8 * i);
+            return val;
+        }
+        serde::uint128_t deserialize_u128()
+        {
+            serde::uint128_t result;
+            result.low = deserialize_u64();
+            result.high = deserialize_u64();
+            return result;
+        }
+
+        size_t get_buffer_offset() { return pos_; }
+        void increase_container_depth()
+        {
+            if (container_depth_budget_ == 0)
+                throw serde::deserialization_error("Too many nested containers");
+            container_depth_budget_--;
+        }
+        void decrease_container_depth() { container_depth_budget_++; }
+
+        void check_that_key_slices_are_increasing(std::tuple<size_t, size_t> key1, std::tuple<size_t, size_t> key2)
+        {
+            if (!std::lexicographical_compare(bytes_.cbegin() + std::get<0>(key1), bytes_.cbegin() + std::get<1>(key1),
+                                              bytes_.cbegin() + std::get<0>(key2), bytes_.cbegin() + std::get<1>(key2)))
+                throw serde::deserialization_error("Error while decoding map: keys are not serialized in the expected order");
+        }
+    };
+
+    template <typename T>
+    std::vector<uint8_t> bcs_serialize(const T &value)
+    {
+        BcsSerializer serializer;
+        serde::Serializable<T>::serialize(value, serializer);
+        return std::move(serializer).bytes();
+    }
+
+    template <typename T>
+    T bcs_deserialize(std::vector<uint8_t> input)
+    {
+        BcsDeserializer deserializer(std::move(input));
+        return serde::Deserializable<T>::deserialize(deserializer);
+    }
+
+    class BcsSerde;
+
+    template <typename T>
+    concept has_serde = requires(T t)
+    {
+        { t.serde(std::declval<BcsSerde &>()) } -> std::same_as<BcsSerde &>;
+    };
+    //
+    //  The former BcsSerde which pushes and reads one byte at a time, only the parts used by NftInfo
+    //
+    class BcsSerde
+    {
+        std::vector<uint8_t> _bytes;
+        std::vector<uint8_t>::iterator _iterator = std::begin(_bytes);
+        bool _is_serialization = true;
+
+        void encode_integer(size_t value)
+        {
+            do
+            {
+                uint8_t v = value & 0b01111111;
+
+                value >>= 7;
+
+                if (value)
+                    v |= 0b10000000;
+
+                _bytes.push_back(v);
+            } while (value);
+        }
+
+        size_t decode_integer()
+        {
+            size_t value = 0;
+            uint8_t v = 0;
+
+            for (size_t i = 0; i < 4; i++)
+            {
+                v = *_iterator++;
+                value |= size_t(v & 0b01111111) << (7 * i);
+
+                if (!(v & 0b10000000))
+                    break;
+            }
+
+            return value;
+        }
+
+    public:
+        BcsSerde() { _is_serialization = true; }
+
+        BcsSerde(const std::vector<uint8_t> &bytes) : _is_serialization(false)
+        {
+            _bytes = bytes;
+            _iterator = std::begin(_bytes);
+        }
+
+        std::vector<uint8_t> bytes() { return _bytes; }
+
+        template <has_serde T>
+        BcsSerde &operator&&(T &t)
+        {
+            return t.serde(*this);
+        }
+
+        template <std::integral T>
+        BcsSerde &operator&&(T &t)
+        {
+            auto beg = (uint8_t *)&t;
+            auto end = beg + sizeof(T);
+
+            if (_is_serialization)
+                std::copy(beg, end, back_inserter(_bytes));
+            else
+                while (beg < end)
+                    *beg++ = *_iterator++;
+
+            return *this;
+        }
+
+        BcsSerde &operator&&(bool &t)
+        {
+            uint8_t v = t;
+
+            (*this) && v;
+
+            t = v;
+
+            return *this;
+        }
+
+        template <typename T,
+                  template <class TElem, typename Alloc = std::allocator<TElem>> class Container>
+        BcsSerde &operator&&(Container<T> &container)
+        {
+            if (_is_serialization)
+                encode_integer(container.size());
+            else
+                container.resize(decode_integer());
+
+            for (auto &v : container)
+                *this &&v;
+
+            return *this;
+        }
+
+        template <typename Key, typename Value>
+        BcsSerde &operator&&(std::pair<Key, Value> &p)
+        {
+            (*this) && p.first;
+            (*this) && p.second;
+
+            return *this;
+        }
+
+        template <typename Key, typename Value>
+        BcsSerde &operator&&(std::map<Key, Value> &container)
+        {
+            if (_is_serialization)
+            {
+                encode_integer(container.size());
+
+                for (auto v : container)
+                {
+                    Key k = v.first;
+
+                    (*this) && k;
+                    (*this) && v.second;
+                }
+            }
+            else
+            {
+                container.clear();
+
+                size_t size = decode_integer();
+                for (size_t i = 0; i < size; i++)
+                {
+                    std::pair<Key, Value> p;
+
+                    (*this) && p;
+
+                    container.insert(p);
+                }
+            }
+
+            return *this;
+        }
+
+        template <typename T, size_t N>
+        BcsSerde &operator&&(std::array<T, N> &arr)
+        {
+            for (auto &a : arr)
+                *this &&a;
+
+            return *this;
+        }
+    };
+}
+
+diem_types::SignedTransaction make_signed_txn()
+{
+    using namespace diem_types;
+    SignedTransaction txn;
+
+    txn.raw_txn.sender.value.fill(0x11);
+    txn.raw_txn.sequence_number = 42;
+    txn.raw_txn.payload.value = TransactionPayload::Script{
+        Script{vector<uint8_t>(512, 0xa1),
+               {TypeTag{TypeTag::Struct{StructTag{AccountAddress{}, Identifier{"VLS"}, Identifier{"VLS"}, {}}}}},
+               {TransactionArgument{TransactionArgument::Address{AccountAddress{}}},
+                TransactionArgument{TransactionArgument::U64{1'000'000}},
+                TransactionArgument{TransactionArgument::U8Vector{vector<uint8_t>(64, 0x5a)}}}}};
+    txn.raw_txn.max_gas_amount = 1'000'000;
+    txn.raw_txn.gas_unit_price = 0;
+    txn.raw_txn.gas_currency_code = "VLS";
+    txn.raw_txn.expiration_timestamp_secs = 1'700'000'000;
+    txn.raw_txn.chain_id = ChainId{4};
+    txn.authenticator.value = TransactionAuthenticator::Ed25519{
+        Ed25519PublicKey{vector<uint8_t>(32, 0x22)},
+        Ed25519Signature{vector<uint8_t>(64, 0x33)}};
+
+    return txn;
+}
+
+NftInfo make_nft_info()
+{
+    NftInfo info{true, 1000, 100, {}, {}, {7, vector<uint8_t>(40, 1)}, {8, vector<uint8_t>(40, 2)}, {9, vector<uint8_t>(40, 3)}};
+
+    for (uint8_t i = 0; i < 100; i++)
+        info.owners[vector<uint8_t>(32, i)].fill(i);
+
+    return info;
+}
+
+// run fn for count times and return operations per second
+double measure(size_t count, function<void()> fn)
+{
+    auto start = steady_clock::now();
+
+    for (size_t i = 0; i < count; i++)
+        fn();
+
+    return count / duration<double>(steady_clock::now() - start).count();
+}
+
+int main()
+{
+    size_t sink = 0;
+    auto txn = make_signed_txn();
+    auto txn_bytes = txn.bcsSerialize();
+    auto info = make_nft_info();
+    auto info_bytes = BcsSerde::serialize(info);
+
+    auto print = [](string_view name, double ops)
+    {
+        cout << left << setw(32) << name << fixed << setprecision(0) << ops << " ops/s" << endl;
+    };
+
+    auto legacy_info_bytes = [&]
+    {
+        legacy::BcsSerde bs;
+        bs &&info;
+        return bs.bytes();
+    };
+
+    if (legacy::bcs_serialize(txn) != txn_bytes ||
+        legacy::bcs_deserialize<diem_types::SignedTransaction>(txn_bytes).bcsSerialize() != txn_bytes ||
+        legacy_info_bytes() != info_bytes)
+    {
+        cerr << "the legacy kernels don't match the codec" << endl;
+        return 1;
+    }
+
+    print("legacy serialize",
+          measure(200'000, [&]
+                  { sink += legacy::bcs_serialize(txn).size(); }));
+
+    print("diem_types serialize",
+          measure(200'000, [&]
+                  { sink += txn.bcsSerialize().size(); }));
+
+    print("diem_types serialize, reused",
+          measure(200'000, [&]
+                  { sink += serde::BcsBuffer::local().serialize(txn).size(); }));
+
+    print("legacy deserialize",
+          measure(200'000, [&]
+                  { sink += legacy::bcs_deserialize<diem_types::SignedTransaction>(txn_bytes).raw_txn.sequence_number; }));
+
+    print("diem_types deserialize",
+          measure(200'000, [&]
+                  { sink += diem_types::SignedTransaction::bcsDeserialize(txn_bytes).raw_txn.sequence_number; }));
+
+    print("legacy BcsSerde serialize",
+          measure(50'000, [&]
+                  { sink += legacy_info_bytes().size(); }));
+
+    print("BcsSerde serialize",
+          measure(50'000, [&]
+                  { sink += BcsSerde::serialize(info).size(); }));
+
+    print("legacy BcsSerde deserialize",
+          measure(50'000, [&]
+                  {
+                      NftInfo t;
+                      legacy::BcsSerde bs{info_bytes};
+                      bs &&t;
+                      sink += t.owners.size(); }));
+
+    print("BcsSerde deserialize",
+          measure(50'000, [&]
+                  {
+                      NftInfo t;
+                      BcsSerde bs{span<const uint8_t>(info_bytes)};
+                      bs &&t;
+                      sink += t.owners.size(); }));
+
+    return sink ? 0 : 1;
+}
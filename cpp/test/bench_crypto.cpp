@@ -0,0 +1,167 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <cassert>
+#include <openssl/evp.h>
+#include <ed25519.hpp>
+#include <wallet.hpp>
+
+using namespace std;
+using namespace std::chrono;
+using namespace crypto;
+
+//
+//  The former implementations which create an EVP context or key per call
+//
+array<uint8_t, 32> legacy_sha3_256(const uint8_t *data, size_t len)
+{
+    array<uint8_t, 32> output;
+    uint32_t out_len = output.size();
+    EVP_MD_CTX *context = EVP_MD_CTX_new();
+
+    EVP_DigestInit_ex(context, EVP_sha3_256(), nullptr);
+    EVP_DigestUpdate(context, data, len);
+    EVP_DigestFinal_ex(context, output.data(), &out_len);
+
+    EVP_MD_CTX_destroy(context);
+
+    return output;
+}
+
+ed25519::Signature legacy_sign(EVP_PKEY *pkey, const uint8_t *data, size_t len)
+{
+    unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> md_ctx(EVP_MD_CTX_new(), &EVP_MD_CTX_free);
+    ed25519::Signature signature;
+    size_t sig_len = signature.size();
+
+    EVP_DigestSignInit(md_ctx.get(), NULL, NULL, NULL, pkey);
+    EVP_DigestSign(md_ctx.get(), signature.data(), &sig_len, data, len);
+
+    return signature;
+}
+
+bool legacy_verify(const ed25519::RawKey &raw_key, const ed25519::Signature &sig, const uint8_t *data, size_t len)
+{
+    // the public key was rebuilt by get_public_key for each verification
+    EVP_PKEY *pkey = EVP_PKEY_new_raw_public_key(EVP_PKEY_ED25519, NULL, raw_key.data(), raw_key.size());
+    unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> md_ctx(EVP_MD_CTX_new(), &EVP_MD_CTX_free);
+
+    EVP_DigestVerifyInit(md_ctx.get(), nullptr, NULL, NULL, pkey);
+    int ret = EVP_DigestVerify(md_ctx.get(), sig.data(), sig.size(), data, len);
+
+    EVP_PKEY_free(pkey);
+
+    return ret == 1;
+}
+
+// run fn for count times and return operations per second
+double measure(size_t count, function<void()> fn)
+{
+    auto start = steady_clock::now();
+
+    for (size_t i = 0; i < count; i++)
+        fn();
+
+    return count / duration<double>(steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+    auto raw_key = ed25519::PrivateKey::generate().get_raw_key();
+    auto priv_key = ed25519::PrivateKey::from_raw_key(raw_key);
+    auto pub_raw_key = priv_key.get_public_key().get_raw_key();
+    EVP_PKEY *pkey = EVP_PKEY_new_raw_private_key(EVP_PKEY_ED25519, NULL, raw_key.data(), raw_key.size());
+
+    // the size of a typical signing message of raw transaction
+    vector<uint8_t> message(256, 0x5a);
+    auto signature = priv_key.sign(message.data(), message.size());
+
+    assert(legacy_sign(pkey, message.data(), message.size()) == signature);
+    assert(priv_key.get_public_key().verify(signature, message.data(), message.size()));
+    assert(legacy_verify(pub_raw_key, signature, message.data(), message.size()));
+    assert(violas::sha3_256(message.data(), message.size()) == legacy_sha3_256(message.data(), message.size()));
+
+    size_t sink = 0;
+    violas::Sha3Hasher hasher;
+
+    cout << left << setw(20) << "operation" << setw(20) << "legacy(ops/s)" << setw(20) << "current(ops/s)" << endl;
+
+    auto print = [](string_view name, double legacy, double current)
+    {
+        cout << left << setw(20) << name << fixed << setprecision(0)
+             << setw(20) << legacy << setw(20) << current << endl;
+    };
+
+    print("sign",
+          measure(20'000, [&]
+                  { sink += legacy_sign(pkey, message.data(), message.size())[0]; }),
+          measure(20'000, [&]
+                  { sink += priv_key.sign(message.data(), message.size())[0]; }));
+
+    print("verify",
+          measure(10'000, [&]
+                  { sink += legacy_verify(pub_raw_key, signature, message.data(), message.size()); }),
+          measure(10'000, [&]
+                  { sink += priv_key.get_public_key().verify(signature, message.data(), message.size()); }));
+
+    print("sha3_256",
+          measure(1'000'000, [&]
+                  { sink += legacy_sha3_256(message.data(), message.size())[0]; }),
+          measure(1'000'000, [&]
+                  { sink += violas::sha3_256(message.data(), message.size())[0]; }));
+
+    print("sha3_256 streaming",
+          measure(1'000'000, [&]
+                  { sink += legacy_sha3_256(message.data(), message.size())[0]; }),
+          measure(1'000'000, [&]
+                  { sink += hasher.update(message).finalize()[0]; }));
+
+    //
+    //  batch verification against verifying with a public key built from raw key per call
+    //
+    const size_t BATCH_SIZE = 8192, NUM_OF_SENDERS = 64;
+    vector<ed25519::PrivateKey> senders;
+    vector<vector<uint8_t>> messages(BATCH_SIZE);
+    vector<ed25519::VerifyEntry> entries;
+
+    for (size_t i = 0; i < NUM_OF_SENDERS; i++)
+        senders.push_back(ed25519::PrivateKey::generate());
+
+    for (size_t i = 0; i < BATCH_SIZE; i++)
+    {
+        auto &sender = senders[i % NUM_OF_SENDERS];
+
+        messages[i].assign(256, uint8_t(i));
+        entries.push_back({sender.get_public_key().get_raw_key(),
+                           messages[i],
+                           sender.sign(messages[i].data(), messages[i].size())});
+    }
+
+    assert(ed25519::verify_batch(entries).empty());
+
+    entries[7].signature[0] ^= 1;
+    entries[BATCH_SIZE - 1].message = entries[0].message;
+    assert((ed25519::verify_batch(entries) == vector<size_t>{7, BATCH_SIZE - 1}));
+    assert((ed25519::verify_batch(entries, 1) == vector<size_t>{7, BATCH_SIZE - 1}));
+
+    auto per_call = measure(1, [&]
+                            {
+                                for (auto &e : entries)
+                                    sink += ed25519::PublicKey(e.public_key).verify(e.signature, e.message.data(), e.message.size());
+                            });
+
+    print("verify batch 1T", per_call * BATCH_SIZE, measure(1, [&]
+                                                            { sink += ed25519::verify_batch(entries, 1).size(); }) *
+                                                        BATCH_SIZE);
+    print("verify batch", per_call * BATCH_SIZE, measure(1, [&]
+                                                         { sink += ed25519::verify_batch(entries).size(); }) *
+                                                     BATCH_SIZE);
+
+    EVP_PKEY_free(pkey);
+
+    return sink ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <functional>
+#include <cassert>
+#include <utils.hpp>
+
+using namespace std;
+using namespace std::chrono;
+
+//
+//  The stringstream based implementations replaced by hex_encode and hex_decode
+//
+string legacy_bytes_to_hex(const vector<uint8_t> &bytes)
+{
+    ostringstream oss;
+
+    for (auto v : bytes)
+    {
+        oss << hex << setw(2) << setfill('0') << (int)v;
+    }
+
+    return oss.str();
+}
+
+vector<uint8_t> legacy_hex_to_bytes(const string &str)
+{
+    vector<uint8_t> bytes;
+
+    for (auto beg = begin(str); beg != end(str);)
+    {
+        stringstream ss;
+        uint16_t byte = 0;
+
+        ss << *beg++;
+        ss << *beg++; // read two chars
+        ss >> hex >> byte;
+
+        bytes.push_back(byte);
+    }
+
+    return bytes;
+}
+
+// run fn for count times and return MB/s of the input bytes
+double measure(size_t count, size_t size, function<void()> fn)
+{
+    auto start = steady_clock::now();
+
+    for (size_t i = 0; i < count; i++)
+        fn();
+
+    double seconds = duration<double>(steady_clock::now() - start).count();
+
+    return double(size) * count / seconds / 1'000'000;
+}
+
+int main(int argc, char *argv[])
+{
+    mt19937 rng(20220101);
+    // the sizes of address, key, signed transaction and account state blob
+    vector<size_t> sizes = {16, 32, 512, 4096, 65536};
+
+    cout << left << setw(10) << "size"
+         << setw(20) << "encode(legacy)" << setw(20) << "encode"
+         << setw(20) << "decode(legacy)" << setw(20) << "decode" << "(MB/s)" << endl;
+
+    for (auto size : sizes)
+    {
+        vector<uint8_t> bytes(size);
+        for (auto &b : bytes)
+            b = uint8_t(rng());
+
+        string hex_str = legacy_bytes_to_hex(bytes);
+        assert(bytes_to_hex(bytes) == hex_str);
+        assert(hex_to_bytes(hex_str) == bytes);
+
+        size_t count = max<size_t>(10, 20'000'000 / size / 10);
+        size_t sink = 0;
+
+        auto legacy_encode = measure(count / 10, size, [&]
+                                     { sink += legacy_bytes_to_hex(bytes).size(); });
+        auto encode = measure(count, size, [&]
+                              { sink += bytes_to_hex(bytes).size(); });
+        auto legacy_decode = measure(count / 10, size, [&]
+                                     { sink += legacy_hex_to_bytes(hex_str).size(); });
+        auto decode = measure(count, size, [&]
+                              { sink += hex_to_bytes(hex_str).size(); });
+
+        cout << left << setw(10) << size << fixed << setprecision(1)
+             << setw(20) << legacy_encode << setw(20) << encode
+             << setw(20) << legacy_decode << setw(20) << decode
+             << (sink ? "" : " ") << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+//
+//  The fuzz target of BcsSerde deserialization, build with clang -fsanitize=fuzzer
+//
+//  The checked mode must reject any malformed or non-canonical input with serde::deserialization_error, so an
+//  accepted input re-serializes to exactly the bytes consumed. The unchecked mode is only for trusted bytes,
+//  so it is fed with the bytes re-serialized from the checked result and must round trip them exactly.
+//
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <array>
+#include <list>
+#include <set>
+#include <map>
+#include <tuple>
+#include <optional>
+#include <variant>
+#include <stdexcept>
+#include <algorithm>
+#include <diem_types.hpp>
+#include <bcs_serde.hpp>
+
+using namespace std;
+
+struct Leaf
+{
+    bool flag;
+    uint16_t u16;
+    uint64_t u64;
+    array<uint8_t, 16> address;
+
+    BcsSerde &serde(BcsSerde &bs)
+    {
+        return bs && flag && u16 && u64 && address;
+    }
+};
+
+struct Node
+{
+    string name;
+    vector<uint8_t> bytes;
+    vector<uint32_t> numbers;
+    list<Leaf> leaves;
+    set<string> tags;
+    map<vector<uint8_t>, uint64_t> balances;
+    optional<Leaf> opt_leaf;
+    variant<uint8_t, string, Leaf> value;
+    tuple<uint32_t, vector<string>> record;
+    vector<vector<uint8_t>> nested;
+    diem_types::AccountAddress owner;
+    optional<diem_types::TypeTag> type_tag;
+
+    BcsSerde &serde(BcsSerde &bs)
+    {
+        return bs && name && bytes && numbers && leaves && tags && balances && opt_leaf && value && record && nested &&
+               owner && type_tag;
+    }
+};
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    Node node;
+    size_t consumed = 0;
+
+    try
+    {
+        // a small length budget to reach the checks quickly
+        BcsSerde checked(span<const uint8_t>(data, size), BcsMode::checked, {.max_length = 1 << 16, .max_depth = 16});
+
+        checked &&node;
+        consumed = size - checked.remaining();
+    }
+    catch (const serde::deserialization_error &)
+    {
+        return 0;
+    }
+
+    auto bytes = BcsSerde::serialize(node);
+
+    // the canonical encoding is unique, e.g. the keys of map and set are strictly increasing
+    if (bytes.size() != consumed || !equal(bytes.begin(), bytes.end(), data))
+        abort();
+
+    Node trusted;
+    BcsSerde unchecked(span<const uint8_t>(bytes), BcsMode::unchecked);
+
+    unchecked &&trusted;
+
+    if (unchecked.remaining() != 0 || BcsSerde::serialize(trusted) != bytes)
+        abort();
+
+    return 0;
+}
+
+#ifdef BCS_FUZZ_STANDALONE
+#include <fstream>
+#include <iterator>
+//
+//  Run the inputs of files without libFuzzer, e.g. to replay a corpus with another compiler
+//
+int main(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        ifstream ifs(argv[i], ios::binary);
+        vector<uint8_t> input((istreambuf_iterator<char>(ifs)), {});
+
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+    }
+
+    return 0;
+}
+#endif
@@ -0,0 +1,98 @@
+//
+//  Test CallbackAwaitable with the callbacks completed inline and on the threads of executor,
+//  the coroutine may finish and destroy the awaitable before the start function returns
+//
+#include <iostream>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <cassert>
+#include <co_helper.hpp>
+
+using namespace std;
+
+static const size_t ITERATIONS = 10'000;
+
+Task<size_t> await_inline(size_t i)
+{
+    // the captures of start are alive while it runs
+    auto payload = make_shared<string>(64, 'x');
+
+    // a named awaitable, gcc 12 releases the captures of a temporary one in co_await too early
+    CallbackAwaitable<size_t> awaitable(
+        [payload, i](function<void(size_t &&, exception_ptr)> callback)
+        {
+            callback(i + payload->size(), nullptr);
+
+            // touch the captures after the coroutine was resumed
+            assert(payload->size() == 64);
+        });
+
+    co_return co_await awaitable;
+}
+
+Task<size_t> await_on_pool(size_t i)
+{
+    auto payload = make_shared<string>(64, 'y');
+
+    CallbackAwaitable<size_t> awaitable(
+        [payload, i](function<void(size_t &&, exception_ptr)> callback)
+        {
+            Executor::default_executor().post([callback, i]
+                                              { callback(size_t(i), nullptr); });
+
+            // the coroutine may be running or finished on the pool thread now
+            assert(payload->size() == 64);
+        });
+
+    co_return co_await awaitable;
+}
+
+Task<void> await_void_on_pool(atomic<size_t> &count)
+{
+    co_await CallbackAwaitable<void>(
+        [&count](function<void(exception_ptr)> callback)
+        {
+            Executor::default_executor().post([callback, &count]
+                                              { count++; callback(nullptr); });
+        });
+}
+
+Task<void> await_error_on_pool()
+{
+    co_await CallbackAwaitable<void>(
+        [](function<void(exception_ptr)> callback)
+        {
+            Executor::default_executor().post([callback]
+                                              { callback(make_exception_ptr(runtime_error("failed"))); });
+        });
+}
+
+int main()
+{
+    for (size_t i = 0; i < ITERATIONS; i++)
+        assert(sync_wait(await_inline(i)) == i + 64);
+
+    for (size_t i = 0; i < ITERATIONS; i++)
+        assert(sync_wait(await_on_pool(i)) == i);
+
+    atomic<size_t> count{0};
+    for (size_t i = 0; i < ITERATIONS; i++)
+        sync_wait(await_void_on_pool(count));
+    assert(count == ITERATIONS);
+
+    bool thrown = false;
+    try
+    {
+        sync_wait(await_error_on_pool());
+    }
+    catch (const runtime_error &e)
+    {
+        thrown = string(e.what()) == "failed";
+    }
+    assert(thrown);
+
+    cout << "test_co_helper passed" << endl;
+
+    return 0;
+}
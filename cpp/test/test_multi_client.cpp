@@ -0,0 +1,189 @@
+//
+//  Test the multi-endpoint client of JSON-RPC against the in-process stubs of full nodes
+//
+//  Each stub replies get_account with a null account at its own ledger version, after a delay,
+//  or replies 503 which is a transport failure for the client
+//
+#include <iostream>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <cassert>
+#include <cpprest/http_listener.h>
+#include <json_rpc.hpp>
+
+using namespace std;
+using namespace std::chrono;
+using namespace web::http;
+using namespace web::http::experimental::listener;
+
+struct Stub
+{
+    string url;
+    http_listener listener;
+    atomic<uint64_t> version{1};
+    atomic<int> delay_ms{0};
+    atomic<bool> failing{false};
+    atomic<size_t> hits{0};
+
+    Stub(uint16_t port, uint64_t ledger_version)
+        : url("http://127.0.0.1:" + to_string(port)), listener(url), version(ledger_version)
+    {
+        listener.support(methods::POST, [this](http_request request)
+                         {
+                             hits++;
+
+                             if (delay_ms > 0)
+                                 this_thread::sleep_for(milliseconds(delay_ms));
+
+                             if (failing)
+                                 request.reply(status_codes::ServiceUnavailable, "unavailable");
+                             else
+                                 request.reply(status_codes::OK,
+                                               R"({"id":1,"jsonrpc":"2.0","diem_ledger_version":)" + to_string(version) + R"(,"result":null})",
+                                               "application/json"); });
+        listener.open().wait();
+    }
+
+    ~Stub()
+    {
+        listener.close().wait();
+    }
+};
+
+static const diem_types::AccountAddress ADDRESS{};
+
+static bool read(json_rpc::Client &client)
+{
+    try
+    {
+        client.get_account(ADDRESS);
+        return true;
+    }
+    catch (const exception &e)
+    {
+        cout << "\tread failed, " << e.what() << endl;
+        return false;
+    }
+}
+//
+//  A slow read is hedged to the other endpoint after hedge_delay
+//
+void test_hedging()
+{
+    Stub slow(18101, 10), fast(18102, 10);
+    slow.delay_ms = 1000;
+
+    json_rpc::MultiClientOptions options;
+    options.hedge_delay = milliseconds(100);
+    auto client = json_rpc::Client::create({slow.url, fast.url}, options);
+
+    for (int i = 0; i < 3; i++)
+    {
+        auto start = steady_clock::now();
+        assert(read(*client));
+        assert(steady_clock::now() - start < milliseconds(800));
+    }
+
+    assert(fast.hits >= 3);
+
+    cout << "test_hedging passed" << endl;
+}
+//
+//  A failing endpoint is ejected after max_failures and re-admitted after eject_duration
+//
+void test_ejection()
+{
+    Stub bad(18111, 10), good(18112, 10);
+    bad.failing = true;
+
+    json_rpc::MultiClientOptions options;
+    options.hedge_delay = milliseconds(0);
+    options.max_failures = 1;
+    options.eject_duration = seconds(1);
+    auto client = json_rpc::Client::create({bad.url, good.url}, options);
+
+    // the first read fails over from the bad endpoint, then it is ejected
+    for (int i = 0; i < 5; i++)
+        assert(read(*client));
+
+    assert(bad.hits == 1);
+    assert(good.hits == 5);
+
+    bad.failing = false;
+    this_thread::sleep_for(milliseconds(1200));
+
+    // re-admitted, the recovered endpoint serves reads again
+    for (int i = 0; i < 5; i++)
+        assert(read(*client));
+
+    assert(bad.hits > 1);
+
+    cout << "test_ejection passed" << endl;
+}
+//
+//  The reads from an endpoint behind the highest ledger version read are rejected
+//
+void test_ledger_version_floor()
+{
+    Stub ahead(18121, 100), behind(18122, 50);
+
+    json_rpc::MultiClientOptions options;
+    options.hedge_delay = milliseconds(0);
+    auto client = json_rpc::Client::create({ahead.url, behind.url}, options);
+
+    // the first read goes to the first endpoint, the floor is raised to 100
+    assert(read(*client));
+    assert(ahead.hits == 1);
+
+    // only the endpoint behind is left, the reads fail after the stale retries
+    ahead.failing = true;
+    assert(!read(*client));
+    assert(behind.hits > 0);
+
+    // it catches up
+    behind.version = 120;
+    assert(read(*client));
+
+    cout << "test_ledger_version_floor passed" << endl;
+}
+//
+//  A submit is not failed over after a transport failure
+//
+void test_submit_no_failover()
+{
+    Stub bad(18131, 10), good(18132, 10);
+    bad.failing = true;
+
+    json_rpc::MultiClientOptions options;
+    options.hedge_delay = milliseconds(100);
+    auto client = json_rpc::Client::create({bad.url, good.url}, options);
+
+    // the first call goes to the first endpoint
+    bool failed = false;
+    try
+    {
+        client->submit(diem_types::SignedTransaction{});
+    }
+    catch (const exception &e)
+    {
+        failed = true;
+    }
+
+    assert(failed);
+    assert(bad.hits == 1);
+    assert(good.hits == 0);
+
+    cout << "test_submit_no_failover passed" << endl;
+}
+
+int main()
+{
+    test_hedging();
+    test_ejection();
+    test_ledger_version_floor();
+    test_submit_no_failover();
+
+    return 0;
+}
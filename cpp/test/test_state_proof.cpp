@@ -0,0 +1,348 @@
+//
+//  Test StateProofVerifier with a synthetic ledger
+//
+//  The ledger has 8 transactions, the state tree at versions 6 and 7 holds the accounts A and B, and the account C
+//  doesn't exist, its key shares the first bit with A, so the leaf of A proves its non-inclusion
+//
+#include <iostream>
+#include <string>
+#include <vector>
+#include <optional>
+#include <functional>
+#include <cassert>
+#include <state_proof_verifier.hpp>
+#include <signing_message.hpp>
+
+using namespace std;
+using namespace violas;
+
+using Hash = StateProofVerifier::Hash;
+
+// CryptoHash of Diem, sha3_256(prefix of type name || a || b)
+static Hash diem_hash(string_view type_name, span<const uint8_t> a, span<const uint8_t> b = {})
+{
+    auto &prefix = SigningMessage::prefix(type_name);
+    vector<uint8_t> bytes(prefix.begin(), prefix.end());
+
+    bytes.insert(bytes.end(), a.begin(), a.end());
+    bytes.insert(bytes.end(), b.begin(), b.end());
+
+    return sha3_256(bytes.data(), bytes.size());
+}
+
+static bool bit(const Hash &key, size_t i) { return (key[i / 8] >> (7 - i % 8)) & 1; }
+
+static diem_types::AccountAddress address_of(uint8_t i)
+{
+    diem_types::AccountAddress address{};
+    address.value[15] = i;
+    return address;
+}
+
+// HashValue is serialized as bytes with length
+static void append_hash(vector<uint8_t> &bytes, const Hash &hash)
+{
+    bytes.push_back(32);
+    bytes.insert(bytes.end(), hash.begin(), hash.end());
+}
+
+struct Ledger
+{
+    static constexpr uint64_t VERSION = 7;
+
+    diem_types::AccountAddress a, b, c;
+    Hash key_a, key_b, value_a, value_b;
+    vector<uint8_t> blob_a, blob_b;
+    vector<vector<uint8_t>> txn_infos;
+    // the levels of accumulator from leaves to root
+    vector<vector<Hash>> levels;
+
+    Ledger()
+    {
+        auto key_of = [](uint8_t i)
+        { return diem_hash("AccountAddress", address_of(i).value); };
+
+        // choose B on the other side of A at the first bit, and C on the same side
+        optional<uint8_t> b_index, c_index;
+        key_a = key_of(1);
+
+        for (uint8_t i = 2; !(b_index && c_index); i++)
+        {
+            if (bit(key_of(i), 0) != bit(key_a, 0))
+                b_index = b_index.value_or(i);
+            else
+                c_index = c_index.value_or(i);
+        }
+
+        a = address_of(1);
+        b = address_of(*b_index);
+        c = address_of(*c_index);
+        key_b = key_of(*b_index);
+
+        vector<uint8_t> raw_a{1, 2, 3}, raw_b(1000, 7);
+        blob_a = BcsSerde::serialize(raw_a);
+        blob_b = BcsSerde::serialize(raw_b);
+        value_a = diem_hash("AccountStateBlob", raw_a);
+        value_b = diem_hash("AccountStateBlob", raw_b);
+
+        auto state_root = bit(key_a, 0) == 0 ? diem_hash("SparseMerkleInternal", leaf_a(), leaf_b())
+                                             : diem_hash("SparseMerkleInternal", leaf_b(), leaf_a());
+
+        // TransactionInfo of each version: transaction hash, state root hash, event root hash, gas_used, status
+        for (uint8_t version = 0; version <= VERSION; version++)
+        {
+            Hash transaction_hash{}, other_root{};
+            transaction_hash[0] = version;
+            other_root[0] = 0x80 | version;
+
+            vector<uint8_t> info;
+            append_hash(info, transaction_hash);
+            append_hash(info, version >= 6 ? state_root : other_root);
+            append_hash(info, Hash{});
+            info.insert(info.end(), {21, 0, 0, 0, 0, 0, 0, 0, 0});
+
+            txn_infos.push_back(info);
+        }
+
+        levels.emplace_back();
+        for (auto &info : txn_infos)
+            levels.back().push_back(diem_hash("TransactionInfo", info));
+
+        while (levels.back().size() > 1)
+        {
+            vector<Hash> parents;
+
+            for (size_t i = 0; i < levels.back().size(); i += 2)
+                parents.push_back(diem_hash("TransactionAccumulator", levels.back()[i], levels.back()[i + 1]));
+
+            levels.push_back(parents);
+        }
+    }
+
+    Hash leaf_a() const { return diem_hash("SparseMerkleLeafNode", key_a, value_a); }
+
+    Hash leaf_b() const { return diem_hash("SparseMerkleLeafNode", key_b, value_b); }
+
+    const Hash &root() const { return levels.back()[0]; }
+
+    vector<uint8_t> accumulator_proof(uint64_t index) const
+    {
+        vector<uint8_t> proof{uint8_t(levels.size() - 1)};
+
+        for (size_t level = 0; level + 1 < levels.size(); level++)
+            append_hash(proof, levels[level][(index >> level) ^ 1]);
+
+        return proof;
+    }
+
+    static vector<uint8_t> sparse_merkle_proof(optional<pair<Hash, Hash>> leaf, const Hash &sibling)
+    {
+        vector<uint8_t> proof;
+
+        proof.push_back(leaf ? 1 : 0);
+        if (leaf)
+        {
+            append_hash(proof, leaf->first);
+            append_hash(proof, leaf->second);
+        }
+
+        proof.push_back(1);
+        append_hash(proof, sibling);
+
+        return proof;
+    }
+    //
+    //  The state of A, B or C at version with proof
+    //
+    json_rpc::AccountStateWithProof state_of(const diem_types::AccountAddress &address, uint64_t version = 6) const
+    {
+        json_rpc::AccountStateWithProof asp;
+
+        asp.version = version;
+        asp.proof.transaction_info = txn_infos[version];
+        asp.proof.ledger_info_to_transaction_info_proof = accumulator_proof(version);
+
+        if (address == b)
+        {
+            asp.blob = blob_b;
+            asp.proof.transaction_info_to_account_proof = sparse_merkle_proof(pair{key_b, value_b}, leaf_a());
+        }
+        else
+        {
+            // C is proved not to exist by the leaf of A
+            if (address == a)
+                asp.blob = blob_a;
+
+            asp.proof.transaction_info_to_account_proof = sparse_merkle_proof(pair{key_a, value_a}, leaf_b());
+        }
+
+        return asp;
+    }
+};
+
+static bool rejected(function<void()> verify)
+{
+    try
+    {
+        verify();
+        return false;
+    }
+    catch (const runtime_error &)
+    {
+        return true;
+    }
+}
+
+void test_inclusion(const Ledger &ledger)
+{
+    StateProofVerifier verifier;
+
+    // not trusted yet
+    assert(rejected([&]
+                    { verifier.verify(ledger.a, 6, Ledger::VERSION, ledger.state_of(ledger.a)); }));
+
+    verifier.trust(Ledger::VERSION, ledger.root());
+    assert(verifier.latest_version() == Ledger::VERSION);
+
+    verifier.verify(ledger.a, 6, Ledger::VERSION, ledger.state_of(ledger.a));
+    verifier.verify(ledger.b, 6, Ledger::VERSION, ledger.state_of(ledger.b));
+
+    // the blob of another account
+    auto asp = ledger.state_of(ledger.a);
+    asp.blob = ledger.blob_b;
+    assert(rejected([&]
+                    { verifier.verify(ledger.a, 6, Ledger::VERSION, asp); }));
+
+    cout << "test_inclusion passed" << endl;
+}
+
+void test_non_inclusion(const Ledger &ledger)
+{
+    StateProofVerifier verifier;
+    verifier.trust(Ledger::VERSION, ledger.root());
+
+    verifier.verify(ledger.c, 6, Ledger::VERSION, ledger.state_of(ledger.c));
+
+    // an existing account can't be proved not to exist
+    auto asp = ledger.state_of(ledger.a);
+    asp.blob.clear();
+    assert(rejected([&]
+                    { verifier.verify(ledger.a, 6, Ledger::VERSION, asp); }));
+
+    // the leaf of A doesn't prove the non-inclusion of B on the other side
+    assert(rejected([&]
+                    { verifier.verify(ledger.b, 6, Ledger::VERSION, ledger.state_of(ledger.c)); }));
+
+    cout << "test_non_inclusion passed" << endl;
+}
+
+void test_wrong_version(const Ledger &ledger)
+{
+    StateProofVerifier verifier;
+    verifier.trust(Ledger::VERSION, ledger.root());
+
+    auto asp = ledger.state_of(ledger.a);
+
+    // a genuine proof of a state older than requested
+    assert(rejected([&]
+                    { verifier.verify(ledger.a, 7, Ledger::VERSION, asp); }));
+
+    // a version after the ledger
+    assert(rejected([&]
+                    { verifier.verify(ledger.a, 8, Ledger::VERSION, asp); }));
+
+    // the version of state doesn't match the proof
+    asp.version = 5;
+    assert(rejected([&]
+                    { verifier.verify(ledger.a, 5, Ledger::VERSION, asp); }));
+
+    // a ledger version not trusted
+    assert(rejected([&]
+                    { verifier.verify(ledger.a, 6, 6, ledger.state_of(ledger.a)); }));
+
+    cout << "test_wrong_version passed" << endl;
+}
+
+void test_tampered_sibling(const Ledger &ledger)
+{
+    StateProofVerifier verifier;
+    verifier.trust(Ledger::VERSION, ledger.root());
+
+    // the last byte of the sibling in the sparse Merkle proof
+    auto asp = ledger.state_of(ledger.a);
+    asp.proof.transaction_info_to_account_proof.back() ^= 1;
+    assert(rejected([&]
+                    { verifier.verify(ledger.a, 6, Ledger::VERSION, asp); }));
+
+    // the first byte of the bottom sibling in the accumulator proof
+    asp = ledger.state_of(ledger.a);
+    asp.proof.ledger_info_to_transaction_info_proof[2] ^= 1;
+    assert(rejected([&]
+                    { verifier.verify(ledger.a, 6, Ledger::VERSION, asp); }));
+
+    // the state root hash in TransactionInfo
+    asp = ledger.state_of(ledger.a);
+    asp.proof.transaction_info[40] ^= 1;
+    assert(rejected([&]
+                    { verifier.verify(ledger.a, 6, Ledger::VERSION, asp); }));
+
+    // trailing bytes after the proof
+    asp = ledger.state_of(ledger.a);
+    asp.proof.transaction_info_to_account_proof.push_back(0);
+    assert(rejected([&]
+                    { verifier.verify(ledger.a, 6, Ledger::VERSION, asp); }));
+
+    cout << "test_tampered_sibling passed" << endl;
+}
+//
+//  The accumulator proof of version 7 stops at the parent of versions 6 and 7 once version 6 was verified,
+//  so its upper siblings are not read, and the verified leaves are checked against the cached nodes
+//
+void test_cached_node(const Ledger &ledger)
+{
+    auto asp = ledger.state_of(ledger.b, 7);
+    auto &proof = asp.proof.ledger_info_to_transaction_info_proof;
+
+    // the top sibling, the proof is 1 byte of count followed by 33 bytes for each sibling
+    proof[proof.size() - 1] ^= 1;
+
+    StateProofVerifier fresh;
+    fresh.trust(Ledger::VERSION, ledger.root());
+    assert(rejected([&]
+                    { fresh.verify(ledger.b, 7, Ledger::VERSION, asp); }));
+
+    StateProofVerifier cached;
+    cached.trust(Ledger::VERSION, ledger.root());
+    cached.verify(ledger.a, 6, Ledger::VERSION, ledger.state_of(ledger.a));
+    cached.verify(ledger.b, 7, Ledger::VERSION, asp);
+
+    // a leaf which doesn't match the cached node is still rejected
+    auto c = ledger.state_of(ledger.c);
+    c.proof.transaction_info.back() ^= 1;
+    assert(rejected([&]
+                    { cached.verify(ledger.c, 6, Ledger::VERSION, c); }));
+
+    // the cached states are dropped with the oldest ledger
+    StateProofVerifier small(2);
+    small.trust(Ledger::VERSION, ledger.root());
+    small.verify(ledger.a, 6, Ledger::VERSION, ledger.state_of(ledger.a));
+    small.trust(Ledger::VERSION + 1, Hash{});
+    small.trust(Ledger::VERSION + 2, Hash{});
+    assert(rejected([&]
+                    { small.verify(ledger.a, 6, Ledger::VERSION, ledger.state_of(ledger.a)); }));
+
+    cout << "test_cached_node passed" << endl;
+}
+
+int main()
+{
+    Ledger ledger;
+
+    test_inclusion(ledger);
+    test_non_inclusion(ledger);
+    test_wrong_version(ledger);
+    test_tampered_sibling(ledger);
+    test_cached_node(ledger);
+
+    return 0;
+}